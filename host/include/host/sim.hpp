@@ -0,0 +1,322 @@
+/**
+ * @file host/include/host/sim.hpp
+ * @brief Control of the host PROS shim
+ *
+ * The shim implements the parts of the PROS API used by this project on Linux, so project code can be compiled and
+ * run off the robot. Time is virtual: it only moves forward when every task is waiting, and then jumps straight to
+ * the next wake up, so control code runs as fast as the host can execute it.
+ *
+ * Tasks are scheduled like FreeRTOS schedules them on the brain: by priority, with delays, delay_until, mutexes and
+ * notifications all blocking and waking tasks the same way. Everything runs on one host thread, so a run with the
+ * same inputs always interleaves tasks the same way.
+ *
+ * Devices are plain structs that the code driving the shim reads and writes. Motors have a simple first order model
+ * that turns commands into velocity and position as time advances. Every other sensor holds whatever value it was
+ * given.
+ *
+ * LVGL objects draw into a display in memory. Like LVGL's display driver on the brain, it only redraws the areas
+ * that changed, and only when refreshDisplay() is called.
+ *
+ * <h3> Example Usage </h3>
+ * @code
+ * host::reset();
+ * pros::Motor motor(1);
+ * motor.move(127);
+ * host::runFor(500);
+ * printf("%f\n", motor.get_position());
+ * @endcode
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <functional>
+
+namespace host {
+/**
+ * @brief State of a V5 smart motor
+ *
+ * Positions and velocities are on the motor's output shaft, after its cartridge, and are not affected by reversal or
+ * encoder units. The shim applies both when reading and writing through pros::Motor.
+ */
+struct MotorState {
+        /** how the motor is being controlled */
+        enum class Mode { VOLTAGE, VELOCITY, POSITION };
+
+        /** whether the motor is reversed, set by the first pros::Motor on the port */
+        bool reversed = false;
+        /** cartridge, a pros::motor_gearset_e_t */
+        int gearset = 1;
+        /** encoder units, a pros::motor_encoder_units_e_t */
+        int encoderUnits = 0;
+        /** brake mode, a pros::motor_brake_mode_e_t */
+        int brakeMode = 0;
+        /** how the motor is being controlled */
+        Mode mode = Mode::VOLTAGE;
+        /** commanded voltage, in millivolts */
+        int32_t voltage = 0;
+        /** commanded velocity, in rpm. The velocity limit in position control */
+        int32_t targetVelocity = 0;
+        /** commanded position, in degrees */
+        double targetPosition = 0;
+        /** actual velocity, in rpm */
+        double velocity = 0;
+        /** actual position, in degrees */
+        double position = 0;
+        /** position reported as 0, in degrees */
+        double zero = 0;
+        /** current draw, in milliamps */
+        int32_t current = 0;
+        /** number of commands written to the motor */
+        uint32_t commands = 0;
+};
+
+/**
+ * @brief State of a V5 inertial sensor
+ *
+ */
+struct ImuState {
+        /** rotation since calibration, in degrees. Unbounded */
+        double rotation = 0;
+        /** offset added to rotation by set_rotation and tare_rotation, in degrees */
+        double rotationOffset = 0;
+        /** offset added to rotation by set_heading and tare_heading, in degrees */
+        double headingOffset = 0;
+        /** gyro drift, in degrees per second. Applied to rotation as time advances */
+        double drift = 0;
+        /** virtual time at which calibration finishes, in milliseconds. 0 if not calibrating */
+        uint32_t calibrationEnd = 0;
+};
+
+/**
+ * @brief State of a V5 rotation sensor
+ *
+ */
+struct RotationState {
+        /** position, in centidegrees */
+        double position = 0;
+        /** velocity, in centidegrees per second. Applied to position as time advances */
+        double velocity = 0;
+        /** whether the sensor is reversed */
+        bool reversed = false;
+};
+
+/**
+ * @brief State of a V5 vision sensor
+ *
+ */
+struct VisionState {
+        /** @brief maximum number of objects the sensor can see at once */
+        static constexpr int MAX_OBJECTS = 16;
+
+        /** box around an object in the image, in pixels from the top left */
+        struct Object {
+                uint16_t signature;
+                int16_t left;
+                int16_t top;
+                int16_t width;
+                int16_t height;
+        };
+
+        /** number of objects the sensor sees */
+        int count = 0;
+        /** objects, in any order. Reads return them largest first like the sensor does */
+        Object objects[MAX_OBJECTS] = {};
+};
+
+/**
+ * @brief State of a V5 optical sensor
+ *
+ */
+struct OpticalState {
+        /** proximity, from 0 to 255 */
+        int32_t proximity = 0;
+        /** hue, in degrees from 0 to 360 */
+        double hue = 0;
+        /** saturation, from 0 to 1 */
+        double saturation = 0;
+        /** brightness, from 0 to 1 */
+        double brightness = 0;
+        /** integration time, in milliseconds */
+        double integrationTime = 100;
+        /** brightness of the LED, from 0 to 100 */
+        int32_t ledPwm = 0;
+};
+
+/**
+ * @brief State of a V5 controller
+ *
+ */
+struct ControllerState {
+        /** whether the controller is connected */
+        bool connected = true;
+        /** joystick values from -127 to 127, indexed by pros::controller_analog_e_t */
+        int32_t analog[4] = {};
+        /** button states, indexed by pros::controller_digital_e_t */
+        bool digital[18] = {};
+        /** button states as of the last get_digital_new_press call for each button */
+        bool lastDigital[18] = {};
+        /** text on each line of the screen */
+        char text[3][20] = {};
+};
+
+/**
+ * @brief State of a three wire port
+ *
+ */
+struct AdiState {
+        /** configuration, a pros::adi_port_config_e_t */
+        int config = 0;
+        /** value written or read */
+        int32_t value = 0;
+        /** number of values written to the port */
+        uint32_t writes = 0;
+};
+
+/**
+ * @brief The brain screen, as drawn by LVGL
+ *
+ */
+struct DisplayState {
+        /** @brief width of the screen, in pixels */
+        static constexpr int WIDTH = 480;
+        /** @brief height of the screen, in pixels */
+        static constexpr int HEIGHT = 240;
+
+        /** pixels, in LVGL's 32 bit colors. Index by [y][x] */
+        uint32_t pixels[HEIGHT][WIDTH];
+        /** number of refreshes so far that redrew anything */
+        uint32_t refreshes;
+        /** number of areas redrawn by the last refresh */
+        uint32_t areas;
+        /** number of pixels redrawn by the last refresh */
+        uint32_t drawnPixels;
+};
+
+/**
+ * @brief Reset the shim
+ *
+ * Deletes every task, sets the clock back to 0 and resets every device to its default state
+ */
+void reset();
+/**
+ * @brief Advance virtual time, running tasks as they wake up
+ *
+ * @param milliseconds how long to run for
+ */
+void runFor(uint32_t milliseconds);
+/**
+ * @brief Advance virtual time until a condition is true
+ *
+ * The condition is checked whenever a task yields
+ *
+ * @param condition the condition
+ * @param timeout the longest time to run for, in milliseconds
+ * @return true the condition became true
+ * @return false the timeout expired first
+ */
+bool runUntil(const std::function<bool()>& condition, uint32_t timeout);
+/**
+ * @brief Get the virtual time
+ *
+ * @return uint64_t - time since the last reset, in microseconds
+ */
+uint64_t now();
+
+/**
+ * @brief Get the state of the motor on a port
+ *
+ * @param port smart port, from 1 to 21
+ * @return MotorState&
+ */
+MotorState& motor(uint8_t port);
+/**
+ * @brief Get the state of the inertial sensor on a port
+ *
+ * @param port smart port, from 1 to 21
+ * @return ImuState&
+ */
+ImuState& imu(uint8_t port);
+/**
+ * @brief Get the state of the rotation sensor on a port
+ *
+ * @param port smart port, from 1 to 21
+ * @return RotationState&
+ */
+RotationState& rotation(uint8_t port);
+/**
+ * @brief Get the state of the vision sensor on a port
+ *
+ * @param port smart port, from 1 to 21
+ * @return VisionState&
+ */
+VisionState& vision(uint8_t port);
+/**
+ * @brief Get the state of the optical sensor on a port
+ *
+ * @param port smart port, from 1 to 21
+ * @return OpticalState&
+ */
+OpticalState& optical(uint8_t port);
+/**
+ * @brief Get the state of a controller
+ *
+ * @param id a pros::controller_id_e_t
+ * @return ControllerState&
+ */
+ControllerState& controller(int id);
+/**
+ * @brief Get the state of a three wire port on the brain
+ *
+ * @param port port, from 'A' to 'H' or 1 to 8
+ * @return AdiState&
+ */
+AdiState& adi(uint8_t port);
+/**
+ * @brief Get the screen
+ *
+ * @return DisplayState&
+ */
+DisplayState& display();
+/**
+ * @brief Redraw every area of the screen invalidated since the last refresh
+ *
+ * What lv_task_handler does on the brain. Overlapping areas are joined the way LVGL joins them
+ */
+void refreshDisplay();
+/**
+ * @brief Get the competition status
+ *
+ * @return uint8_t& - a combination of the COMPETITION_* flags in pros/misc.h. 0 is driver control
+ */
+uint8_t& competitionStatus();
+/**
+ * @brief Get the phase of the device updates
+ *
+ * Devices send new values to the brain every 10ms. Motors report the time of their last update from get_raw_position,
+ * which is the latest time at or before now that is this many milliseconds past a multiple of 10
+ *
+ * @return uint32_t& - phase, in milliseconds from 0 to 9. 0 after a reset
+ */
+uint32_t& deviceUpdatePhase();
+/**
+ * @brief Advance the device models
+ *
+ * Called by the scheduler whenever virtual time advances. Exposed so models can be stepped without tasks
+ *
+ * @param microseconds time since the last step
+ */
+void stepDevices(uint64_t microseconds);
+/**
+ * @brief Delete every task and set the clock back to 0
+ *
+ * Called by reset
+ */
+void resetScheduler();
+/**
+ * @brief Delete every LVGL object and clear the screen
+ *
+ * Called by reset
+ */
+void resetDisplay();
+} // namespace host
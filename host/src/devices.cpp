@@ -0,0 +1,122 @@
+/**
+ * @file host/src/devices.cpp
+ * @brief Device state and models of the host PROS shim
+ */
+
+#include <algorithm>
+#include <cmath>
+#include "pros/motors.h"
+#include "host/sim.hpp"
+
+namespace host {
+static constexpr int PORTS = 21;
+static constexpr int ADI_PORTS = 8;
+// time constants of the motor model, in seconds. A coasting motor only slows down from friction
+static constexpr double DRIVEN_TIME_CONSTANT = 0.05;
+static constexpr double COAST_TIME_CONSTANT = 0.3;
+// gain of the motor's position controller, in rpm per degree of error
+static constexpr double POSITION_GAIN = 2;
+static constexpr int32_t MAX_CURRENT = 2500;
+// the models are stepped in 1ms increments no matter how far time jumps
+static constexpr uint64_t STEP = 1000;
+
+static MotorState motors[PORTS];
+static ImuState imus[PORTS];
+static RotationState rotations[PORTS];
+static VisionState visions[PORTS];
+static OpticalState opticals[PORTS];
+static ControllerState controllers[2];
+static AdiState adis[ADI_PORTS];
+static uint8_t competition = 0;
+static uint32_t updatePhase = 0;
+
+void reset() {
+    resetScheduler();
+    resetDisplay();
+    std::fill(std::begin(motors), std::end(motors), MotorState());
+    std::fill(std::begin(imus), std::end(imus), ImuState());
+    std::fill(std::begin(rotations), std::end(rotations), RotationState());
+    std::fill(std::begin(visions), std::end(visions), VisionState());
+    std::fill(std::begin(opticals), std::end(opticals), OpticalState());
+    std::fill(std::begin(controllers), std::end(controllers), ControllerState());
+    std::fill(std::begin(adis), std::end(adis), AdiState());
+    competition = 0;
+    updatePhase = 0;
+}
+
+MotorState& motor(uint8_t port) { return motors[(port - 1) % PORTS]; }
+
+ImuState& imu(uint8_t port) { return imus[(port - 1) % PORTS]; }
+
+RotationState& rotation(uint8_t port) { return rotations[(port - 1) % PORTS]; }
+
+VisionState& vision(uint8_t port) { return visions[(port - 1) % PORTS]; }
+
+OpticalState& optical(uint8_t port) { return opticals[(port - 1) % PORTS]; }
+
+ControllerState& controller(int id) { return controllers[id % 2]; }
+
+AdiState& adi(uint8_t port) {
+    if (port >= 'a' && port <= 'h') port -= 'a' - 1;
+    if (port >= 'A' && port <= 'H') port -= 'A' - 1;
+    return adis[(port - 1) % ADI_PORTS];
+}
+
+uint8_t& competitionStatus() { return competition; }
+
+uint32_t& deviceUpdatePhase() { return updatePhase; }
+
+/**
+ * @brief Get the free speed of a motor cartridge
+ *
+ * @param gearset a pros::motor_gearset_e_t
+ * @return double - free speed, in rpm
+ */
+static double freeSpeed(int gearset) {
+    switch (gearset) {
+        case pros::E_MOTOR_GEARSET_36: return 100;
+        case pros::E_MOTOR_GEARSET_06: return 600;
+        default: return 200;
+    }
+}
+
+/**
+ * @brief Step the model of a motor
+ *
+ * @param motor the motor
+ * @param dt time step, in seconds
+ */
+static void stepMotor(MotorState& motor, double dt) {
+    const double maxSpeed = freeSpeed(motor.gearset);
+    double target = 0;
+    double timeConstant = DRIVEN_TIME_CONSTANT;
+    switch (motor.mode) {
+        case MotorState::Mode::VOLTAGE:
+            target = maxSpeed * motor.voltage / 12000.0;
+            if (motor.voltage == 0 && motor.brakeMode == pros::E_MOTOR_BRAKE_COAST) timeConstant = COAST_TIME_CONSTANT;
+            break;
+        case MotorState::Mode::VELOCITY: target = motor.targetVelocity; break;
+        case MotorState::Mode::POSITION: {
+            const double limit = std::abs(motor.targetVelocity);
+            target = std::clamp(POSITION_GAIN * (motor.targetPosition - motor.position), -limit, limit);
+            break;
+        }
+    }
+    target = std::clamp(target, -maxSpeed, maxSpeed);
+    const double error = target - motor.velocity;
+    motor.velocity += error * std::min(1.0, dt / timeConstant);
+    motor.position += motor.velocity * 6 * dt;
+    motor.current = static_cast<int32_t>(std::min(1.0, std::abs(error) / maxSpeed) * MAX_CURRENT);
+}
+
+void stepDevices(uint64_t microseconds) {
+    while (microseconds > 0) {
+        const uint64_t step = std::min(microseconds, STEP);
+        const double dt = step / 1e6;
+        for (MotorState& motor : motors) stepMotor(motor, dt);
+        for (ImuState& imu : imus) imu.rotation += imu.drift * dt;
+        for (RotationState& rotation : rotations) rotation.position += rotation.velocity * dt;
+        microseconds -= step;
+    }
+}
+} // namespace host
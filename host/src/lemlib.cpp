@@ -0,0 +1,545 @@
+/**
+ * @file host/src/lemlib.cpp
+ * @brief Host builds of the LemLib classes that don't touch hardware
+ *
+ * LemLib only ships in this project as a prebuilt ARM library, so the parts of it that project code uses for math,
+ * odometry and logging are rebuilt here, along with the chassis calibration that starts odometry. The chassis motions
+ * are not. Log messages go straight to stdout instead of through LemLib's buffered stdout task, so they appear in order
+ * with the output of the code driving the shim.
+ *
+ * project.pros pins LemLib 0.5.0-rc2, and this builds against its headers in include/lemlib. The bodies follow LemLib's
+ * 0.5.0 sources, including the odometry speeds and estimatePose that 0.4.x doesn't have, but the prebuilt library's
+ * exact sources aren't in the project, so they were not compared line by line with the 0.5.0-rc2 tag. Where the brain's
+ * odometry gives a different pose for the same sensor readings, tools/replay.cpp shows it against a recording.
+ */
+
+#include <cmath>
+#include <cstdio>
+#include "lemlib/chassis/chassis.hpp"
+#include "lemlib/chassis/odom.hpp"
+#include "lemlib/chassis/trackingWheel.hpp"
+#include "lemlib/logger/logger.hpp"
+#include "lemlib/pid.hpp"
+#include "lemlib/pose.hpp"
+#include "lemlib/timer.hpp"
+#include "lemlib/util.hpp"
+
+namespace lemlib {
+Pose::Pose(float x, float y, float theta) {
+    this->x = x;
+    this->y = y;
+    this->theta = theta;
+}
+
+Pose Pose::operator+(const Pose& other) { return Pose(x + other.x, y + other.y, theta); }
+
+Pose Pose::operator-(const Pose& other) { return Pose(x - other.x, y - other.y, theta); }
+
+float Pose::operator*(const Pose& other) { return x * other.x + y * other.y; }
+
+Pose Pose::operator*(const float& other) { return Pose(x * other, y * other, theta); }
+
+Pose Pose::operator/(const float& other) { return Pose(x / other, y / other, theta); }
+
+Pose Pose::lerp(Pose other, float t) { return Pose(x + (other.x - x) * t, y + (other.y - y) * t, theta); }
+
+float Pose::distance(Pose other) { return std::hypot(x - other.x, y - other.y); }
+
+float Pose::angle(Pose other) { return std::atan2(other.y - y, other.x - x); }
+
+Pose Pose::rotate(float angle) {
+    return Pose(x * std::cos(angle) - y * std::sin(angle), x * std::sin(angle) + y * std::cos(angle), theta);
+}
+
+std::string format_as(const Pose& pose) {
+    return fmt::format("lemlib::Pose {{ x: {}, y: {}, theta: {} }}", pose.x, pose.y, pose.theta);
+}
+
+float slew(float target, float current, float maxChange) {
+    float change = target - current;
+    if (maxChange == 0) return target;
+    if (change > maxChange) change = maxChange;
+    else if (change < -maxChange) change = -maxChange;
+    return current + change;
+}
+
+float angleError(float angle1, float angle2, bool radians) {
+    const float max = radians ? 2 * M_PI : 360;
+    const float half = radians ? M_PI : 180;
+    angle1 = std::fmod(angle1, max);
+    angle2 = std::fmod(angle2, max);
+    float error = angle1 - angle2;
+    if (error > half) error -= max;
+    else if (error < -half) error += max;
+    return error;
+}
+
+float avg(std::vector<float> values) {
+    float sum = 0;
+    for (float value : values) sum += value;
+    return sum / values.size();
+}
+
+float ema(float current, float previous, float smooth) { return (current * smooth) + (previous * (1 - smooth)); }
+
+float getCurvature(Pose pose, Pose other) {
+    // whether the pose is on the left or right side of the circle
+    const float side = sgn(std::sin(pose.theta) * (other.x - pose.x) - std::cos(pose.theta) * (other.y - pose.y));
+    // center point and radius
+    const float a = -std::tan(pose.theta);
+    const float c = std::tan(pose.theta) * pose.x - pose.y;
+    const float x = std::fabs(a * other.x + other.y + c) / std::sqrt((a * a) + 1);
+    const float d = std::hypot(other.x - pose.x, other.y - pose.y);
+    return side * ((2 * x) / (d * d));
+}
+
+Timer::Timer(uint32_t time) : period(time) { lastTime = pros::millis(); }
+
+uint32_t Timer::getTimeSet() { return period; }
+
+uint32_t Timer::getTimeLeft() {
+    const uint32_t passed = getTimePassed();
+    return passed < period ? period - passed : 0;
+}
+
+uint32_t Timer::getTimePassed() {
+    const uint32_t time = pros::millis();
+    if (!paused) timeWaited += time - lastTime;
+    lastTime = time;
+    return timeWaited;
+}
+
+bool Timer::isDone() { return getTimeLeft() == 0; }
+
+void Timer::set(uint32_t time) {
+    period = time;
+    reset();
+}
+
+void Timer::reset() {
+    timeWaited = 0;
+    lastTime = pros::millis();
+}
+
+void Timer::pause() {
+    if (!paused) getTimePassed();
+    paused = true;
+}
+
+void Timer::resume() {
+    if (paused) lastTime = pros::millis();
+    paused = false;
+}
+
+void Timer::waitUntilDone() {
+    while (!isDone()) pros::delay(5);
+}
+
+OdomSensors::OdomSensors(TrackingWheel* vertical1, TrackingWheel* vertical2, TrackingWheel* horizontal1,
+                         TrackingWheel* horizontal2, pros::Imu* imu)
+    : vertical1(vertical1),
+      vertical2(vertical2),
+      horizontal1(horizontal1),
+      horizontal2(horizontal2),
+      imu(imu) {}
+
+Drivetrain::Drivetrain(pros::MotorGroup* leftMotors, pros::MotorGroup* rightMotors, float trackWidth,
+                       float wheelDiameter, float rpm, float chasePower)
+    : leftMotors(leftMotors),
+      rightMotors(rightMotors),
+      trackWidth(trackWidth),
+      wheelDiameter(wheelDiameter),
+      rpm(rpm),
+      chasePower(chasePower) {}
+
+ControllerSettings::ControllerSettings(float kP, float kD, float smallError, float smallErrorTimeout, float largeError,
+                                       float largeErrorTimeout, float slew)
+    : kP(kP),
+      kD(kD),
+      smallError(smallError),
+      smallErrorTimeout(smallErrorTimeout),
+      largeError(largeError),
+      largeErrorTimeout(largeErrorTimeout),
+      slew(slew) {}
+
+TrackingWheel::TrackingWheel(pros::ADIEncoder* encoder, float wheelDiameter, float distance, float gearRatio) {
+    this->encoder = encoder;
+    this->diameter = wheelDiameter;
+    this->distance = distance;
+    this->gearRatio = gearRatio;
+}
+
+TrackingWheel::TrackingWheel(pros::Rotation* encoder, float wheelDiameter, float distance, float gearRatio) {
+    this->rotation = encoder;
+    this->diameter = wheelDiameter;
+    this->distance = distance;
+    this->gearRatio = gearRatio;
+}
+
+TrackingWheel::TrackingWheel(pros::Motor_Group* motors, float wheelDiameter, float distance, float rpm) {
+    this->motors = motors;
+    this->motors->set_encoder_units(pros::E_MOTOR_ENCODER_ROTATIONS);
+    this->diameter = wheelDiameter;
+    this->distance = distance;
+    this->rpm = rpm;
+}
+
+void TrackingWheel::reset() {
+    if (encoder != nullptr) encoder->reset();
+    if (rotation != nullptr) rotation->reset_position();
+    if (motors != nullptr) motors->tare_position();
+}
+
+float TrackingWheel::getDistanceTraveled() {
+    if (encoder != nullptr) {
+        return float(encoder->get_value()) * diameter * M_PI / 360 / gearRatio;
+    } else if (rotation != nullptr) {
+        return float(rotation->get_position()) * diameter * M_PI / 36000 / gearRatio;
+    } else if (motors != nullptr) {
+        // get distance traveled by each motor
+        std::vector<pros::motor_gearset_e_t> gearsets = motors->get_gearing();
+        std::vector<double> positions = motors->get_positions();
+        std::vector<float> distances;
+        for (int i = 0; i < motors->size(); i++) {
+            float in;
+            switch (gearsets[i]) {
+                case pros::E_MOTOR_GEARSET_36: in = 100; break;
+                case pros::E_MOTOR_GEARSET_18: in = 200; break;
+                case pros::E_MOTOR_GEARSET_06: in = 600; break;
+                default: in = 200; break;
+            }
+            distances.push_back(positions[i] * (diameter * M_PI) * (rpm / in));
+        }
+        return avg(distances);
+    } else {
+        return 0;
+    }
+}
+
+float TrackingWheel::getOffset() { return distance; }
+
+int TrackingWheel::getType() { return motors != nullptr ? 1 : 0; }
+
+// odometry state, as in LemLib's odom.cpp
+static OdomSensors odomSensors(nullptr, nullptr, nullptr, nullptr, nullptr);
+static Drivetrain drive(nullptr, nullptr, 0, 0, 0, 0);
+static Pose odomPose(0, 0, 0);
+static Pose odomSpeed(0, 0, 0);
+static Pose odomLocalSpeed(0, 0, 0);
+static pros::Task* trackingTask = nullptr;
+static float prevVertical = 0;
+static float prevVertical1 = 0;
+static float prevVertical2 = 0;
+static float prevHorizontal = 0;
+static float prevHorizontal1 = 0;
+static float prevHorizontal2 = 0;
+static float prevImu = 0;
+
+void setSensors(OdomSensors sensors, Drivetrain drivetrain) {
+    odomSensors = sensors;
+    drive = drivetrain;
+}
+
+Pose getPose(bool radians) {
+    if (radians) return odomPose;
+    return Pose(odomPose.x, odomPose.y, radToDeg(odomPose.theta));
+}
+
+void setPose(Pose pose, bool radians) {
+    if (radians) odomPose = pose;
+    else odomPose = Pose(pose.x, pose.y, degToRad(pose.theta));
+}
+
+Pose getSpeed(bool radians) {
+    if (radians) return odomSpeed;
+    return Pose(odomSpeed.x, odomSpeed.y, radToDeg(odomSpeed.theta));
+}
+
+Pose getLocalSpeed(bool radians) {
+    if (radians) return odomLocalSpeed;
+    return Pose(odomLocalSpeed.x, odomLocalSpeed.y, radToDeg(odomLocalSpeed.theta));
+}
+
+Pose estimatePose(float time, bool radians) {
+    // get current position and speed
+    Pose curPose = getPose(true);
+    Pose localSpeed = getLocalSpeed(true);
+    // calculate the change in local position
+    Pose deltaLocalPose = localSpeed * time;
+    // calculate the future pose
+    float avgHeading = curPose.theta + deltaLocalPose.theta / 2;
+    Pose futurePose = curPose;
+    futurePose.x += deltaLocalPose.y * sin(avgHeading);
+    futurePose.y += deltaLocalPose.y * cos(avgHeading);
+    futurePose.x += deltaLocalPose.x * -cos(avgHeading);
+    futurePose.y += deltaLocalPose.x * sin(avgHeading);
+    if (!radians) futurePose.theta = radToDeg(futurePose.theta);
+    return futurePose;
+}
+
+void update() {
+    // get the current sensor values
+    float vertical1Raw = 0;
+    float vertical2Raw = 0;
+    float horizontal1Raw = 0;
+    float horizontal2Raw = 0;
+    float imuRaw = 0;
+    if (odomSensors.vertical1 != nullptr) vertical1Raw = odomSensors.vertical1->getDistanceTraveled();
+    if (odomSensors.vertical2 != nullptr) vertical2Raw = odomSensors.vertical2->getDistanceTraveled();
+    if (odomSensors.horizontal1 != nullptr) horizontal1Raw = odomSensors.horizontal1->getDistanceTraveled();
+    if (odomSensors.horizontal2 != nullptr) horizontal2Raw = odomSensors.horizontal2->getDistanceTraveled();
+    if (odomSensors.imu != nullptr) imuRaw = degToRad(odomSensors.imu->get_rotation());
+
+    // calculate the change in sensor values
+    float deltaVertical1 = vertical1Raw - prevVertical1;
+    float deltaVertical2 = vertical2Raw - prevVertical2;
+    float deltaHorizontal1 = horizontal1Raw - prevHorizontal1;
+    float deltaHorizontal2 = horizontal2Raw - prevHorizontal2;
+    float deltaImu = imuRaw - prevImu;
+
+    // update the previous sensor values
+    prevVertical1 = vertical1Raw;
+    prevVertical2 = vertical2Raw;
+    prevHorizontal1 = horizontal1Raw;
+    prevHorizontal2 = horizontal2Raw;
+    prevImu = imuRaw;
+
+    // calculate the heading of the robot
+    // Priority:
+    // 1. Horizontal tracking wheels
+    // 2. Vertical tracking wheels
+    // 3. Inertial Sensor
+    // 4. Drivetrain
+    float heading = odomPose.theta;
+    if (odomSensors.horizontal1 != nullptr && odomSensors.horizontal2 != nullptr) {
+        heading -= (deltaHorizontal1 - deltaHorizontal2) /
+                   (odomSensors.horizontal1->getOffset() - odomSensors.horizontal2->getOffset());
+    } else if (!odomSensors.vertical1->getType() && !odomSensors.vertical2->getType()) {
+        heading -= (deltaVertical1 - deltaVertical2) /
+                   (odomSensors.vertical1->getOffset() - odomSensors.vertical2->getOffset());
+    } else if (odomSensors.imu != nullptr) {
+        heading += deltaImu;
+    } else {
+        heading -= (deltaVertical1 - deltaVertical2) /
+                   (odomSensors.vertical1->getOffset() - odomSensors.vertical2->getOffset());
+    }
+    float deltaHeading = heading - odomPose.theta;
+    float avgHeading = odomPose.theta + deltaHeading / 2;
+
+    // choose tracking wheels to use, prioritizing non-powered tracking wheels
+    TrackingWheel* verticalWheel = nullptr;
+    TrackingWheel* horizontalWheel = nullptr;
+    if (!odomSensors.vertical1->getType()) verticalWheel = odomSensors.vertical1;
+    else if (!odomSensors.vertical2->getType()) verticalWheel = odomSensors.vertical2;
+    else verticalWheel = odomSensors.vertical1;
+    if (odomSensors.horizontal1 != nullptr) horizontalWheel = odomSensors.horizontal1;
+    else if (odomSensors.horizontal2 != nullptr) horizontalWheel = odomSensors.horizontal2;
+    float rawVertical = 0;
+    float rawHorizontal = 0;
+    if (verticalWheel != nullptr) rawVertical = verticalWheel->getDistanceTraveled();
+    if (horizontalWheel != nullptr) rawHorizontal = horizontalWheel->getDistanceTraveled();
+    float horizontalOffset = 0;
+    float verticalOffset = 0;
+    if (verticalWheel != nullptr) verticalOffset = verticalWheel->getOffset();
+    if (horizontalWheel != nullptr) horizontalOffset = horizontalWheel->getOffset();
+
+    // calculate change in x and y
+    float deltaX = 0;
+    float deltaY = 0;
+    if (verticalWheel != nullptr) deltaY = rawVertical - prevVertical;
+    if (horizontalWheel != nullptr) deltaX = rawHorizontal - prevHorizontal;
+    prevVertical = rawVertical;
+    prevHorizontal = rawHorizontal;
+
+    // calculate local x and y
+    float localX = 0;
+    float localY = 0;
+    if (deltaHeading == 0) { // prevent divide by 0
+        localX = deltaX;
+        localY = deltaY;
+    } else {
+        localX = 2 * sin(deltaHeading / 2) * (deltaX / deltaHeading + horizontalOffset);
+        localY = 2 * sin(deltaHeading / 2) * (deltaY / deltaHeading + verticalOffset);
+    }
+
+    // save previous pose
+    Pose prevPose = odomPose;
+
+    // calculate global x and y
+    odomPose.x += localY * sin(avgHeading);
+    odomPose.y += localY * cos(avgHeading);
+    odomPose.x += localX * -cos(avgHeading);
+    odomPose.y += localX * sin(avgHeading);
+    odomPose.theta = heading;
+
+    // calculate speed
+    odomSpeed.x = ema((odomPose.x - prevPose.x) / 0.01, odomSpeed.x, 0.95);
+    odomSpeed.y = ema((odomPose.y - prevPose.y) / 0.01, odomSpeed.y, 0.95);
+    odomSpeed.theta = ema((odomPose.theta - prevPose.theta) / 0.01, odomSpeed.theta, 0.95);
+
+    // calculate local speed
+    odomLocalSpeed.x = ema(localX / 0.01, odomLocalSpeed.x, 0.95);
+    odomLocalSpeed.y = ema(localY / 0.01, odomLocalSpeed.y, 0.95);
+    odomLocalSpeed.theta = ema(deltaHeading / 0.01, odomLocalSpeed.theta, 0.95);
+}
+
+void init() {
+    if (trackingTask == nullptr) {
+        trackingTask = new pros::Task([]() {
+            while (true) {
+                update();
+                pros::delay(10);
+            }
+        });
+    }
+}
+
+float defaultDriveCurve(float input, float scale) {
+    if (scale == 0) return input;
+    return (std::pow(2.718, -(scale / 10)) +
+            std::pow(2.718, (std::fabs(input) - 127) / 10) * (1 - std::pow(2.718, -(scale / 10)))) *
+           input;
+}
+
+// only construction and calibration, which start odometry. The motions run on the robot's MotionWorker instead
+Chassis::Chassis(Drivetrain drivetrain, ControllerSettings linearSettings, ControllerSettings angularSettings,
+                 OdomSensors sensors, DriveCurveFunction_t driveCurve)
+    : linearSettings(linearSettings),
+      angularSettings(angularSettings),
+      drivetrain(drivetrain),
+      sensors(sensors),
+      driveCurve(driveCurve) {}
+
+void Chassis::calibrate(bool calibrateIMU) {
+    if (sensors.imu != nullptr && calibrateIMU) {
+        sensors.imu->reset();
+        while (sensors.imu->is_calibrating()) pros::delay(10);
+    }
+    // without vertical tracking wheels, odometry tracks the drive motors
+    if (sensors.vertical1 == nullptr) {
+        sensors.vertical1 = new TrackingWheel(drivetrain.leftMotors, drivetrain.wheelDiameter,
+                                              -(drivetrain.trackWidth / 2), drivetrain.rpm);
+    }
+    if (sensors.vertical2 == nullptr) {
+        sensors.vertical2 = new TrackingWheel(drivetrain.rightMotors, drivetrain.wheelDiameter,
+                                              drivetrain.trackWidth / 2, drivetrain.rpm);
+    }
+    sensors.vertical1->reset();
+    sensors.vertical2->reset();
+    if (sensors.horizontal1 != nullptr) sensors.horizontal1->reset();
+    if (sensors.horizontal2 != nullptr) sensors.horizontal2->reset();
+    setSensors(sensors, drivetrain);
+    init();
+}
+
+void Chassis::setPose(float x, float y, float theta, bool radians) { lemlib::setPose(Pose(x, y, theta), radians); }
+
+void Chassis::setPose(Pose pose, bool radians) { lemlib::setPose(pose, radians); }
+
+Pose Chassis::getPose(bool radians) { return lemlib::getPose(radians); }
+
+std::string FAPID::input = "FAPID";
+pros::Task* FAPID::logTask = nullptr;
+pros::Mutex FAPID::logMutex = pros::Mutex();
+
+FAPID::FAPID(float kF, float kA, float kP, float kI, float kD, std::string name) {
+    this->kF = kF;
+    this->kA = kA;
+    this->kP = kP;
+    this->kI = kI;
+    this->kD = kD;
+    this->name = name;
+}
+
+void FAPID::setGains(float kF, float kA, float kP, float kI, float kD) {
+    this->kF = kF;
+    this->kA = kA;
+    this->kP = kP;
+    this->kI = kI;
+    this->kD = kD;
+}
+
+void FAPID::setExit(float largeError, float smallError, int largeTime, int smallTime, int maxTime) {
+    this->largeError = largeError;
+    this->smallError = smallError;
+    this->largeTime = largeTime;
+    this->smallTime = smallTime;
+    this->maxTime = maxTime;
+}
+
+float FAPID::update(float target, float position, bool log) {
+    const float error = target - position;
+    const float deltaError = error - prevError;
+    float output = kF * target + kP * error + kI * totalError + kD * deltaError;
+    if (kA != 0) output = slew(output, prevOutput, kA);
+    prevOutput = output;
+    prevError = error;
+    totalError += error;
+    return output;
+}
+
+void FAPID::reset() {
+    prevError = 0;
+    totalError = 0;
+    prevOutput = 0;
+}
+
+bool FAPID::settled() {
+    if (startTime == 0) {
+        startTime = pros::c::millis();
+        return false;
+    }
+    if (maxTime != -1 && pros::c::millis() - startTime > static_cast<uint32_t>(maxTime)) return true;
+    if (std::fabs(prevError) < largeError) {
+        if (!largeTimeCounter) largeTimeCounter = pros::millis();
+        else if (pros::millis() - largeTimeCounter > static_cast<uint32_t>(largeTime)) return true;
+    }
+    if (std::fabs(prevError) < smallError) {
+        if (!smallTimeCounter) smallTimeCounter = pros::millis();
+        else if (pros::millis() - smallTimeCounter > static_cast<uint32_t>(smallTime)) return true;
+    }
+    return false;
+}
+
+void FAPID::init() {}
+
+std::string format_as(Level level) {
+    switch (level) {
+        case Level::INFO: return "INFO";
+        case Level::DEBUG: return "DEBUG";
+        case Level::WARN: return "WARN";
+        case Level::ERROR: return "ERROR";
+        case Level::FATAL: return "FATAL";
+        default: return "UNKNOWN";
+    }
+}
+
+BaseSink::BaseSink(std::initializer_list<std::shared_ptr<BaseSink>> sinks) : sinks(sinks) {}
+
+void BaseSink::setLowestLevel(Level level) { lowestLevel = level; }
+
+void BaseSink::setFormat(const std::string& format) { logFormat = format; }
+
+fmt::dynamic_format_arg_store<fmt::format_context> BaseSink::getExtraFormattingArgs(const Message&) { return {}; }
+
+void BaseSink::sendMessage(const Message&) {}
+
+InfoSink::InfoSink() { setFormat("[LemLib] {level}: {message}"); }
+
+void InfoSink::sendMessage(const Message& message) { std::printf("%s\n", message.message.c_str()); }
+
+TelemetrySink::TelemetrySink() { setFormat("{message}"); }
+
+// the real sink wraps messages in escape codes for the LemLib terminal. The host keeps them as plain lines
+void TelemetrySink::sendMessage(const Message& message) { std::printf("TELEMETRY %s\n", message.message.c_str()); }
+
+std::shared_ptr<InfoSink> infoSink() {
+    static std::shared_ptr<InfoSink> sink = std::make_shared<InfoSink>();
+    return sink;
+}
+
+std::shared_ptr<TelemetrySink> telemetrySink() {
+    static std::shared_ptr<TelemetrySink> sink = std::make_shared<TelemetrySink>();
+    return sink;
+}
+} // namespace lemlib
@@ -0,0 +1,325 @@
+/**
+ * @file host/src/lvgl.cpp
+ * @brief The LVGL 5.3 object, style, line and label calls that project code makes, drawn into the host display
+ *
+ * PROS ships LVGL prebuilt for the brain, so the calls are rewritten here on the real lv_obj_t. They invalidate the
+ * same areas LVGL does: a change to an object invalidates its area before and after the change, clipped by its
+ * parents, and nothing if it or a parent is hidden or nothing changed. refreshDisplay() redraws only the invalidated
+ * areas, as LVGL's display driver does on the brain, so a test can check both what is drawn and how much of the
+ * screen was redrawn to draw it.
+ *
+ * Drawing is simplified: bodies are filled with their main color and a border, as circles if their radius is
+ * LV_RADIUS_CIRCLE, and lines are stroked at their width. Gradients, opacity, shadows and text are not drawn, so labels
+ * keep their text and invalidate their area when it is set, but draw nothing.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <vector>
+#include "display/lvgl.h"
+#include "host/sim.hpp"
+
+lv_style_t lv_style_scr;
+lv_style_t lv_style_plain;
+
+namespace {
+// LVGL's default styles
+void initStyles() {
+    std::memset(&lv_style_scr, 0, sizeof(lv_style_t));
+    lv_style_scr.body.main_color = LV_COLOR_WHITE;
+    lv_style_scr.body.grad_color = LV_COLOR_WHITE;
+    lv_style_scr.body.opa = LV_OPA_COVER;
+    lv_style_scr.body.border.color = LV_COLOR_BLACK;
+    lv_style_scr.line.color = LV_COLOR_MAKE(0x20, 0x20, 0x20);
+    lv_style_scr.line.width = 2;
+    lv_style_scr.line.opa = LV_OPA_COVER;
+    lv_style_copy(&lv_style_plain, &lv_style_scr);
+}
+
+// project code may copy the default styles before it creates anything
+const bool stylesReady = (initStyles(), true);
+
+// every object, in the order it was created. Later children are drawn over earlier ones
+std::vector<lv_obj_t*> objects;
+lv_obj_t* screen = nullptr;
+host::DisplayState display;
+lv_area_t invalid[LV_INV_FIFO_SIZE];
+int invalidCount = 0;
+
+bool intersect(lv_area_t& result, const lv_area_t& a, const lv_area_t& b) {
+    result = {std::max(a.x1, b.x1), std::max(a.y1, b.y1), std::min(a.x2, b.x2), std::min(a.y2, b.y2)};
+    return result.x1 <= result.x2 && result.y1 <= result.y2;
+}
+
+uint32_t size(const lv_area_t& area) {
+    return static_cast<uint32_t>(area.x2 - area.x1 + 1) * static_cast<uint32_t>(area.y2 - area.y1 + 1);
+}
+
+bool contains(const lv_area_t& outer, const lv_area_t& inner) {
+    return inner.x1 >= outer.x1 && inner.y1 >= outer.y1 && inner.x2 <= outer.x2 && inner.y2 <= outer.y2;
+}
+
+// labels, whose ext_attr is a label's rather than a line's
+std::vector<const lv_obj_t*> labels;
+
+bool isLabel(const lv_obj_t* obj) { return std::find(labels.begin(), labels.end(), obj) != labels.end(); }
+
+lv_line_ext_t* lineExt(const lv_obj_t* obj) {
+    return isLabel(obj) ? nullptr : static_cast<lv_line_ext_t*>(obj->ext_attr);
+}
+
+// lines draw past their area by their width
+void refreshExtSize(lv_obj_t* obj) {
+    obj->ext_size = lineExt(obj) != nullptr && obj->style_p != nullptr ? obj->style_p->line.width : 0;
+}
+
+void invalidateArea(const lv_area_t& area) {
+    const lv_area_t whole = {0, 0, host::DisplayState::WIDTH - 1, host::DisplayState::HEIGHT - 1};
+    lv_area_t clipped;
+    if (!intersect(clipped, area, whole)) return;
+    for (int i = 0; i < invalidCount; i++) {
+        if (contains(invalid[i], clipped)) return;
+    }
+    // out of room, so redraw the whole screen
+    if (invalidCount == LV_INV_FIFO_SIZE) {
+        invalid[0] = whole;
+        invalidCount = 1;
+        return;
+    }
+    invalid[invalidCount++] = clipped;
+}
+
+void invalidate(const lv_obj_t* obj) {
+    lv_area_t area = {static_cast<lv_coord_t>(obj->coords.x1 - obj->ext_size),
+                      static_cast<lv_coord_t>(obj->coords.y1 - obj->ext_size),
+                      static_cast<lv_coord_t>(obj->coords.x2 + obj->ext_size),
+                      static_cast<lv_coord_t>(obj->coords.y2 + obj->ext_size)};
+    for (const lv_obj_t* parent = obj; parent != nullptr; parent = parent->par) {
+        if (parent->hidden) return;
+        if (parent != obj && !intersect(area, area, parent->coords)) return;
+    }
+    invalidateArea(area);
+}
+
+void move(lv_obj_t* obj, lv_coord_t dx, lv_coord_t dy) {
+    obj->coords.x1 += dx;
+    obj->coords.y1 += dy;
+    obj->coords.x2 += dx;
+    obj->coords.y2 += dy;
+    for (lv_obj_t* child : objects) {
+        if (child->par == obj) move(child, dx, dy);
+    }
+}
+
+void put(int x, int y, lv_color_t color) { display.pixels[y][x] = color.full; }
+
+void drawBody(const lv_obj_t* obj, const lv_area_t& clip) {
+    const lv_style_t& style = *obj->style_p;
+    const float width = obj->coords.x2 - obj->coords.x1 + 1;
+    const float height = obj->coords.y2 - obj->coords.y1 + 1;
+    const bool circle = style.body.radius >= std::min(width, height) / 2;
+    const float radius = std::min(width, height) / 2;
+    const float centerX = obj->coords.x1 + width / 2;
+    const float centerY = obj->coords.y1 + height / 2;
+    for (int y = clip.y1; y <= clip.y2; y++) {
+        for (int x = clip.x1; x <= clip.x2; x++) {
+            // distance inside the edge, measured from the center of the pixel
+            float inside;
+            if (circle) {
+                inside = radius - std::hypot(x + 0.5f - centerX, y + 0.5f - centerY);
+            } else {
+                inside = std::min(std::min(x - obj->coords.x1, obj->coords.x2 - x),
+                                  std::min(y - obj->coords.y1, obj->coords.y2 - y));
+            }
+            if (inside < 0) continue;
+            if (inside < style.body.border.width) put(x, y, style.body.border.color);
+            else if (!style.body.empty) put(x, y, style.body.main_color);
+        }
+    }
+}
+
+void drawLine(const lv_obj_t* obj, const lv_area_t& clip) {
+    const lv_line_ext_t* ext = lineExt(obj);
+    const lv_style_t& style = *obj->style_p;
+    const float half = style.line.width / 2.0f;
+    for (int i = 0; i + 1 < ext->point_num; i++) {
+        const float x1 = obj->coords.x1 + ext->point_array[i].x;
+        const float y1 = obj->coords.y1 + ext->point_array[i].y;
+        const float x2 = obj->coords.x1 + ext->point_array[i + 1].x;
+        const float y2 = obj->coords.y1 + ext->point_array[i + 1].y;
+        const float length = std::hypot(x2 - x1, y2 - y1);
+        const lv_area_t box = {static_cast<lv_coord_t>(std::floor(std::min(x1, x2) - half)),
+                               static_cast<lv_coord_t>(std::floor(std::min(y1, y2) - half)),
+                               static_cast<lv_coord_t>(std::ceil(std::max(x1, x2) + half)),
+                               static_cast<lv_coord_t>(std::ceil(std::max(y1, y2) + half))};
+        lv_area_t area;
+        if (!intersect(area, box, clip)) continue;
+        for (int y = area.y1; y <= area.y2; y++) {
+            for (int x = area.x1; x <= area.x2; x++) {
+                // distance from the pixel to the closest point of the segment
+                float t = length > 0 ? ((x - x1) * (x2 - x1) + (y - y1) * (y2 - y1)) / (length * length) : 0;
+                t = std::clamp(t, 0.0f, 1.0f);
+                if (std::hypot(x - (x1 + t * (x2 - x1)), y - (y1 + t * (y2 - y1))) <= half) {
+                    put(x, y, style.line.color);
+                }
+            }
+        }
+    }
+}
+
+void draw(const lv_obj_t* obj, const lv_area_t& clip) {
+    if (obj->hidden) return;
+    const lv_area_t extended = {static_cast<lv_coord_t>(obj->coords.x1 - obj->ext_size),
+                                static_cast<lv_coord_t>(obj->coords.y1 - obj->ext_size),
+                                static_cast<lv_coord_t>(obj->coords.x2 + obj->ext_size),
+                                static_cast<lv_coord_t>(obj->coords.y2 + obj->ext_size)};
+    lv_area_t area;
+    if (!intersect(area, clip, extended) || isLabel(obj)) return;
+    if (lineExt(obj) != nullptr) drawLine(obj, area);
+    else drawBody(obj, area);
+    // children are clipped to their parent
+    if (!intersect(area, clip, obj->coords)) return;
+    for (const lv_obj_t* child : objects) {
+        if (child->par == obj) draw(child, area);
+    }
+}
+
+lv_obj_t* create(lv_obj_t* parent, lv_line_ext_t* ext) {
+    lv_obj_t* obj = new lv_obj_t();
+    obj->par = parent;
+    obj->ext_attr = ext;
+    if (parent == nullptr) {
+        obj->coords = {0, 0, host::DisplayState::WIDTH - 1, host::DisplayState::HEIGHT - 1};
+        obj->style_p = &lv_style_scr;
+    } else {
+        obj->coords = {parent->coords.x1, parent->coords.y1, static_cast<lv_coord_t>(parent->coords.x1 + LV_DPI - 1),
+                       static_cast<lv_coord_t>(parent->coords.y1 + LV_DPI * 2 / 3 - 1)};
+        obj->style_p = &lv_style_plain;
+    }
+    objects.push_back(obj);
+    refreshExtSize(obj);
+    invalidate(obj);
+    return obj;
+}
+} // namespace
+
+lv_obj_t* lv_scr_act(void) {
+    if (screen == nullptr) screen = create(nullptr, nullptr);
+    return screen;
+}
+
+lv_obj_t* lv_obj_create(lv_obj_t* parent, const lv_obj_t* copy) { return create(parent, nullptr); }
+
+lv_obj_t* lv_line_create(lv_obj_t* par, const lv_obj_t* copy) {
+    lv_line_ext_t* ext = new lv_line_ext_t();
+    ext->auto_size = 1;
+    return create(par, ext);
+}
+
+lv_obj_t* lv_label_create(lv_obj_t* par, const lv_obj_t* copy) {
+    lv_obj_t* obj = create(par, nullptr);
+    obj->ext_attr = new lv_label_ext_t();
+    labels.push_back(obj);
+    return obj;
+}
+
+void lv_obj_set_pos(lv_obj_t* obj, lv_coord_t x, lv_coord_t y) {
+    const lv_coord_t dx = (obj->par != nullptr ? obj->par->coords.x1 : 0) + x - obj->coords.x1;
+    const lv_coord_t dy = (obj->par != nullptr ? obj->par->coords.y1 : 0) + y - obj->coords.y1;
+    if (dx == 0 && dy == 0) return;
+    invalidate(obj);
+    move(obj, dx, dy);
+    invalidate(obj);
+}
+
+void lv_obj_set_size(lv_obj_t* obj, lv_coord_t w, lv_coord_t h) {
+    if (obj->coords.x2 - obj->coords.x1 + 1 == w && obj->coords.y2 - obj->coords.y1 + 1 == h) return;
+    invalidate(obj);
+    obj->coords.x2 = obj->coords.x1 + w - 1;
+    obj->coords.y2 = obj->coords.y1 + h - 1;
+    invalidate(obj);
+}
+
+void lv_obj_set_style(lv_obj_t* obj, lv_style_t* style) {
+    invalidate(obj);
+    obj->style_p = style;
+    refreshExtSize(obj);
+    invalidate(obj);
+}
+
+void lv_obj_set_hidden(lv_obj_t* obj, bool en) {
+    if (!obj->hidden) invalidate(obj);
+    obj->hidden = en;
+    if (!obj->hidden) invalidate(obj);
+}
+
+void lv_line_set_points(lv_obj_t* line, const lv_point_t* point_a, uint16_t point_num) {
+    lv_line_ext_t* ext = lineExt(line);
+    ext->point_array = point_a;
+    ext->point_num = point_num;
+    if (point_num > 0 && ext->auto_size) {
+        lv_coord_t xmax = LV_COORD_MIN;
+        lv_coord_t ymax = LV_COORD_MIN;
+        for (int i = 0; i < point_num; i++) {
+            xmax = std::max(point_a[i].x, xmax);
+            ymax = std::max(point_a[i].y, ymax);
+        }
+        lv_obj_set_size(line, xmax + line->style_p->line.width, ymax + line->style_p->line.width);
+    }
+    invalidate(line);
+}
+
+void lv_label_set_static_text(lv_obj_t* label, const char* text) {
+    lv_label_ext_t* ext = static_cast<lv_label_ext_t*>(label->ext_attr);
+    ext->text = const_cast<char*>(text);
+    ext->static_txt = 1;
+    invalidate(label);
+}
+
+void lv_style_copy(lv_style_t* dest, const lv_style_t* src) { std::memcpy(dest, src, sizeof(lv_style_t)); }
+
+namespace host {
+DisplayState& display() { return ::display; }
+
+void refreshDisplay() {
+    // join areas whose union is smaller than the two apart, as LVGL does
+    bool joined[LV_INV_FIFO_SIZE] = {};
+    for (int i = 0; i < invalidCount; i++) {
+        for (int j = 0; j < invalidCount; j++) {
+            if (i == j || joined[i] || joined[j]) continue;
+            const lv_area_t both = {std::min(invalid[i].x1, invalid[j].x1), std::min(invalid[i].y1, invalid[j].y1),
+                                    std::max(invalid[i].x2, invalid[j].x2), std::max(invalid[i].y2, invalid[j].y2)};
+            lv_area_t overlap;
+            if (!intersect(overlap, invalid[i], invalid[j])) continue;
+            if (size(both) >= size(invalid[i]) + size(invalid[j])) continue;
+            invalid[i] = both;
+            joined[j] = true;
+        }
+    }
+    ::display.areas = 0;
+    ::display.drawnPixels = 0;
+    for (int i = 0; i < invalidCount; i++) {
+        if (joined[i]) continue;
+        ::display.areas++;
+        ::display.drawnPixels += size(invalid[i]);
+        if (screen != nullptr) draw(screen, invalid[i]);
+    }
+    if (::display.areas > 0) ::display.refreshes++;
+    invalidCount = 0;
+}
+
+void resetDisplay() {
+    for (lv_obj_t* obj : objects) {
+        if (isLabel(obj)) delete static_cast<lv_label_ext_t*>(obj->ext_attr);
+        else delete lineExt(obj);
+        delete obj;
+    }
+    objects.clear();
+    labels.clear();
+    screen = nullptr;
+    invalidCount = 0;
+    initStyles();
+    std::memset(&::display, 0, sizeof(DisplayState));
+}
+} // namespace host
@@ -0,0 +1,91 @@
+/**
+ * @file host/src/misc.cpp
+ * @brief pros::Controller, competition status and the SD card on top of the host device state
+ */
+
+#include <cstdarg>
+#include <cstdio>
+#include "pros/misc.hpp"
+#include "host/sim.hpp"
+
+namespace pros {
+namespace c {
+int32_t controller_print(controller_id_e_t id, uint8_t line, uint8_t col, const char* fmt, ...) {
+    char text[sizeof(host::ControllerState::text[0])];
+    va_list args;
+    va_start(args, fmt);
+    vsnprintf(text, sizeof(text), fmt, args);
+    va_end(args);
+    return controller_set_text(id, line, col, text);
+}
+
+int32_t controller_set_text(controller_id_e_t id, uint8_t line, uint8_t col, const char* str) {
+    char* text = host::controller(id).text[line % 3];
+    const int size = sizeof(host::ControllerState::text[0]);
+    if (col >= size - 1) return 1;
+    // pad up to the column, then write over the existing text
+    for (int i = 0; i < col; i++) {
+        if (text[i] == '\0') text[i] = ' ';
+    }
+    std::snprintf(text + col, size - col, "%s", str);
+    return 1;
+}
+
+uint8_t competition_get_status(void) { return host::competitionStatus(); }
+
+int32_t usd_is_installed(void) { return 1; }
+} // namespace c
+
+Controller::Controller(controller_id_e_t id) : _id(id) {}
+
+std::int32_t Controller::is_connected(void) { return host::controller(_id).connected; }
+
+std::int32_t Controller::get_analog(controller_analog_e_t channel) { return host::controller(_id).analog[channel]; }
+
+std::int32_t Controller::get_battery_capacity(void) { return 100; }
+
+std::int32_t Controller::get_battery_level(void) { return 100; }
+
+std::int32_t Controller::get_digital(controller_digital_e_t button) { return host::controller(_id).digital[button]; }
+
+std::int32_t Controller::get_digital_new_press(controller_digital_e_t button) {
+    host::ControllerState& controller = host::controller(_id);
+    const bool pressed = controller.digital[button] && !controller.lastDigital[button];
+    controller.lastDigital[button] = controller.digital[button];
+    return pressed;
+}
+
+std::int32_t Controller::set_text(std::uint8_t line, std::uint8_t col, const char* str) {
+    return c::controller_set_text(_id, line, col, str);
+}
+
+std::int32_t Controller::set_text(std::uint8_t line, std::uint8_t col, const std::string& str) {
+    return c::controller_set_text(_id, line, col, str.c_str());
+}
+
+std::int32_t Controller::clear_line(std::uint8_t line) {
+    host::controller(_id).text[line % 3][0] = '\0';
+    return 1;
+}
+
+std::int32_t Controller::rumble(const char* rumble_pattern) { return 1; }
+
+std::int32_t Controller::clear(void) {
+    for (int line = 0; line < 3; line++) clear_line(line);
+    return 1;
+}
+
+namespace competition {
+std::uint8_t get_status(void) { return c::competition_get_status(); }
+
+std::uint8_t is_autonomous(void) { return (get_status() & COMPETITION_AUTONOMOUS) != 0; }
+
+std::uint8_t is_connected(void) { return (get_status() & COMPETITION_CONNECTED) != 0; }
+
+std::uint8_t is_disabled(void) { return (get_status() & COMPETITION_DISABLED) != 0; }
+} // namespace competition
+
+namespace usd {
+std::int32_t is_installed(void) { return c::usd_is_installed(); }
+} // namespace usd
+} // namespace pros
@@ -0,0 +1,357 @@
+/**
+ * @file host/src/motors.cpp
+ * @brief pros::Motor and pros::Motor_Group on top of the host motor model
+ */
+
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include "pros/motors.hpp"
+#include "pros/rtos.hpp"
+#include "host/sim.hpp"
+
+namespace pros {
+using host::MotorState;
+
+/**
+ * @brief Get the number of encoder counts in a degree of output shaft rotation
+ *
+ */
+static double countsPerDegree(const MotorState& motor) {
+    switch (motor.gearset) {
+        case E_MOTOR_GEARSET_36: return 1800.0 / 360;
+        case E_MOTOR_GEARSET_06: return 300.0 / 360;
+        default: return 900.0 / 360;
+    }
+}
+
+/**
+ * @brief Get the number of encoder units in a degree
+ *
+ */
+static double unitsPerDegree(const MotorState& motor) {
+    switch (motor.encoderUnits) {
+        case E_MOTOR_ENCODER_ROTATIONS: return 1.0 / 360;
+        case E_MOTOR_ENCODER_COUNTS: return countsPerDegree(motor);
+        default: return 1;
+    }
+}
+
+static double direction(const MotorState& motor) { return motor.reversed ? -1 : 1; }
+
+/**
+ * @brief Record a new command to a motor
+ *
+ */
+static MotorState& command(std::uint8_t port, MotorState::Mode mode) {
+    MotorState& motor = host::motor(port);
+    motor.mode = mode;
+    motor.commands++;
+    return motor;
+}
+
+Motor::Motor(const std::int8_t port, const motor_gearset_e_t gearset, const bool reverse,
+             const motor_encoder_units_e_t encoder_units)
+    : _port(std::abs(port)) {
+    set_gearing(gearset);
+    set_reversed(reverse || port < 0);
+    set_encoder_units(encoder_units);
+}
+
+Motor::Motor(const std::int8_t port, const motor_gearset_e_t gearset, const bool reverse)
+    : _port(std::abs(port)) {
+    set_gearing(gearset);
+    set_reversed(reverse || port < 0);
+}
+
+Motor::Motor(const std::int8_t port, const motor_gearset_e_t gearset) : _port(std::abs(port)) {
+    set_gearing(gearset);
+    if (port < 0) set_reversed(true);
+}
+
+Motor::Motor(const std::int8_t port, const bool reverse) : _port(std::abs(port)) { set_reversed(reverse || port < 0); }
+
+Motor::Motor(const std::int8_t port) : _port(std::abs(port)) {
+    if (port < 0) set_reversed(true);
+}
+
+std::int32_t Motor::operator=(std::int32_t voltage) const { return move(voltage); }
+
+std::int32_t Motor::move(std::int32_t voltage) const {
+    return move_voltage(std::clamp(voltage, -127, 127) * 12000 / 127);
+}
+
+std::int32_t Motor::move_absolute(const double position, const std::int32_t velocity) const {
+    MotorState& motor = command(_port, MotorState::Mode::POSITION);
+    motor.targetPosition = motor.zero + direction(motor) * position / unitsPerDegree(motor);
+    motor.targetVelocity = velocity;
+    return 1;
+}
+
+std::int32_t Motor::move_relative(const double position, const std::int32_t velocity) const {
+    return move_absolute(get_target_position() + position, velocity);
+}
+
+std::int32_t Motor::move_velocity(const std::int32_t velocity) const {
+    MotorState& motor = command(_port, MotorState::Mode::VELOCITY);
+    motor.targetVelocity = direction(motor) * velocity;
+    return 1;
+}
+
+std::int32_t Motor::move_voltage(const std::int32_t voltage) const {
+    MotorState& motor = command(_port, MotorState::Mode::VOLTAGE);
+    motor.voltage = direction(motor) * std::clamp(voltage, -12000, 12000);
+    return 1;
+}
+
+std::int32_t Motor::brake(void) const { return move_voltage(0); }
+
+std::int32_t Motor::modify_profiled_velocity(const std::int32_t velocity) const {
+    host::motor(_port).targetVelocity = velocity;
+    return 1;
+}
+
+double Motor::get_target_position(void) const {
+    const MotorState& motor = host::motor(_port);
+    return direction(motor) * (motor.targetPosition - motor.zero) * unitsPerDegree(motor);
+}
+
+std::int32_t Motor::get_target_velocity(void) const {
+    const MotorState& motor = host::motor(_port);
+    return direction(motor) * motor.targetVelocity;
+}
+
+double Motor::get_actual_velocity(void) const {
+    const MotorState& motor = host::motor(_port);
+    return direction(motor) * motor.velocity;
+}
+
+std::int32_t Motor::get_current_draw(void) const { return host::motor(_port).current; }
+
+std::int32_t Motor::get_direction(void) const { return get_actual_velocity() < 0 ? -1 : 1; }
+
+double Motor::get_efficiency(void) const { return 100; }
+
+std::int32_t Motor::is_over_current(void) const { return 0; }
+
+std::int32_t Motor::is_stopped(void) const { return std::abs(host::motor(_port).velocity) < 1; }
+
+std::int32_t Motor::get_zero_position_flag(void) const { return 0; }
+
+std::uint32_t Motor::get_faults(void) const { return 0; }
+
+std::uint32_t Motor::get_flags(void) const { return 0; }
+
+std::int32_t Motor::get_raw_position(std::uint32_t* const timestamp) const {
+    const MotorState& motor = host::motor(_port);
+    if (timestamp != nullptr) {
+        const uint32_t now = c::millis();
+        // time of the latest device update at or before now
+        *timestamp = now - (now + 10 - host::deviceUpdatePhase() % 10) % 10;
+    }
+    return std::lround(direction(motor) * motor.position * countsPerDegree(motor));
+}
+
+std::int32_t Motor::is_over_temp(void) const { return 0; }
+
+double Motor::get_position(void) const {
+    const MotorState& motor = host::motor(_port);
+    return direction(motor) * (motor.position - motor.zero) * unitsPerDegree(motor);
+}
+
+double Motor::get_power(void) const { return get_voltage() / 1000.0 * get_current_draw() / 1000.0; }
+
+double Motor::get_temperature(void) const { return 25; }
+
+double Motor::get_torque(void) const { return 0; }
+
+std::int32_t Motor::get_voltage(void) const {
+    const MotorState& motor = host::motor(_port);
+    return direction(motor) * motor.voltage;
+}
+
+std::int32_t Motor::set_zero_position(const double position) const {
+    MotorState& motor = host::motor(_port);
+    motor.zero = motor.position - direction(motor) * position / unitsPerDegree(motor);
+    return 1;
+}
+
+std::int32_t Motor::tare_position(void) const { return set_zero_position(0); }
+
+std::int32_t Motor::set_brake_mode(const motor_brake_mode_e_t mode) const {
+    host::motor(_port).brakeMode = mode;
+    return 1;
+}
+
+std::int32_t Motor::set_current_limit(const std::int32_t limit) const { return 1; }
+
+std::int32_t Motor::set_encoder_units(const motor_encoder_units_e_t units) const {
+    host::motor(_port).encoderUnits = units;
+    return 1;
+}
+
+std::int32_t Motor::set_gearing(const motor_gearset_e_t gearset) const {
+    host::motor(_port).gearset = gearset;
+    return 1;
+}
+
+motor_pid_s_t Motor::convert_pid(double kf, double kp, double ki, double kd) { return {}; }
+
+motor_pid_full_s_t Motor::convert_pid_full(double kf, double kp, double ki, double kd, double filter, double limit,
+                                           double threshold, double loopspeed) {
+    return {};
+}
+
+std::int32_t Motor::set_pos_pid(const motor_pid_s_t pid) const { return 1; }
+
+std::int32_t Motor::set_pos_pid_full(const motor_pid_full_s_t pid) const { return 1; }
+
+std::int32_t Motor::set_vel_pid(const motor_pid_s_t pid) const { return 1; }
+
+std::int32_t Motor::set_vel_pid_full(const motor_pid_full_s_t pid) const { return 1; }
+
+std::int32_t Motor::set_reversed(const bool reverse) const {
+    host::motor(_port).reversed = reverse;
+    return 1;
+}
+
+std::int32_t Motor::set_voltage_limit(const std::int32_t limit) const { return 1; }
+
+motor_brake_mode_e_t Motor::get_brake_mode(void) const {
+    return static_cast<motor_brake_mode_e_t>(host::motor(_port).brakeMode);
+}
+
+std::int32_t Motor::get_current_limit(void) const { return 2500; }
+
+motor_encoder_units_e_t Motor::get_encoder_units(void) const {
+    return static_cast<motor_encoder_units_e_t>(host::motor(_port).encoderUnits);
+}
+
+motor_gearset_e_t Motor::get_gearing(void) const { return static_cast<motor_gearset_e_t>(host::motor(_port).gearset); }
+
+motor_pid_full_s_t Motor::get_pos_pid(void) const { return {}; }
+
+motor_pid_full_s_t Motor::get_vel_pid(void) const { return {}; }
+
+std::int32_t Motor::is_reversed(void) const { return host::motor(_port).reversed; }
+
+std::int32_t Motor::get_voltage_limit(void) const { return 12000; }
+
+std::uint8_t Motor::get_port(void) const { return _port; }
+
+Motor_Group::Motor_Group(const std::initializer_list<Motor> motors)
+    : _motors(motors), _motor_count(motors.size()) {}
+
+Motor_Group::Motor_Group(const std::vector<pros::Motor>& motors) : _motors(motors), _motor_count(motors.size()) {}
+
+Motor_Group::Motor_Group(const std::initializer_list<std::int8_t> motor_ports)
+    : Motor_Group(std::vector<std::int8_t>(motor_ports)) {}
+
+Motor_Group::Motor_Group(const std::vector<std::int8_t> motor_ports) : _motor_count(motor_ports.size()) {
+    for (std::int8_t port : motor_ports) _motors.emplace_back(port);
+}
+
+std::int32_t Motor_Group::operator=(std::int32_t voltage) { return move(voltage); }
+
+std::int32_t Motor_Group::move(std::int32_t voltage) {
+    for (Motor& motor : _motors) motor.move(voltage);
+    return 1;
+}
+
+std::int32_t Motor_Group::move_absolute(const double position, const std::int32_t velocity) {
+    for (Motor& motor : _motors) motor.move_absolute(position, velocity);
+    return 1;
+}
+
+std::int32_t Motor_Group::move_relative(const double position, const std::int32_t velocity) {
+    for (Motor& motor : _motors) motor.move_relative(position, velocity);
+    return 1;
+}
+
+std::int32_t Motor_Group::move_velocity(const std::int32_t velocity) {
+    for (Motor& motor : _motors) motor.move_velocity(velocity);
+    return 1;
+}
+
+std::int32_t Motor_Group::move_voltage(const std::int32_t voltage) {
+    for (Motor& motor : _motors) motor.move_voltage(voltage);
+    return 1;
+}
+
+std::int32_t Motor_Group::brake(void) {
+    for (Motor& motor : _motors) motor.brake();
+    return 1;
+}
+
+pros::Motor& Motor_Group::operator[](int i) { return _motors[i]; }
+
+pros::Motor& Motor_Group::at(int i) { return _motors.at(i); }
+
+std::int32_t Motor_Group::size() { return _motor_count; }
+
+std::int32_t Motor_Group::set_zero_position(const double position) {
+    for (Motor& motor : _motors) motor.set_zero_position(position);
+    return 1;
+}
+
+std::int32_t Motor_Group::set_brake_modes(motor_brake_mode_e_t mode) {
+    for (Motor& motor : _motors) motor.set_brake_mode(mode);
+    return 1;
+}
+
+std::int32_t Motor_Group::set_reversed(const bool reversed) {
+    for (Motor& motor : _motors) motor.set_reversed(reversed);
+    return 1;
+}
+
+std::int32_t Motor_Group::set_gearing(const motor_gearset_e_t gearset) {
+    for (Motor& motor : _motors) motor.set_gearing(gearset);
+    return 1;
+}
+
+std::int32_t Motor_Group::set_encoder_units(const motor_encoder_units_e_t units) {
+    for (Motor& motor : _motors) motor.set_encoder_units(units);
+    return 1;
+}
+
+std::int32_t Motor_Group::tare_position(void) {
+    for (Motor& motor : _motors) motor.tare_position();
+    return 1;
+}
+
+std::vector<double> Motor_Group::get_actual_velocities(void) {
+    std::vector<double> velocities;
+    for (Motor& motor : _motors) velocities.push_back(motor.get_actual_velocity());
+    return velocities;
+}
+
+std::vector<double> Motor_Group::get_positions(void) {
+    std::vector<double> positions;
+    for (Motor& motor : _motors) positions.push_back(motor.get_position());
+    return positions;
+}
+
+std::vector<motor_gearset_e_t> Motor_Group::get_gearing(void) {
+    std::vector<motor_gearset_e_t> gearing;
+    for (Motor& motor : _motors) gearing.push_back(motor.get_gearing());
+    return gearing;
+}
+
+std::vector<std::int32_t> Motor_Group::get_current_draws(void) {
+    std::vector<std::int32_t> currents;
+    for (Motor& motor : _motors) currents.push_back(motor.get_current_draw());
+    return currents;
+}
+
+std::vector<std::uint8_t> Motor_Group::get_ports(void) {
+    std::vector<std::uint8_t> ports;
+    for (Motor& motor : _motors) ports.push_back(motor.get_port());
+    return ports;
+}
+
+std::vector<double> Motor_Group::get_temperatures(void) {
+    std::vector<double> temperatures;
+    for (Motor& motor : _motors) temperatures.push_back(motor.get_temperature());
+    return temperatures;
+}
+} // namespace pros
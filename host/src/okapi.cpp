@@ -0,0 +1,188 @@
+/**
+ * @file host/src/okapi.cpp
+ * @brief Host builds of the okapi classes that project code needs
+ *
+ * okapi only ships in this project as a prebuilt ARM library. Any project code that includes okapi's chassis or
+ * odometry headers also pulls in its default logger, which needs the logger, timer and chassis scales classes to
+ * link, so those are rewritten here after the okapi 4.8 sources. Logs to "/ser/sout" go to stdout. The filter base,
+ * EMA filter and odometry math are rewritten the same way for the benchmarks, see include/robot/bench.hpp.
+ */
+
+#include <cmath>
+#include <cstring>
+#include <stdexcept>
+#include <vector>
+#include "okapi/api/chassis/controller/chassisScales.hpp"
+#include "okapi/api/filter/emaFilter.hpp"
+#include "okapi/api/odometry/odomMath.hpp"
+#include "okapi/api/util/logging.hpp"
+#include "okapi/impl/util/timer.hpp"
+#include "pros/rtos.hpp"
+
+namespace okapi {
+AbstractTimer::AbstractTimer(QTime ifirstCalled)
+    : firstCalled(ifirstCalled),
+      lastCalled(ifirstCalled),
+      mark(ifirstCalled),
+      hardMark(0_ms),
+      repeatMark(ifirstCalled) {}
+
+AbstractTimer::~AbstractTimer() = default;
+
+QTime AbstractTimer::getDt() {
+    const QTime now = millis();
+    const QTime dt = now - lastCalled;
+    lastCalled = now;
+    return dt;
+}
+
+QTime AbstractTimer::readDt() const { return millis() - lastCalled; }
+
+QTime AbstractTimer::getStartingTime() const { return firstCalled; }
+
+QTime AbstractTimer::getDtFromStart() const { return millis() - firstCalled; }
+
+void AbstractTimer::placeMark() { mark = millis(); }
+
+QTime AbstractTimer::clearMark() {
+    const QTime old = mark;
+    mark = 0_ms;
+    return old;
+}
+
+void AbstractTimer::placeHardMark() {
+    if (hardMark == 0_ms) hardMark = millis();
+}
+
+QTime AbstractTimer::clearHardMark() {
+    const QTime old = hardMark;
+    hardMark = 0_ms;
+    return old;
+}
+
+QTime AbstractTimer::getDtFromMark() const { return mark != 0_ms ? millis() - mark : 0_ms; }
+
+QTime AbstractTimer::getDtFromHardMark() const { return hardMark != 0_ms ? millis() - hardMark : 0_ms; }
+
+bool AbstractTimer::repeat(QTime time) {
+    if (repeatMark == 0_ms) {
+        repeatMark = millis();
+        return false;
+    }
+    if (millis() - repeatMark >= time) {
+        repeatMark = 0_ms;
+        return true;
+    }
+    return false;
+}
+
+bool AbstractTimer::repeat(QFrequency frequency) { return repeat(QTime(1 / frequency.convert(Hz))); }
+
+Timer::Timer() : AbstractTimer(pros::millis() * millisecond) {}
+
+QTime Timer::millis() const { return pros::millis() * millisecond; }
+
+int DefaultLoggerInitializer::count = 0;
+std::shared_ptr<Logger> defaultLogger;
+
+Logger::Logger() noexcept : Logger(nullptr, static_cast<FILE*>(nullptr), LogLevel::off) {}
+
+Logger::Logger(std::unique_ptr<AbstractTimer> itimer, std::string_view ifileName, const LogLevel& ilevel) noexcept
+    : Logger(std::move(itimer),
+             isSerialStream(ifileName) ? stdout : std::fopen(std::string(ifileName).c_str(), "w"),
+             ilevel) {}
+
+Logger::Logger(std::unique_ptr<AbstractTimer> itimer, FILE* ifile, const LogLevel& ilevel) noexcept
+    : timer(std::move(itimer)),
+      logLevel(ilevel),
+      logfile(ifile) {}
+
+Logger::~Logger() {
+    if (logfile != nullptr && logfile != stdout) std::fclose(logfile);
+}
+
+std::shared_ptr<Logger> Logger::getDefaultLogger() { return defaultLogger; }
+
+void Logger::setDefaultLogger(std::shared_ptr<Logger> ilogger) { defaultLogger = std::move(ilogger); }
+
+bool Logger::isSerialStream(std::string_view filename) { return filename == "/ser/sout" || filename == "/ser/serr"; }
+
+void ChassisScales::validateInputSize(std::size_t inputSize, const std::shared_ptr<Logger>& logger) {
+    if (inputSize >= 2) return;
+    logger->error([]() { return std::string("ChassisScales: At least two measurements must be given"); });
+    throw std::invalid_argument("ChassisScales: At least two measurements must be given");
+}
+
+ChassisScales::ChassisScales(const std::initializer_list<QLength>& idimensions, double itpr,
+                             const std::shared_ptr<Logger>& ilogger) {
+    validateInputSize(idimensions.size(), ilogger);
+    const std::vector<QLength> dimensions(idimensions);
+    wheelDiameter = dimensions.at(0);
+    wheelTrack = dimensions.at(1);
+    middleWheelDistance = dimensions.size() >= 3 ? dimensions.at(2) : 0_m;
+    middleWheelDiameter = dimensions.size() >= 4 ? dimensions.at(3) : wheelDiameter;
+    tpr = itpr;
+    straight = tpr / (wheelDiameter.convert(meter) * 1_pi);
+    turn = wheelTrack.convert(meter) / wheelDiameter.convert(meter);
+    middle = tpr / (middleWheelDiameter.convert(meter) * 1_pi);
+}
+
+ChassisScales::ChassisScales(const std::initializer_list<double>& iscales, double itpr,
+                             const std::shared_ptr<Logger>& ilogger) {
+    validateInputSize(iscales.size(), ilogger);
+    const std::vector<double> scales(iscales);
+    tpr = itpr;
+    straight = scales.at(0);
+    turn = scales.at(1);
+    middle = scales.size() >= 4 ? scales.at(3) : straight;
+    wheelDiameter = (tpr / (straight * 1_pi)) * meter;
+    wheelTrack = turn * wheelDiameter;
+    middleWheelDistance = scales.size() >= 3 ? scales.at(2) * meter : 0_m;
+    middleWheelDiameter = (tpr / (middle * 1_pi)) * meter;
+}
+
+Filter::~Filter() = default;
+
+EmaFilter::EmaFilter(double ialpha) : alpha(ialpha) {}
+
+double EmaFilter::filter(double ireading) {
+    output = alpha * ireading + (1.0 - alpha) * lastOutput;
+    lastOutput = output;
+    return output;
+}
+
+double EmaFilter::getOutput() const { return output; }
+
+void EmaFilter::setGains(double ialpha) { alpha = ialpha; }
+
+QLength OdomMath::computeDistanceToPoint(const Point& ipoint, const OdomState& istate) {
+    const auto [xDiff, yDiff] = computeDiffs(ipoint, istate);
+    return computeDistance(xDiff, yDiff) * meter;
+}
+
+QAngle OdomMath::computeAngleToPoint(const Point& ipoint, const OdomState& istate) {
+    const auto [xDiff, yDiff] = computeDiffs(ipoint, istate);
+    return computeAngle(xDiff, yDiff, istate.theta.convert(radian)) * radian;
+}
+
+std::pair<QLength, QAngle> OdomMath::computeDistanceAndAngleToPoint(const Point& ipoint, const OdomState& istate) {
+    const auto [xDiff, yDiff] = computeDiffs(ipoint, istate);
+    return {computeDistance(xDiff, yDiff) * meter, computeAngle(xDiff, yDiff, istate.theta.convert(radian)) * radian};
+}
+
+QAngle OdomMath::constrainAngle360(const QAngle& angle) {
+    return angle - 360.0_deg * std::floor(angle.convert(degree) * (1.0 / 360.0));
+}
+
+QAngle OdomMath::constrainAngle180(const QAngle& angle) {
+    return angle - 360.0_deg * std::floor((angle.convert(degree) + 180.0) * (1.0 / 360.0));
+}
+
+std::pair<double, double> OdomMath::computeDiffs(const Point& ipoint, const OdomState& istate) {
+    return {(ipoint.x - istate.x).convert(meter), (ipoint.y - istate.y).convert(meter)};
+}
+
+double OdomMath::computeDistance(double xDiff, double yDiff) { return std::sqrt(xDiff * xDiff + yDiff * yDiff); }
+
+double OdomMath::computeAngle(double xDiff, double yDiff, double theta) { return std::atan2(yDiff, xDiff) - theta; }
+} // namespace okapi
@@ -0,0 +1,566 @@
+/**
+ * @file host/src/rtos.cpp
+ * @brief Virtual time scheduler behind the PROS RTOS API
+ *
+ * Every task runs on its own ucontext stack inside the single host thread, so only one task ever runs at a time. The
+ * scheduler follows FreeRTOS: the highest priority task that can run always runs, tasks of equal priority take turns,
+ * and a task that wakes a higher priority task (by notifying it, releasing a mutex it waits for, resuming it or
+ * raising its priority) is preempted on the spot. Mutexes use priority inheritance. Since a task only gives up the cpu
+ * inside these calls, a task that never blocks starves lower priority tasks exactly like it would on the brain.
+ *
+ * Unlike FreeRTOS, a task that is deleted or returns gives up the mutexes it holds, so the highest priority task
+ * waiting for one takes it instead of waiting forever on a task that no longer exists.
+ *
+ * The code driving the shim (tests, replay tools) runs outside of any task, and runs the scheduler whenever it calls
+ * host::runFor or blocks itself.
+ */
+
+#include <ucontext.h>
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <system_error>
+#include <vector>
+#include "pros/rtos.hpp"
+#include "robot/freertos.hpp"
+#include "host/sim.hpp"
+
+namespace {
+/**
+ * @brief A task in the shim
+ *
+ */
+struct TaskControl {
+        enum class State { READY, DELAYED, MUTEX_WAIT, NOTIFY_WAIT, JOIN_WAIT, DELETED };
+
+        std::string name;
+        // unique for the lifetime of the shim, unlike the address of the task
+        uint32_t number = 0;
+        // priority, raised above the base priority while holding a mutex a higher priority task waits for
+        uint32_t priority = TASK_PRIORITY_DEFAULT;
+        uint32_t basePriority = TASK_PRIORITY_DEFAULT;
+        pros::task_fn_t function = nullptr;
+        void* parameters = nullptr;
+        ucontext_t context;
+        std::unique_ptr<char[]> stack;
+        size_t stackSize = 0;
+        State state = State::READY;
+        bool suspended = false;
+        // virtual time a delay or wait ends at
+        uint64_t wake = UINT64_MAX;
+        // the mutex a task in MUTEX_WAIT waits for
+        struct MutexControl* waitingFor = nullptr;
+        // the number of the task a task in JOIN_WAIT waits for
+        uint32_t joining = 0;
+        uint32_t notifyValue = 0;
+        bool notifyPending = false;
+        // host time spent running the task, in microseconds
+        uint32_t runTime = 0;
+};
+
+/**
+ * @brief A mutex in the shim
+ *
+ */
+struct MutexControl {
+        TaskControl* owner = nullptr;
+};
+
+// host stacks need far more room than the brain's, since host code isn't built for size
+constexpr size_t MIN_STACK_BYTES = 256 * 1024;
+// stacks are filled with this so the untouched part can be measured
+constexpr char STACK_FILL = static_cast<char>(0xa5);
+
+std::vector<std::unique_ptr<TaskControl>> tasks;
+// stands in for the code driving the shim, which never runs on a task stack
+TaskControl driver;
+TaskControl* current = &driver;
+ucontext_t schedulerContext;
+uint64_t virtualTime = 0;
+size_t nextTask = 0;
+uint32_t nextNumber = 1;
+uint32_t totalRunTime = 0;
+
+void trampoline() {
+    current->function(current->parameters);
+    current->state = TaskControl::State::DELETED;
+    // returning switches to uc_link, the scheduler
+}
+
+/**
+ * @brief Every mutex that exists, so the mutexes of a deleted task can be found
+ *
+ * Mutexes are created by static objects too, so the list is built on first use
+ */
+std::vector<MutexControl*>& mutexes() {
+    static std::vector<MutexControl*> list;
+    return list;
+}
+
+/**
+ * @brief Remove a deleted task. Its mutexes go to the tasks waiting for them, or are left free
+ *
+ */
+void remove(TaskControl* task) {
+    for (MutexControl* mutex : mutexes()) {
+        if (mutex->owner == task) mutex->owner = nullptr;
+    }
+    tasks.erase(std::remove_if(tasks.begin(), tasks.end(), [task](auto& t) { return t.get() == task; }), tasks.end());
+}
+
+TaskControl* find(uint32_t number) {
+    for (auto& task : tasks) {
+        if (task->number == number) return task.get();
+    }
+    return nullptr;
+}
+
+/**
+ * @brief Whether a task can run now, without changing its state
+ *
+ */
+bool canRun(const TaskControl& task) {
+    if (task.suspended) return false;
+    switch (task.state) {
+        case TaskControl::State::READY: return true;
+        case TaskControl::State::DELAYED: return task.wake <= virtualTime;
+        case TaskControl::State::MUTEX_WAIT: return task.waitingFor->owner == nullptr || task.wake <= virtualTime;
+        case TaskControl::State::NOTIFY_WAIT: return task.notifyValue != 0 || task.wake <= virtualTime;
+        case TaskControl::State::JOIN_WAIT: return find(task.joining) == nullptr;
+        default: return false;
+    }
+}
+
+/**
+ * @brief Make a task that can run ready. A task waiting for a free mutex takes it
+ *
+ */
+void wake(TaskControl& task) {
+    if (task.state == TaskControl::State::MUTEX_WAIT && task.waitingFor->owner == nullptr) {
+        task.waitingFor->owner = &task;
+    }
+    task.waitingFor = nullptr;
+    task.wake = UINT64_MAX;
+    task.state = TaskControl::State::READY;
+}
+
+/**
+ * @brief Pick the highest priority task that can run. Tasks of equal priority take turns
+ *
+ * @return TaskControl* - the task, or nullptr if no task can run
+ */
+TaskControl* pickTask() {
+    TaskControl* best = nullptr;
+    size_t bestIndex = 0;
+    for (size_t i = 0; i < tasks.size(); i++) {
+        const size_t index = (nextTask + i) % tasks.size();
+        TaskControl* task = tasks[index].get();
+        if (canRun(*task) && (best == nullptr || task->priority > best->priority)) {
+            best = task;
+            bestIndex = index;
+        }
+    }
+    if (best != nullptr) nextTask = bestIndex + 1;
+    return best;
+}
+
+/**
+ * @brief Advance virtual time, stepping the device models
+ *
+ */
+void advance(uint64_t time) {
+    if (time <= virtualTime) return;
+    host::stepDevices(time - virtualTime);
+    virtualTime = time;
+}
+
+/**
+ * @brief Run tasks until the clock reaches a time or a condition is met
+ *
+ * Must be called from the driver
+ *
+ * @return true the condition was met
+ */
+bool schedule(uint64_t until, const std::function<bool()>* condition) {
+    while (true) {
+        if (condition != nullptr && (*condition)()) return true;
+        TaskControl* task = pickTask();
+        if (task != nullptr) {
+            wake(*task);
+            current = task;
+            const auto start = std::chrono::steady_clock::now();
+            swapcontext(&schedulerContext, &task->context);
+            const auto elapsed = std::chrono::steady_clock::now() - start;
+            current = &driver;
+            const uint32_t micros = std::chrono::duration_cast<std::chrono::microseconds>(elapsed).count();
+            task->runTime += micros;
+            totalRunTime += micros;
+            if (task->state == TaskControl::State::DELETED) remove(task);
+            continue;
+        }
+        // nothing can run, so jump to the next wake up
+        uint64_t next = until;
+        for (auto& t : tasks) {
+            if (!t->suspended) next = std::min(next, t->wake);
+        }
+        // everything is waiting forever
+        if (next == UINT64_MAX) return false;
+        advance(next);
+        if (virtualTime >= until) return condition != nullptr && (*condition)();
+    }
+}
+
+/**
+ * @brief Block the current task until it can run again
+ *
+ * @param state what the task waits for
+ * @param wake virtual time the wait times out at
+ */
+void block(TaskControl::State state, uint64_t wake) {
+    current->state = state;
+    current->wake = wake;
+    if (current == &driver) {
+        // the driver runs the scheduler itself instead of switching to it
+        const std::function<bool()> ready = []() { return canRun(driver); };
+        schedule(wake, &ready);
+        ::wake(driver);
+        return;
+    }
+    swapcontext(&current->context, &schedulerContext);
+}
+
+/**
+ * @brief Let a higher priority task that can now run preempt the current task
+ *
+ */
+void preempt() {
+    if (current == &driver) return;
+    for (auto& task : tasks) {
+        if (task.get() != current && task->priority > current->priority && canRun(*task)) {
+            swapcontext(&current->context, &schedulerContext);
+            return;
+        }
+    }
+}
+
+TaskControl* resolve(pros::task_t task) { return task != nullptr ? static_cast<TaskControl*>(task) : current; }
+
+/**
+ * @brief Count the bytes at the far end of a task's stack that were never written
+ *
+ */
+size_t unusedStack(const TaskControl& task) {
+    size_t unused = 0;
+    while (unused < task.stackSize && task.stack[unused] == STACK_FILL) unused++;
+    return unused;
+}
+} // namespace
+
+extern "C" {
+/**
+ * Like FreeRTOS, lists nothing and returns 0 if there are more tasks than statuses. Run time counters are host
+ * microseconds spent running each task, since virtual time stands still while a task runs. Free stack is measured on
+ * the host stack, in words
+ */
+uint32_t uxTaskGetSystemState(FreeRTOSTaskStatus* const statuses, const uint32_t size, uint32_t* const totalRunTime) {
+    if (tasks.size() > size) return 0;
+    uint32_t count = 0;
+    for (auto& task : tasks) {
+        FreeRTOSTaskStatus& status = statuses[count++];
+        status.handle = task.get();
+        status.name = task->name.c_str();
+        status.number = task->number;
+        status.state = pros::c::task_get_state(task.get());
+        status.currentPriority = task->priority;
+        status.basePriority = task->basePriority;
+        status.runTimeCounter = task->runTime;
+        status.stackBase = task->stack.get();
+        status.stackHighWaterMark = std::min<size_t>(unusedStack(*task) / 4, UINT16_MAX);
+    }
+    if (totalRunTime != nullptr) *totalRunTime = ::totalRunTime;
+    return count;
+}
+}
+
+namespace host {
+void resetScheduler() {
+    while (!tasks.empty()) remove(tasks.back().get());
+    driver = TaskControl();
+    current = &driver;
+    virtualTime = 0;
+    nextTask = 0;
+    totalRunTime = 0;
+}
+
+void runFor(uint32_t milliseconds) { schedule(virtualTime + milliseconds * 1000ull, nullptr); }
+
+bool runUntil(const std::function<bool()>& condition, uint32_t timeout) {
+    return schedule(virtualTime + timeout * 1000ull, &condition);
+}
+
+uint64_t now() { return virtualTime; }
+} // namespace host
+
+namespace pros {
+namespace c {
+uint32_t millis(void) { return virtualTime / 1000; }
+
+uint64_t micros(void) { return virtualTime; }
+
+void task_delay(const uint32_t milliseconds) {
+    // a delay of 0 just lets other tasks of the same priority run
+    if (milliseconds == 0 && current != &driver) {
+        swapcontext(&current->context, &schedulerContext);
+        return;
+    }
+    block(TaskControl::State::DELAYED, virtualTime + milliseconds * 1000ull);
+}
+
+void delay(const uint32_t milliseconds) { task_delay(milliseconds); }
+
+void task_delay_until(uint32_t* const prev_time, const uint32_t delta) {
+    const uint32_t wake = *prev_time + delta;
+    *prev_time = wake;
+    // a wake up time that already passed doesn't block, so a late loop catches up
+    const uint32_t now = millis();
+    if (static_cast<int32_t>(wake - now) <= 0) return;
+    block(TaskControl::State::DELAYED, (virtualTime / 1000 + (wake - now)) * 1000);
+}
+
+task_t task_create(task_fn_t function, void* const parameters, uint32_t prio, const uint16_t stack_depth,
+                   const char* const name) {
+    auto task = std::make_unique<TaskControl>();
+    task->name = name != nullptr ? name : "";
+    task->number = nextNumber++;
+    task->priority = prio;
+    task->basePriority = prio;
+    task->function = function;
+    task->parameters = parameters;
+    task->stackSize = std::max<size_t>(stack_depth * 4, MIN_STACK_BYTES);
+    task->stack = std::make_unique<char[]>(task->stackSize);
+    std::memset(task->stack.get(), STACK_FILL, task->stackSize);
+    getcontext(&task->context);
+    task->context.uc_stack.ss_sp = task->stack.get();
+    task->context.uc_stack.ss_size = task->stackSize;
+    task->context.uc_link = &schedulerContext;
+    makecontext(&task->context, trampoline, 0);
+    TaskControl* handle = task.get();
+    tasks.push_back(std::move(task));
+    preempt();
+    return handle;
+}
+
+void task_delete(task_t task) {
+    TaskControl* target = resolve(task);
+    if (target == &driver) return;
+    target->state = TaskControl::State::DELETED;
+    if (target == current) {
+        swapcontext(&current->context, &schedulerContext);
+        return;
+    }
+    remove(target);
+    // a task waiting for one of its mutexes may now run
+    preempt();
+}
+
+uint32_t task_get_priority(task_t task) { return resolve(task)->priority; }
+
+void task_set_priority(task_t task, uint32_t prio) {
+    TaskControl* target = resolve(task);
+    target->priority = prio;
+    target->basePriority = prio;
+    preempt();
+}
+
+task_state_e_t task_get_state(task_t task) {
+    const TaskControl* target = resolve(task);
+    if (target == current) return E_TASK_STATE_RUNNING;
+    if (target->suspended) return E_TASK_STATE_SUSPENDED;
+    switch (target->state) {
+        case TaskControl::State::READY: return E_TASK_STATE_READY;
+        case TaskControl::State::DELETED: return E_TASK_STATE_DELETED;
+        default: return E_TASK_STATE_BLOCKED;
+    }
+}
+
+void task_suspend(task_t task) {
+    TaskControl* target = resolve(task);
+    if (target == &driver) return;
+    target->suspended = true;
+    if (target == current) swapcontext(&current->context, &schedulerContext);
+}
+
+void task_resume(task_t task) {
+    TaskControl* target = resolve(task);
+    if (!target->suspended) return;
+    target->suspended = false;
+    // like FreeRTOS, resuming ends any delay. Waits return as if they timed out
+    if (target->state != TaskControl::State::JOIN_WAIT) target->wake = 0;
+    preempt();
+}
+
+uint32_t task_get_count(void) { return tasks.size(); }
+
+char* task_get_name(task_t task) { return const_cast<char*>(resolve(task)->name.c_str()); }
+
+task_t task_get_by_name(const char* name) {
+    for (auto& task : tasks) {
+        if (task->name == name) return task.get();
+    }
+    return nullptr;
+}
+
+task_t task_get_current() { return current; }
+
+uint32_t task_notify(task_t task) { return task_notify_ext(task, 0, E_NOTIFY_ACTION_INCR, nullptr); }
+
+void task_join(task_t task) {
+    TaskControl* target = resolve(task);
+    if (target == current) return;
+    current->joining = target->number;
+    block(TaskControl::State::JOIN_WAIT, UINT64_MAX);
+}
+
+uint32_t task_notify_ext(task_t task, uint32_t value, notify_action_e_t action, uint32_t* prev_value) {
+    TaskControl* target = resolve(task);
+    if (prev_value != nullptr) *prev_value = target->notifyValue;
+    const bool wasPending = target->notifyPending;
+    switch (action) {
+        case E_NOTIFY_ACTION_BITS: target->notifyValue |= value; break;
+        case E_NOTIFY_ACTION_INCR: target->notifyValue++; break;
+        case E_NOTIFY_ACTION_OWRITE: target->notifyValue = value; break;
+        case E_NOTIFY_ACTION_NO_OWRITE:
+            if (wasPending) return 0;
+            target->notifyValue = value;
+            break;
+        default: break;
+    }
+    target->notifyPending = true;
+    preempt();
+    return 1;
+}
+
+uint32_t task_notify_take(bool clear_on_exit, uint32_t timeout) {
+    if (current->notifyValue == 0 && timeout > 0) {
+        block(TaskControl::State::NOTIFY_WAIT, timeout == TIMEOUT_MAX ? UINT64_MAX : virtualTime + timeout * 1000ull);
+    }
+    const uint32_t value = current->notifyValue;
+    if (value != 0) current->notifyValue = clear_on_exit ? 0 : value - 1;
+    current->notifyPending = false;
+    return value;
+}
+
+bool task_notify_clear(task_t task) {
+    TaskControl* target = resolve(task);
+    const bool wasPending = target->notifyPending;
+    target->notifyPending = false;
+    return wasPending;
+}
+
+mutex_t mutex_create(void) {
+    MutexControl* mutex = new MutexControl();
+    mutexes().push_back(mutex);
+    return mutex;
+}
+
+bool mutex_take(mutex_t mutex, uint32_t timeout) {
+    MutexControl* m = static_cast<MutexControl*>(mutex);
+    if (m->owner == nullptr) {
+        m->owner = current;
+        return true;
+    }
+    if (timeout == 0) return false;
+    // the owner inherits the priority of the task waiting for it
+    if (m->owner->priority < current->priority) m->owner->priority = current->priority;
+    current->waitingFor = m;
+    block(TaskControl::State::MUTEX_WAIT, timeout == TIMEOUT_MAX ? UINT64_MAX : virtualTime + timeout * 1000ull);
+    return m->owner == current;
+}
+
+bool mutex_give(mutex_t mutex) {
+    MutexControl* m = static_cast<MutexControl*>(mutex);
+    if (m->owner != current) return false;
+    m->owner = nullptr;
+    current->priority = current->basePriority;
+    preempt();
+    return true;
+}
+
+void mutex_delete(mutex_t mutex) {
+    std::vector<MutexControl*>& list = mutexes();
+    list.erase(std::remove(list.begin(), list.end(), static_cast<MutexControl*>(mutex)), list.end());
+    delete static_cast<MutexControl*>(mutex);
+}
+} // namespace c
+
+Task::Task(task_fn_t function, void* parameters, std::uint32_t prio, std::uint16_t stack_depth, const char* name)
+    : task(c::task_create(function, parameters, prio, stack_depth, name)) {}
+
+Task::Task(task_fn_t function, void* parameters, const char* name)
+    : Task(function, parameters, TASK_PRIORITY_DEFAULT, TASK_STACK_DEPTH_DEFAULT, name) {}
+
+Task::Task(task_t task) : task(task) {}
+
+Task& Task::operator=(const task_t in) {
+    task = in;
+    return *this;
+}
+
+Task Task::current() { return Task(c::task_get_current()); }
+
+void Task::remove() { c::task_delete(task); }
+
+std::uint32_t Task::get_priority() { return c::task_get_priority(task); }
+
+void Task::set_priority(std::uint32_t prio) { c::task_set_priority(task, prio); }
+
+std::uint32_t Task::get_state() { return c::task_get_state(task); }
+
+void Task::suspend() { c::task_suspend(task); }
+
+void Task::resume() { c::task_resume(task); }
+
+const char* Task::get_name() { return c::task_get_name(task); }
+
+std::uint32_t Task::notify() { return c::task_notify(task); }
+
+void Task::join() { c::task_join(task); }
+
+std::uint32_t Task::notify_ext(std::uint32_t value, notify_action_e_t action, std::uint32_t* prev_value) {
+    return c::task_notify_ext(task, value, action, prev_value);
+}
+
+std::uint32_t Task::notify_take(bool clear_on_exit, std::uint32_t timeout) {
+    return c::task_notify_take(clear_on_exit, timeout);
+}
+
+bool Task::notify_clear() { return c::task_notify_clear(task); }
+
+void Task::delay(const std::uint32_t milliseconds) { c::task_delay(milliseconds); }
+
+void Task::delay_until(std::uint32_t* const prev_time, const std::uint32_t delta) {
+    c::task_delay_until(prev_time, delta);
+}
+
+std::uint32_t Task::get_count() { return c::task_get_count(); }
+
+Clock::time_point Clock::now() { return time_point {duration {c::millis()}}; }
+
+Mutex::Mutex() : mutex(c::mutex_create(), c::mutex_delete) {}
+
+bool Mutex::take() { return c::mutex_take(mutex.get(), TIMEOUT_MAX); }
+
+bool Mutex::take(std::uint32_t timeout) { return c::mutex_take(mutex.get(), timeout); }
+
+bool Mutex::give() { return c::mutex_give(mutex.get()); }
+
+void Mutex::lock() {
+    if (!take(TIMEOUT_MAX)) throw std::system_error(errno, std::system_category(), "Cannot obtain lock!");
+}
+
+void Mutex::unlock() { give(); }
+
+bool Mutex::try_lock() { return take(0); }
+} // namespace pros
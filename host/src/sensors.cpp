@@ -0,0 +1,281 @@
+/**
+ * @file host/src/sensors.cpp
+ * @brief pros::Imu, pros::Rotation, pros::Vision, pros::Optical and three wire ports on top of the host device
+ * state
+ */
+
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include "pros/adi.hpp"
+#include "pros/error.h"
+#include "pros/imu.hpp"
+#include "pros/optical.hpp"
+#include "pros/rotation.hpp"
+#include "pros/rtos.hpp"
+#include "pros/vision.hpp"
+#include "host/sim.hpp"
+
+namespace pros {
+using host::ImuState;
+using host::RotationState;
+
+// how long the inertial sensor takes to calibrate, in milliseconds
+static constexpr std::uint32_t IMU_CALIBRATION_TIME = 2000;
+
+/**
+ * @brief Get the state of an inertial sensor, failing if it is calibrating like the real sensor does
+ *
+ * @return ImuState* - the state, or nullptr if the sensor is calibrating
+ */
+static ImuState* readImu(std::uint8_t port) {
+    ImuState& imu = host::imu(port);
+    if (c::millis() < imu.calibrationEnd) {
+        errno = EAGAIN;
+        return nullptr;
+    }
+    return &imu;
+}
+
+std::int32_t Imu::reset(bool blocking) const {
+    ImuState& imu = host::imu(_port);
+    imu.rotation = 0;
+    imu.rotationOffset = 0;
+    imu.headingOffset = 0;
+    imu.calibrationEnd = c::millis() + IMU_CALIBRATION_TIME;
+    if (blocking) c::delay(IMU_CALIBRATION_TIME);
+    return 1;
+}
+
+std::int32_t Imu::set_data_rate(std::uint32_t rate) const { return 1; }
+
+double Imu::get_rotation() const {
+    const ImuState* imu = readImu(_port);
+    return imu != nullptr ? imu->rotation + imu->rotationOffset : PROS_ERR_F;
+}
+
+double Imu::get_heading() const {
+    const ImuState* imu = readImu(_port);
+    if (imu == nullptr) return PROS_ERR_F;
+    const double heading = std::fmod(imu->rotation + imu->headingOffset, 360);
+    return heading < 0 ? heading + 360 : heading;
+}
+
+pros::c::quaternion_s_t Imu::get_quaternion() const {
+    const double yaw = -get_yaw() * M_PI / 360;
+    return {0, 0, std::sin(yaw), std::cos(yaw)};
+}
+
+pros::c::euler_s_t Imu::get_euler() const { return {0, 0, get_yaw()}; }
+
+double Imu::get_pitch() const { return readImu(_port) != nullptr ? 0 : PROS_ERR_F; }
+
+double Imu::get_roll() const { return readImu(_port) != nullptr ? 0 : PROS_ERR_F; }
+
+double Imu::get_yaw() const {
+    const double heading = get_heading();
+    return heading > 180 ? heading - 360 : heading;
+}
+
+pros::c::imu_gyro_s_t Imu::get_gyro_rate() const { return {0, 0, host::imu(_port).drift}; }
+
+std::int32_t Imu::tare_rotation() const { return set_rotation(0); }
+
+std::int32_t Imu::tare_heading() const { return set_heading(0); }
+
+std::int32_t Imu::tare_pitch() const { return 1; }
+
+std::int32_t Imu::tare_yaw() const { return set_yaw(0); }
+
+std::int32_t Imu::tare_roll() const { return 1; }
+
+std::int32_t Imu::tare() const {
+    tare_rotation();
+    return tare_heading();
+}
+
+std::int32_t Imu::tare_euler() const { return tare_yaw(); }
+
+std::int32_t Imu::set_heading(const double target) const {
+    ImuState* imu = readImu(_port);
+    if (imu == nullptr) return PROS_ERR;
+    imu->headingOffset = target - imu->rotation;
+    return 1;
+}
+
+std::int32_t Imu::set_rotation(const double target) const {
+    ImuState* imu = readImu(_port);
+    if (imu == nullptr) return PROS_ERR;
+    imu->rotationOffset = target - imu->rotation;
+    return 1;
+}
+
+std::int32_t Imu::set_yaw(const double target) const { return set_heading(target < 0 ? target + 360 : target); }
+
+std::int32_t Imu::set_pitch(const double target) const { return 1; }
+
+std::int32_t Imu::set_roll(const double target) const { return 1; }
+
+std::int32_t Imu::set_euler(const pros::c::euler_s_t target) const { return set_yaw(target.yaw); }
+
+pros::c::imu_accel_s_t Imu::get_accel() const { return {0, 0, 1}; }
+
+pros::c::imu_status_e_t Imu::get_status() const {
+    return is_calibrating() ? pros::c::E_IMU_STATUS_CALIBRATING : static_cast<pros::c::imu_status_e_t>(0);
+}
+
+bool Imu::is_calibrating() const { return c::millis() < host::imu(_port).calibrationEnd; }
+
+Rotation::Rotation(const std::uint8_t port, const bool reverse_flag) : _port(port) {
+    host::rotation(port).reversed = reverse_flag;
+}
+
+std::int32_t Rotation::reset() { return reset_position(); }
+
+std::int32_t Rotation::set_data_rate(std::uint32_t rate) const { return 1; }
+
+std::int32_t Rotation::set_position(std::uint32_t position) {
+    RotationState& rotation = host::rotation(_port);
+    rotation.position = rotation.reversed ? -static_cast<double>(position) : position;
+    return 1;
+}
+
+std::int32_t Rotation::reset_position(void) { return set_position(0); }
+
+std::int32_t Rotation::get_position() {
+    const RotationState& rotation = host::rotation(_port);
+    return std::lround(rotation.reversed ? -rotation.position : rotation.position);
+}
+
+std::int32_t Rotation::get_velocity() {
+    const RotationState& rotation = host::rotation(_port);
+    return std::lround(rotation.reversed ? -rotation.velocity : rotation.velocity);
+}
+
+std::int32_t Rotation::get_angle() {
+    const std::int32_t angle = get_position() % 36000;
+    return angle < 0 ? angle + 36000 : angle;
+}
+
+std::int32_t Rotation::set_reversed(bool value) {
+    host::rotation(_port).reversed = value;
+    return 1;
+}
+
+std::int32_t Rotation::reverse() { return set_reversed(!host::rotation(_port).reversed); }
+
+std::int32_t Rotation::get_reversed() { return host::rotation(_port).reversed; }
+
+Vision::Vision(std::uint8_t port, vision_zero_e_t zero_point) : _port(port) {}
+
+std::int32_t Vision::read_by_sig(const std::uint32_t size_id, const std::uint32_t sig_id,
+                                 const std::uint32_t object_count, vision_object_s_t* const object_arr) const {
+    if (sig_id < 1 || sig_id > 8) {
+        errno = EINVAL;
+        return PROS_ERR;
+    }
+    const host::VisionState& vision = host::vision(_port);
+    // matching objects, largest first
+    host::VisionState::Object matches[host::VisionState::MAX_OBJECTS];
+    const int count = std::copy_if(vision.objects, vision.objects + std::min(vision.count, vision.MAX_OBJECTS),
+                                   matches, [&](const auto& object) { return object.signature == sig_id; }) -
+                      matches;
+    std::stable_sort(matches, matches + count, [](const auto& a, const auto& b) {
+        return a.width * a.height > b.width * b.height;
+    });
+    std::int32_t copied = 0;
+    for (std::uint32_t i = 0; i < object_count; i++) {
+        vision_object_s_t& object = object_arr[i];
+        object = {};
+        object.signature = VISION_OBJECT_ERR_SIG;
+        if (size_id + i >= static_cast<std::uint32_t>(count)) continue;
+        const host::VisionState::Object& match = matches[size_id + i];
+        object.signature = match.signature;
+        object.left_coord = match.left;
+        object.top_coord = match.top;
+        object.width = match.width;
+        object.height = match.height;
+        object.x_middle_coord = match.left + match.width / 2;
+        object.y_middle_coord = match.top + match.height / 2;
+        copied++;
+    }
+    if (size_id >= static_cast<std::uint32_t>(count)) {
+        errno = EDOM;
+        return PROS_ERR;
+    }
+    return copied;
+}
+
+Optical::Optical(const std::uint8_t port) : _port(port) {}
+
+Optical::Optical(std::uint8_t port, double time) : _port(port) { set_integration_time(time); }
+
+double Optical::get_hue() { return host::optical(_port).hue; }
+
+double Optical::get_saturation() { return host::optical(_port).saturation; }
+
+double Optical::get_brightness() { return host::optical(_port).brightness; }
+
+std::int32_t Optical::get_proximity() { return host::optical(_port).proximity; }
+
+std::int32_t Optical::set_led_pwm(uint8_t value) {
+    host::optical(_port).ledPwm = std::min<std::int32_t>(value, 100);
+    return 1;
+}
+
+std::int32_t Optical::get_led_pwm() { return host::optical(_port).ledPwm; }
+
+pros::c::optical_rgb_s_t Optical::get_rgb() { return {0, 0, 0, get_brightness()}; }
+
+pros::c::optical_raw_s_t Optical::get_raw() { return {}; }
+
+pros::c::optical_direction_e_t Optical::get_gesture() { return pros::c::NO_GESTURE; }
+
+pros::c::optical_gesture_s_t Optical::get_gesture_raw() { return {}; }
+
+std::int32_t Optical::enable_gesture() { return 1; }
+
+std::int32_t Optical::disable_gesture() { return 1; }
+
+double Optical::get_integration_time() { return host::optical(_port).integrationTime; }
+
+std::int32_t Optical::set_integration_time(double time) {
+    // the sensor clamps to what it supports
+    host::optical(_port).integrationTime = std::clamp(time, 3.0, 712.0);
+    return 1;
+}
+
+std::uint8_t Optical::get_port() { return _port; }
+
+ADIPort::ADIPort(std::uint8_t adi_port, adi_port_config_e_t type) : _smart_port(INTERNAL_ADI_PORT), _adi_port(adi_port) {
+    set_config(type);
+}
+
+std::int32_t ADIPort::get_config() const { return host::adi(_adi_port).config; }
+
+std::int32_t ADIPort::get_value() const { return host::adi(_adi_port).value; }
+
+std::int32_t ADIPort::set_config(adi_port_config_e_t type) const {
+    host::adi(_adi_port).config = type;
+    return 1;
+}
+
+std::int32_t ADIPort::set_value(std::int32_t value) const {
+    host::AdiState& adi = host::adi(_adi_port);
+    adi.value = value;
+    adi.writes++;
+    return 1;
+}
+
+ADIDigitalOut::ADIDigitalOut(std::uint8_t adi_port, bool init_state) : ADIPort(adi_port, E_ADI_DIGITAL_OUT) {
+    set_value(init_state);
+}
+
+// encoders count on their top port
+ADIEncoder::ADIEncoder(std::uint8_t adi_port_top, std::uint8_t adi_port_bottom, bool reversed)
+    : ADIPort(adi_port_top, E_ADI_LEGACY_ENCODER) {}
+
+std::int32_t ADIEncoder::reset() const { return set_value(0); }
+
+std::int32_t ADIEncoder::get_value() const { return ADIPort::get_value(); }
+} // namespace pros
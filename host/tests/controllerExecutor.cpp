@@ -0,0 +1,171 @@
+/**
+ * @file host/tests/controllerExecutor.cpp
+ * @brief Controller executor: stand-in controllers at 5 and 10ms stepped on schedule and in order, disabled
+ * controllers, sample times that aren't whole milliseconds, and late steps
+ */
+
+#include <algorithm>
+#include <string>
+#include "okapi/api/control/iterative/iterativeController.hpp"
+#include "robot/controllerExecutor.hpp"
+#include "test.hpp"
+
+namespace {
+// names of the controllers in the order they were stepped
+std::string order;
+
+/**
+ * A controller that outputs the reading it was stepped with and records when it was stepped
+ */
+class StandIn : public okapi::IterativeController<double, double> {
+    public:
+        StandIn(char name, okapi::QTime sampleTime) : name(name), sampleTime(sampleTime) {}
+
+        double step(double reading) override {
+            order += name;
+            if (steps > 0) {
+                maxInterval = std::max(maxInterval, pros::micros() - last);
+                minInterval = std::min(minInterval, pros::micros() - last);
+            }
+            last = pros::micros();
+            steps++;
+            output = reading;
+            return output;
+        }
+
+        double getOutput() const override { return output; }
+
+        void setOutputLimits(double, double) override {}
+
+        void setControllerSetTargetLimits(double, double) override {}
+
+        double getMaxOutput() override { return 1; }
+
+        double getMinOutput() override { return -1; }
+
+        void setSampleTime(okapi::QTime time) override { sampleTime = time; }
+
+        okapi::QTime getSampleTime() const override { return sampleTime; }
+
+        void setTarget(double) override {}
+
+        void controllerSet(double) override {}
+
+        double getTarget() override { return 0; }
+
+        double getProcessValue() const override { return 0; }
+
+        double getError() const override { return 0; }
+
+        bool isSettled() override { return false; }
+
+        void reset() override {}
+
+        void flipDisable() override { disabled = !disabled; }
+
+        void flipDisable(bool isDisabled) override { disabled = isDisabled; }
+
+        bool isDisabled() const override { return disabled; }
+
+        const char name;
+        okapi::QTime sampleTime;
+        bool disabled = false;
+        double output = 0;
+        uint32_t steps = 0;
+        uint64_t last = 0;
+        uint64_t minInterval = UINT64_MAX;
+        uint64_t maxInterval = 0;
+};
+
+/**
+ * Counts its reads, so every step reads a new value
+ */
+struct Counter : okapi::ControllerInput<double> {
+        double count = 0;
+
+        double controllerGet() override { return ++count; }
+};
+
+/**
+ * Keeps the last value written
+ */
+struct Last : okapi::ControllerOutput<double> {
+        double value = 0;
+
+        void controllerSet(double newValue) override { value = newValue; }
+};
+} // namespace
+
+TEST_CASE(stepsEachControllerAtItsSampleTimeInOrder) {
+    order.clear();
+    StandIn fast('f', 5 * okapi::millisecond);
+    StandIn slow('s', 10 * okapi::millisecond);
+    Counter fastInput;
+    Counter slowInput;
+    Last fastOutput;
+    Last slowOutput;
+    robot::ControllerExecutor executor;
+    CHECK(executor.add("fast", &fast, &fastInput, &fastOutput) == 0);
+    CHECK(executor.add("slow", &slow, &slowInput, &slowOutput) == 1);
+    executor.start();
+    host::runFor(99);
+    // both step straight away, then every sample time on the dot
+    CHECK(fast.steps == 20);
+    CHECK(slow.steps == 10);
+    CHECK(fast.minInterval == 5000);
+    CHECK(fast.maxInterval == 5000);
+    CHECK(slow.minInterval == 10000);
+    CHECK(slow.maxInterval == 10000);
+    // when both are due, the one added first steps first
+    CHECK(order.substr(0, 6) == "fsffsf");
+    // every step read the input and wrote the output
+    CHECK(fastOutput.value == 20);
+    CHECK(slowOutput.value == 10);
+    const robot::ControllerTiming timing = executor.getTiming(0);
+    CHECK(timing.steps == 20);
+    CHECK(timing.late == 0);
+    // a disabled controller keeps its schedule without being stepped
+    slow.flipDisable(true);
+    host::runFor(50);
+    CHECK(slow.steps == 10);
+    CHECK(fast.steps == 30);
+    slow.flipDisable(false);
+    host::runFor(10);
+    CHECK(slow.steps == 11);
+}
+
+TEST_CASE(sampleTimesThatArentWholeMillisecondsDontDrift) {
+    StandIn controller('c', 2.5 * okapi::millisecond);
+    Counter input;
+    Last output;
+    robot::ControllerExecutor executor;
+    executor.add("c", &controller, &input, &output);
+    executor.start();
+    host::runFor(1000);
+    // the task sleeps whole milliseconds, so steps are 2 or 3ms apart, but 400 of them fit in a second
+    CHECK(controller.steps == 400);
+    CHECK(controller.minInterval == 2000);
+    CHECK(controller.maxInterval == 3000);
+}
+
+TEST_CASE(countsStepsAWholeSampleTimeLate) {
+    robot::ManualClock clock;
+    StandIn controller('c', 10 * okapi::millisecond);
+    Counter input;
+    Last output;
+    robot::ControllerExecutor executor(clock);
+    executor.add("c", &controller, &input, &output);
+    executor.start();
+    CHECK(executor.update() == 10);
+    clock.advance(13000);
+    // 3ms late, so the next step is due at 20ms as planned
+    CHECK(executor.update() == 7);
+    CHECK(executor.getTiming(0).late == 0);
+    clock.advance(25000);
+    // a whole sample time late, so the schedule starts again from now
+    CHECK(executor.update() == 10);
+    CHECK(executor.getTiming(0).late == 1);
+    CHECK(executor.getTiming(0).steps == 3);
+}
+
+int main() { return test::runAll(); }
@@ -0,0 +1,199 @@
+/**
+ * @file host/tests/coroutine.cpp
+ * @brief Coroutine executor: spawn order, each kind of wait, nested routines, a full arena, and waits outside an
+ * executor
+ *
+ * Built with -std=gnu++20 and its own copy of the executor, see the Makefile
+ */
+
+#include <coroutine>
+#include <string>
+#include <vector>
+#include "lemlib/chassis/odom.hpp"
+#include "robot/coroutine.hpp"
+#include "test.hpp"
+
+namespace {
+std::string events;
+
+robot::Routine step(char name, uint32_t time) {
+    events += name;
+    co_await robot::delay(time);
+    events += name;
+}
+
+robot::Routine outer() {
+    events += 'o';
+    co_await step('i', 10);
+    events += 'o';
+}
+
+robot::Routine idle() { co_return; }
+
+/**
+ * Run an executor in its own task until every routine has ended
+ *
+ * @return bool - whether they ended within the timeout
+ */
+bool run(robot::CoroutineExecutor& executor, uint32_t timeout) {
+    bool done = false;
+    pros::Task task([&]() {
+        executor.run();
+        done = true;
+    });
+    return host::runUntil([&]() { return done; }, timeout);
+}
+
+/**
+ * A coroutine that isn't a Routine, so it runs outside any executor. Starts straight away and runs to the end
+ */
+struct Detached {
+        struct promise_type {
+                Detached get_return_object() { return {}; }
+
+                std::suspend_never initial_suspend() noexcept { return {}; }
+
+                std::suspend_never final_suspend() noexcept { return {}; }
+
+                void return_void() {}
+
+                void unhandled_exception() { std::terminate(); }
+        };
+};
+
+Detached waitOutside(uint32_t& woken) {
+    co_await robot::delay(50);
+    woken = pros::millis();
+}
+} // namespace
+
+TEST_CASE(routinesInterleaveInSpawnOrder) {
+    events.clear();
+    robot::CoroutineExecutor executor;
+    CHECK(executor.spawn(step('a', 5)));
+    CHECK(executor.spawn(step('b', 5)));
+    CHECK(executor.getCount() == 2);
+    CHECK(run(executor, 100));
+    // each runs to its first wait in spawn order, and both waits end on the same check
+    CHECK(events == "abab");
+    CHECK(executor.getCount() == 0);
+}
+
+TEST_CASE(delayTraveledAndIdleEndWhenTheyShould) {
+    pros::Motor left(1, pros::E_MOTOR_GEARSET_06);
+    pros::Motor right(2, pros::E_MOTOR_GEARSET_06);
+    pros::MotorGroup leftMotors({left});
+    pros::MotorGroup rightMotors({right});
+    lemlib::Drivetrain drivetrain(&leftMotors, &rightMotors, 12, 3.25, 360, 8);
+    robot::MotionWorker motions(drivetrain, lemlib::ControllerSettings(10, 30, 1, 100, 3, 500, 20),
+                                lemlib::ControllerSettings(2, 10, 1, 100, 3, 500, 20));
+    lemlib::setPose(lemlib::Pose(0, 0, 0));
+    motions.start();
+    // odometry moves the robot an inch every 10ms
+    pros::Task odometry(
+        []() {
+            for (int inch = 1; inch <= 40; inch++) {
+                pros::delay(10);
+                lemlib::setPose(lemlib::Pose(0, inch, 0));
+            }
+        },
+        TASK_PRIORITY_MAX);
+    uint32_t delayed = 0;
+    float traveled = 0;
+    uint32_t idle = 0;
+    bool busy = true;
+    auto drive = [&]() -> robot::Routine {
+        const uint32_t start = pros::millis();
+        co_await robot::delay(20);
+        delayed = pros::millis() - start;
+        // the pose never reaches the target, so the motion runs for its whole timeout
+        const float from = lemlib::getPose().y;
+        motions.moveToPoint(0, 100, 200);
+        co_await robot::traveled(motions, 5.5);
+        traveled = lemlib::getPose().y - from;
+        co_await robot::idle(motions);
+        idle = pros::millis() - start;
+        busy = motions.isBusy();
+    };
+    robot::CoroutineExecutor executor;
+    CHECK(executor.spawn(drive()));
+    CHECK(run(executor, 1000));
+    CHECK(delayed == 20);
+    // seen within a check of the crossing
+    CHECK(traveled >= 6);
+    CHECK(traveled <= 7);
+    CHECK(idle >= 220);
+    CHECK(idle <= 232);
+    CHECK(!busy);
+}
+
+TEST_CASE(awaitedRoutineRunsToTheEndFirst) {
+    events.clear();
+    robot::CoroutineExecutor executor;
+    CHECK(executor.spawn(outer()));
+    CHECK(executor.spawn(step('s', 5)));
+    CHECK(run(executor, 100));
+    // the sibling runs while the nested routine waits, and the outer routine only goes on once the nested one ended
+    CHECK(events == "oissio");
+    CHECK(robot::CoroutineExecutor::getArenaStats().used == 0);
+}
+
+TEST_CASE(spawnFailsOnceTheArenaOrTheExecutorIsFull) {
+    const robot::ArenaStats before = robot::CoroutineExecutor::getArenaStats();
+    CHECK(before.used == 0);
+    {
+        // routines don't start until spawned, but their frames are taken as soon as they are called
+        std::vector<robot::Routine> held;
+        held.reserve(robot::COROUTINE_FRAMES);
+        for (int i = 0; i < robot::COROUTINE_FRAMES; i++) held.push_back(idle());
+        CHECK(robot::CoroutineExecutor::getArenaStats().used == robot::COROUTINE_FRAMES);
+        robot::CoroutineExecutor executor;
+        CHECK(!executor.spawn(idle()));
+        CHECK(executor.getCount() == 0);
+        CHECK(robot::CoroutineExecutor::getArenaStats().failures == before.failures + 1);
+        CHECK(robot::CoroutineExecutor::getArenaStats().peak == robot::COROUTINE_FRAMES);
+    }
+    CHECK(robot::CoroutineExecutor::getArenaStats().used == 0);
+    // with room in the arena, the executor runs out of slots first
+    robot::CoroutineExecutor executor;
+    for (int i = 0; i < robot::CoroutineExecutor::MAX_ROUTINES; i++) CHECK(executor.spawn(idle()));
+    CHECK(!executor.spawn(idle()));
+    CHECK(robot::CoroutineExecutor::getArenaStats().used == robot::CoroutineExecutor::MAX_ROUTINES);
+    CHECK(run(executor, 100));
+    CHECK(robot::CoroutineExecutor::getArenaStats().used == 0);
+}
+
+TEST_CASE(waitsOutsideAnExecutorBlock) {
+    uint32_t woken = 0;
+    uint32_t returned = 0;
+    pros::Task plain([&]() {
+        waitOutside(woken);
+        returned = pros::millis();
+    });
+    host::runFor(100);
+    // the coroutine didn't suspend, so its task blocked in the wait and returned once it ended
+    CHECK(woken == 50);
+    CHECK(returned == 50);
+    // the same in another task while an executor runs, which doesn't resume routines it didn't spawn
+    events.clear();
+    woken = 0;
+    returned = 0;
+    robot::CoroutineExecutor executor;
+    CHECK(executor.spawn(step('e', 200)));
+    bool done = false;
+    pros::Task executing([&]() {
+        executor.run();
+        done = true;
+    });
+    const uint32_t start = pros::millis();
+    pros::Task other([&]() {
+        waitOutside(woken);
+        returned = pros::millis();
+    });
+    CHECK(host::runUntil([&]() { return done; }, 300));
+    CHECK(woken == start + 50);
+    CHECK(returned == start + 50);
+    CHECK(events == "ee");
+}
+
+int main() { return test::runAll(); }
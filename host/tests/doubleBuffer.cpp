@@ -0,0 +1,89 @@
+/**
+ * @file host/tests/doubleBuffer.cpp
+ * @brief Double buffer: values are seen once published, and a copy the writer overwrote is made again
+ */
+
+#include "pros/rtos.hpp"
+#include "robot/doubleBuffer.hpp"
+#include "test.hpp"
+
+namespace {
+/**
+ * A value whose copy takes a millisecond, so the writer can come around while a reader copies it
+ */
+struct Slow {
+        uint32_t sequence = 0;
+        uint32_t check = 0;
+
+        Slow() = default;
+
+        Slow(const Slow& other) : sequence(other.sequence) {
+            pros::delay(1);
+            check = other.check;
+        }
+
+        Slow& operator=(const Slow& other) = default;
+};
+} // namespace
+
+TEST_CASE(valuesAreSeenOncePublished) {
+    robot::DoubleBuffer<int> buffer;
+    CHECK(buffer.get() == 0);
+    CHECK(buffer.getSequence() == 0);
+    uint32_t sequence = 0;
+    buffer.beginWrite(sequence) = 5;
+    CHECK(sequence == 1);
+    // not published yet
+    CHECK(buffer.get() == 0);
+    buffer.publish();
+    CHECK(buffer.get() == 5);
+    CHECK(buffer.getLatest() == 5);
+    CHECK(buffer.getSequence() == 1);
+    // the next value goes in the other buffer, which still holds the one before
+    int& next = buffer.beginWrite(sequence);
+    CHECK(sequence == 2);
+    CHECK(next == 0);
+    next = 6;
+    CHECK(buffer.get() == 5);
+    buffer.publish();
+    CHECK(buffer.get() == 6);
+    CHECK(buffer.getRetries() == 0);
+}
+
+TEST_CASE(overwrittenCopiesAreMadeAgain) {
+    robot::DoubleBuffer<Slow> buffer;
+    // publishes two values every millisecond, above the reader. A copy takes a millisecond, so every copy made while
+    // the writer runs is overwritten before it finishes
+    bool done = false;
+    pros::Task writer(
+        [&]() {
+            while (!done) {
+                for (int i = 0; i < 2; i++) {
+                    uint32_t sequence;
+                    Slow& value = buffer.beginWrite(sequence);
+                    value.sequence = sequence;
+                    value.check = sequence;
+                    buffer.publish();
+                }
+                pros::delay(1);
+            }
+        },
+        TASK_PRIORITY_MAX);
+    host::runFor(5);
+    Slow copy;
+    bool copied = false;
+    pros::Task reader([&]() {
+        copy = buffer.get();
+        copied = true;
+    });
+    host::runFor(3);
+    CHECK(!copied);
+    CHECK(buffer.getRetries() > 0);
+    // once the writer stops, the next copy is intact
+    done = true;
+    host::runFor(5);
+    CHECK(copied);
+    CHECK(copy.check == copy.sequence);
+}
+
+int main() { return test::runAll(); }
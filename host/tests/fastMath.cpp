@@ -0,0 +1,63 @@
+/**
+ * @file host/tests/fastMath.cpp
+ * @brief Accuracy of the fast trigonometry against double precision libm
+ */
+
+#include <algorithm>
+#include "robot/fastMath.hpp"
+#include "test.hpp"
+
+using namespace robot::fastmath;
+
+TEST_CASE(sinCosWithin1000Radians) {
+    double error = 0;
+    for (int i = -1000000; i <= 1000000; i++) {
+        const float angle = i * 0.001f;
+        float sine, cosine;
+        approxSinCos(angle, sine, cosine);
+        error = std::max(error, std::fabs(sine - std::sin(static_cast<double>(angle))));
+        error = std::max(error, std::fabs(cosine - std::cos(static_cast<double>(angle))));
+    }
+    CHECK(error < 1e-7);
+}
+
+TEST_CASE(sinCosOfHugeAngles) {
+    for (const float angle : {7e4f, -1e5f, 1e7f, -3e8f, 3e9f, 3e38f}) {
+        float sine, cosine;
+        approxSinCos(angle, sine, cosine);
+        CHECK_NEAR(sine, std::sin(static_cast<double>(angle)), 1e-6);
+        CHECK_NEAR(cosine, std::cos(static_cast<double>(angle)), 1e-6);
+    }
+}
+
+TEST_CASE(sinCosOfNonFiniteAngles) {
+    for (const float angle : {NAN, INFINITY, -INFINITY}) {
+        float sine, cosine;
+        approxSinCos(angle, sine, cosine);
+        CHECK(std::isnan(sine));
+        CHECK(std::isnan(cosine));
+    }
+}
+
+TEST_CASE(atan2AllDirections) {
+    double error = 0;
+    for (int i = 0; i <= 200000; i++) {
+        const double direction = -M_PI + i * (2 * M_PI / 200000);
+        for (const double radius : {1e-3, 1.0, 3.5, 1e4}) {
+            const float y = radius * std::sin(direction);
+            const float x = radius * std::cos(direction);
+            error = std::max(error, std::fabs(approxAtan2(y, x) - std::atan2(static_cast<double>(y), x)));
+        }
+    }
+    CHECK(error < 2e-6);
+}
+
+TEST_CASE(atan2Axes) {
+    CHECK(approxAtan2(0, 0) == 0);
+    CHECK_NEAR(approxAtan2(0, 1), 0, 1e-7);
+    CHECK_NEAR(approxAtan2(1, 0), M_PI / 2, 2e-6);
+    CHECK_NEAR(approxAtan2(-1, 0), -M_PI / 2, 2e-6);
+    CHECK_NEAR(approxAtan2(0, -1), M_PI, 2e-6);
+}
+
+int main() { return test::runAll(); }
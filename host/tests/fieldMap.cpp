@@ -0,0 +1,98 @@
+/**
+ * @file host/tests/fieldMap.cpp
+ * @brief Field map rendering: what is drawn, how much of the screen is redrawn, and clearing the path
+ */
+
+#include <cstring>
+#include "display/lvgl.h"
+#include "robot/fieldMap.hpp"
+#include "test.hpp"
+
+namespace {
+// the map is drawn at (250, 10) and is 220 pixels across, so an inch is 220 / 144 pixels
+constexpr int MAP_X = 250;
+constexpr int MAP_Y = 10;
+constexpr int MAP_SIZE = 220;
+
+const uint32_t FIELD = LV_COLOR_MAKE(0x30, 0x30, 0x30).full;
+const uint32_t PATH = LV_COLOR_MAKE(0x00, 0xc0, 0x40).full;
+const uint32_t ROBOT = LV_COLOR_MAKE(0x20, 0x60, 0xff).full;
+const uint32_t LOOKAHEAD = LV_COLOR_MAKE(0xff, 0x30, 0x30).full;
+
+// a straight path up the middle of the field
+char pathText[] = "0, -48, 100\n0, -24, 100\n0, 0, 100\n0, 24, 100\n0, 48, 0\nendData\n";
+const asset PATH_ASSET = {reinterpret_cast<uint8_t*>(pathText), sizeof(pathText) - 1};
+
+/**
+ * Color of the screen pixel at a field position, in inches
+ */
+uint32_t at(float x, float y) {
+    const float scale = MAP_SIZE / robot::FieldMap::FIELD_SIZE;
+    const int column = MAP_X + static_cast<int>(MAP_SIZE / 2 + x * scale);
+    const int row = MAP_Y + static_cast<int>(MAP_SIZE / 2 - y * scale);
+    return host::display().pixels[row][column];
+}
+} // namespace
+
+TEST_CASE(drawsTheRobotPathAndLookahead) {
+    robot::FieldMap map;
+    map.init(MAP_X, MAP_Y, MAP_SIZE);
+    map.setPath(PATH_ASSET, 24);
+    map.update(lemlib::Pose(0, -48, 0));
+    host::refreshDisplay();
+    CHECK(host::display().drawnPixels == host::DisplayState::WIDTH * host::DisplayState::HEIGHT);
+    CHECK(at(-40, 40) == FIELD);
+    // below the center, clear of the heading line
+    CHECK(at(0, -51) == ROBOT);
+    CHECK(at(0, 36) == PATH);
+    // 24 inches ahead of the robot along the path
+    CHECK(at(0, -24) == LOOKAHEAD);
+    // outside the map
+    CHECK(host::display().pixels[5][MAP_X + 10] != FIELD);
+}
+
+TEST_CASE(redrawsOnlyAroundWhatMoved) {
+    robot::FieldMap map;
+    map.init(MAP_X, MAP_Y, MAP_SIZE);
+    map.update(lemlib::Pose(0, 0, 0));
+    host::refreshDisplay();
+    // a robot that hasn't moved by a pixel invalidates nothing
+    const uint32_t refreshes = host::display().refreshes;
+    map.update(lemlib::Pose(0.1, 0.1, 0.5));
+    host::refreshDisplay();
+    CHECK(host::display().refreshes == refreshes);
+    CHECK(host::display().drawnPixels == 0);
+    // moving a foot redraws the squares around the old and new robot, a tiny part of the map
+    map.update(lemlib::Pose(12, 0, 0));
+    host::refreshDisplay();
+    CHECK(host::display().drawnPixels > 0);
+    CHECK(host::display().drawnPixels <= 2 * 18 * 18);
+    CHECK(at(0, -3) == FIELD);
+    CHECK(at(12, -3) == ROBOT);
+    // turning only redraws the robot, whose heading line is inside it
+    map.update(lemlib::Pose(12, 0, 90));
+    host::refreshDisplay();
+    CHECK(host::display().drawnPixels <= 18 * 18);
+}
+
+TEST_CASE(clearsThePathWhenTheMotionEnds) {
+    robot::FieldMap map;
+    map.init(MAP_X, MAP_Y, MAP_SIZE);
+    bool following = true;
+    map.setPath(PATH_ASSET, 24, [&]() { return following; });
+    map.update(lemlib::Pose(0, -48, 0));
+    host::refreshDisplay();
+    CHECK(at(0, 36) == PATH);
+    following = false;
+    map.update(lemlib::Pose(0, -48, 0));
+    host::refreshDisplay();
+    CHECK(at(0, 36) == FIELD);
+    CHECK(at(0, -24) == FIELD);
+    // a new path is shown even though the last motion has ended
+    map.setPath(PATH_ASSET, 24, []() { return true; });
+    map.update(lemlib::Pose(0, -48, 0));
+    host::refreshDisplay();
+    CHECK(at(0, 36) == PATH);
+}
+
+int main() { return test::runAll(); }
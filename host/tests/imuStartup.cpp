@@ -0,0 +1,72 @@
+/**
+ * @file host/tests/imuStartup.cpp
+ * @brief Drift measured while disabled is saved, and the next start loads it and skips the calibration
+ */
+
+#include <cstdio>
+#include "pros/misc.h"
+#include "robot/imuStartup.hpp"
+#include "test.hpp"
+
+namespace {
+const char* const SAVED = "/tmp/robot-imu-test.bin";
+constexpr uint8_t IMU_PORT = 17;
+// degrees per second, well inside MAX_DRIFT
+constexpr double DRIFT = 0.02;
+
+/**
+ * A drivetrain and chassis using the inertial sensor, as the robot builds them
+ */
+struct Robot {
+        pros::Motor_Group left {1, 2};
+        pros::Motor_Group right {3, 4};
+        lemlib::Drivetrain drivetrain {&left, &right, 10, 3.25, 450, 8};
+        robot::CorrectedImu imu {IMU_PORT};
+        lemlib::Chassis chassis {drivetrain,
+                                 lemlib::ControllerSettings(10, 30, 1, 100, 3, 500, 20),
+                                 lemlib::ControllerSettings(2, 10, 1, 100, 3, 500, 0),
+                                 lemlib::OdomSensors(nullptr, nullptr, nullptr, nullptr, &imu)};
+        robot::ImuStartup startup {chassis, imu, drivetrain, SAVED};
+};
+} // namespace
+
+TEST_CASE(measuredDriftIsSavedAndUsedForAFastStart) {
+    std::remove(SAVED);
+    host::imu(IMU_PORT).drift = DRIFT;
+    host::competitionStatus() = COMPETITION_DISABLED;
+    Robot first;
+    // nothing saved, so the sensor is reset and calibrated
+    first.startup.start(true);
+    host::runFor(100);
+    CHECK(!first.startup.isReady());
+    CHECK(host::runUntil([&]() { return first.startup.isReady(); }, 3000));
+    CHECK(!first.startup.usedSavedDrift());
+    // nothing measured yet
+    CHECK(!first.startup.save());
+    // three windows of sitting still while disabled
+    host::runFor(3 * robot::ImuStartup::WINDOW + 200);
+    CHECK_NEAR(first.imu.getDrift(), DRIFT, 1e-3);
+    CHECK(first.startup.save());
+    robot::ImuDriftFile saved = {};
+    FILE* file = std::fopen(SAVED, "rb");
+    CHECK(file != nullptr);
+    if (file != nullptr) {
+        CHECK(std::fread(&saved, sizeof(saved), 1, file) == 1);
+        std::fclose(file);
+    }
+    CHECK_NEAR(saved.drift, DRIFT, 1e-3);
+    CHECK_NEAR(saved.measured, 3 * robot::ImuStartup::WINDOW / 1000.0, 0.5);
+    // the next power on finds the saved drift, keeps the sensor's own calibration and corrects the drift straight away
+    Robot second;
+    second.startup.start(true);
+    CHECK(host::runUntil([&]() { return second.startup.isReady(); }, 50));
+    CHECK(second.startup.usedSavedDrift());
+    CHECK_NEAR(second.imu.getDrift(), DRIFT, 1e-3);
+    const double start = second.imu.get_rotation();
+    host::runFor(10000);
+    // 0.2 degrees uncorrected
+    CHECK_NEAR(second.imu.get_rotation(), start, 0.02);
+    std::remove(SAVED);
+}
+
+int main() { return test::runAll(); }
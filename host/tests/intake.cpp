@@ -0,0 +1,146 @@
+/**
+ * @file host/tests/intake.cpp
+ * @brief Intake edge detection on optical sensor traces, and the intake task's reaction time
+ */
+
+#include "robot/intake.hpp"
+#include "test.hpp"
+
+namespace {
+/**
+ * A trace sample as the sensor sends it, one per device update
+ */
+struct TraceSample {
+        uint32_t time;
+        int32_t proximity;
+        double hue;
+};
+
+// a green triball rolls in, sits against the back of the intake with its proximity wavering, and is outtaken
+const TraceSample GREEN_TRIBALL[] = {
+    {0, 12, 31},    {10, 14, 33},   {20, 48, 88},   {30, 97, 96},   {40, 146, 99},  {50, 171, 101},
+    {60, 188, 100}, {70, 183, 102}, {80, 190, 100}, {90, 176, 101}, {100, 141, 99}, {110, 104, 98},
+    {120, 72, 94},  {130, 30, 52},  {140, 13, 32},
+};
+// a red triball rolls in and is spit back out by itself
+const TraceSample RED_TRIBALL[] = {
+    {0, 11, 30},   {10, 63, 9},   {20, 131, 6},  {30, 168, 4},  {40, 177, 5},
+    {50, 149, 6},  {60, 112, 7},  {70, 84, 9},   {80, 35, 21},  {90, 12, 31},
+};
+// something at the mouth of the intake with its proximity flickering across enterProximity
+const TraceSample FLICKER[] = {
+    {0, 140, 100}, {10, 155, 100}, {20, 145, 100}, {30, 160, 100}, {40, 138, 100}, {50, 152, 100},
+};
+
+/**
+ * Process every sample of a trace and record the power after each
+ */
+template <int N> void replay(robot::Intake& intake, const TraceSample (&trace)[N], int32_t (&powers)[N]) {
+    for (int i = 0; i < N; i++) {
+        powers[i] = intake.process({trace[i].time * 1000ull, trace[i].proximity, trace[i].hue});
+    }
+}
+} // namespace
+
+TEST_CASE(holdsATriballUntilOuttaken) {
+    pros::Motor motor(1);
+    robot::Intake intake(&motor, nullptr);
+    intake.intake();
+    int32_t powers[15];
+    for (int i = 0; i < 15; i++) {
+        // the driver outtakes after the triball has sat in the intake for a while
+        if (i == 9) intake.outtake();
+        const TraceSample& sample = GREEN_TRIBALL[i];
+        powers[i] = intake.process({sample.time * 1000ull, sample.proximity, sample.hue});
+        if (i == 8) CHECK(intake.isHolding());
+    }
+    // runs until the sample where the proximity reaches 150, then holds it until outtaken
+    for (int i = 0; i < 5; i++) CHECK(powers[i] == 127);
+    for (int i = 5; i < 9; i++) CHECK(powers[i] == 0);
+    for (int i = 9; i < 15; i++) CHECK(powers[i] == -127);
+    CHECK(!intake.isHolding());
+    const robot::IntakeStats stats = intake.getStats();
+    CHECK(stats.entries == 1);
+    CHECK(stats.cycles == 1);
+    // in at 50ms, out once the proximity drops below 100 at 120ms
+    CHECK(stats.lastCycleTime == 70);
+}
+
+TEST_CASE(spitsOutAnythingThatIsNotATriball) {
+    pros::Motor motor(1);
+    robot::Intake intake(&motor, nullptr);
+    intake.intake();
+    int32_t powers[10];
+    replay(intake, RED_TRIBALL, powers);
+    for (int i = 0; i < 3; i++) CHECK(powers[i] == 127);
+    for (int i = 3; i < 7; i++) CHECK(powers[i] == -127);
+    // back to intaking once it has left
+    for (int i = 7; i < 10; i++) CHECK(powers[i] == 127);
+    const robot::IntakeStats stats = intake.getStats();
+    CHECK(stats.rejects == 1);
+    CHECK(stats.cycles == 0);
+}
+
+TEST_CASE(flickerAtTheEdgeIsOneEntry) {
+    pros::Motor motor(1);
+    robot::Intake intake(&motor, nullptr);
+    intake.intake();
+    int32_t powers[6];
+    replay(intake, FLICKER, powers);
+    CHECK(powers[0] == 127);
+    for (int i = 1; i < 6; i++) CHECK(powers[i] == 0);
+    CHECK(intake.getStats().entries == 1);
+    CHECK(intake.getStats().exits == 0);
+}
+
+TEST_CASE(hueRangeWrapsThroughZero) {
+    pros::Motor motor(1);
+    robot::IntakeSettings settings;
+    settings.minHue = 340;
+    settings.maxHue = 20;
+    robot::Intake intake(&motor, nullptr, settings);
+    intake.intake();
+    int32_t powers[10];
+    replay(intake, RED_TRIBALL, powers);
+    CHECK(powers[3] == 0);
+    CHECK(intake.getStats().cycles == 1);
+}
+
+TEST_CASE(noSensorRunsLikeAManualIntake) {
+    pros::Motor motor(1);
+    robot::Intake intake(&motor, nullptr);
+    intake.start();
+    intake.intake();
+    host::runFor(50);
+    CHECK(host::motor(1).voltage == 12000);
+    intake.outtake();
+    host::runFor(20);
+    CHECK(host::motor(1).voltage == -12000);
+    intake.stop();
+    host::runFor(20);
+    CHECK(host::motor(1).voltage == 0);
+}
+
+TEST_CASE(taskReadsJustAfterEachDeviceUpdate) {
+    host::deviceUpdatePhase() = 4;
+    pros::Motor motor(1);
+    pros::Optical sensor(2);
+    robot::Intake intake(&motor, &sensor);
+    intake.start();
+    intake.intake();
+    // long enough for the task to move its reads to just after the updates
+    host::runFor(100);
+    CHECK(host::optical(2).integrationTime == robot::Intake::INTEGRATION_TIME);
+    CHECK(host::motor(1).voltage == 12000);
+    // a triball arrives at 105ms. The shim sends every value straight away, so the task sees it at its first read
+    // after that, 1ms after the device update at 114ms
+    host::runUntil([]() { return pros::millis() >= 105; }, 100);
+    host::optical(2).proximity = 200;
+    host::optical(2).hue = 100;
+    const uint32_t arrived = pros::millis();
+    CHECK(host::runUntil([]() { return host::motor(1).voltage == 0; }, 100));
+    CHECK(pros::millis() - arrived <= robot::Intake::DEVICE_PERIOD + robot::Intake::PHASE_TARGET);
+    CHECK(pros::millis() % robot::Intake::DEVICE_PERIOD == 4 + robot::Intake::PHASE_TARGET);
+}
+
+int main() { return test::runAll(); }
@@ -0,0 +1,314 @@
+/**
+ * @file host/tests/motionWorker.cpp
+ * @brief Motion worker wake timing, waiting from several tasks, cancellation and stalls, and each motion driving the
+ * simulated drivetrain to its target
+ */
+
+#include <cmath>
+#include <string>
+#include "lemlib/chassis/odom.hpp"
+#include "lemlib/chassis/trackingWheel.hpp"
+#include "robot/motionWorker.hpp"
+#include "test.hpp"
+
+namespace {
+const lemlib::ControllerSettings LINEAR(10, 30, 1, 100, 3, 500, 20);
+const lemlib::ControllerSettings ANGULAR(2, 10, 1, 100, 3, 500, 20);
+
+/**
+ * A drivetrain of one motor a side, with a motion worker. The pose only moves when a case moves it
+ */
+struct Robot {
+        pros::Motor left {1, pros::E_MOTOR_GEARSET_06};
+        pros::Motor right {2, pros::E_MOTOR_GEARSET_06};
+        pros::MotorGroup leftMotors {{left}};
+        pros::MotorGroup rightMotors {{right}};
+        lemlib::Drivetrain drivetrain {&leftMotors, &rightMotors, 12, 3.25, 360, 8};
+        robot::MotionWorker motions {drivetrain, LINEAR, ANGULAR};
+
+        Robot() {
+            lemlib::setPose(lemlib::Pose(0, 0, 0));
+            motions.start();
+        }
+};
+
+/**
+ * The same drivetrain with odometry tracking its motors, so the motions close the loop through the motor model
+ */
+struct DrivenRobot {
+        pros::Motor left {1, pros::E_MOTOR_GEARSET_06};
+        pros::Motor right {2, pros::E_MOTOR_GEARSET_06};
+        pros::MotorGroup leftMotors {{left}};
+        pros::MotorGroup rightMotors {{right}};
+        lemlib::Drivetrain drivetrain {&leftMotors, &rightMotors, 12, 3.25, 360, 8};
+        lemlib::TrackingWheel leftWheel {&leftMotors, 3.25, -6, 360};
+        lemlib::TrackingWheel rightWheel {&rightMotors, 3.25, 6, 360};
+        robot::MotionWorker motions {drivetrain, LINEAR, ANGULAR};
+        pros::Task odometry {[]() {
+                                 while (true) {
+                                     lemlib::update();
+                                     pros::delay(10);
+                                 }
+                             },
+                             TASK_PRIORITY_MAX};
+
+        DrivenRobot() {
+            // without an inertial sensor, odometry takes the heading from the difference between the sides
+            lemlib::setSensors(lemlib::OdomSensors(&leftWheel, &rightWheel, nullptr, nullptr, nullptr), drivetrain);
+            // the first update takes up whatever the last case left in odometry's previous readings
+            lemlib::update();
+            lemlib::setPose(lemlib::Pose(0, 0, 0));
+            motions.start();
+        }
+
+        /**
+         * Run motions from an autonomous task and wait for them to end
+         *
+         * @return bool - whether they ended within the timeout
+         */
+        bool run(const std::function<void()>& motion, uint32_t timeout) {
+            bool done = false;
+            pros::Task autonomous([&]() {
+                motion();
+                motions.waitUntilDone();
+                done = true;
+            });
+            return host::runUntil([&]() { return done; }, timeout);
+        }
+};
+
+/**
+ * Heading of the robot, from -180 to 180 degrees
+ */
+float heading() { return std::remainder(lemlib::getPose().theta, 360.0f); }
+
+/**
+ * Distance of the robot from a point, in inches
+ */
+float distanceTo(float x, float y) { return std::hypot(lemlib::getPose().x - x, lemlib::getPose().y - y); }
+
+/**
+ * A path asset of waypoints 1 inch apart along a quarter circle of radius 24 from (0, 0) to (24, 24), starting out
+ * along the y axis and ending along the x axis, at a speed of 80 and then 0 at the end
+ */
+asset quarterCircle() {
+    static std::string text;
+    text.clear();
+    const int steps = 38;
+    for (int i = 0; i <= steps; i++) {
+        const float t = M_PI / 2 * i / steps;
+        char line[64];
+        snprintf(line, sizeof(line), "%.3f, %.3f, %d\n", 24 - 24 * std::cos(t), 24 * std::sin(t), i < steps ? 80 : 0);
+        text += line;
+    }
+    text += "endData\n";
+    return {reinterpret_cast<uint8_t*>(text.data()), text.size()};
+}
+} // namespace
+
+TEST_CASE(waitUntilWakesWithinAMillisecondOfTheCrossing) {
+    Robot robot;
+    uint64_t crossed = 0;
+    uint64_t woken = 0;
+    float traveled = 0;
+    // odometry moves the robot an inch every 10ms, 3ms past each device update
+    pros::Task odometry(
+        [&]() {
+            pros::delay(3);
+            uint32_t now = pros::millis();
+            for (int inch = 1; inch <= 20; inch++) {
+                lemlib::setPose(lemlib::Pose(0, inch, 0));
+                if (inch == 6) crossed = pros::micros();
+                pros::Task::delay_until(&now, 10);
+            }
+        },
+        TASK_PRIORITY_MAX);
+    pros::Task autonomous([&]() {
+        robot.motions.moveToPoint(0, 100, 2000);
+        robot.motions.waitUntil(5.5);
+        woken = pros::micros();
+        traveled = lemlib::getPose().y;
+    });
+    host::runUntil([&]() { return woken != 0; }, 1000);
+    CHECK(crossed != 0);
+    CHECK(woken >= crossed);
+    CHECK(woken - crossed <= 1000);
+    CHECK_NEAR(traveled, 6, 1e-6);
+}
+
+TEST_CASE(waitUntilDoneFromASecondTask) {
+    Robot robot;
+    uint64_t woken = 0;
+    bool busy = true;
+    // the pose never moves, so the motion runs for its whole timeout
+    pros::Task autonomous([&]() { robot.motions.moveToPoint(0, 100, 200); });
+    pros::Task watcher([&]() {
+        pros::delay(50);
+        robot.motions.waitUntilDone();
+        woken = pros::micros();
+        busy = robot.motions.isBusy();
+    });
+    host::runUntil([&]() { return woken != 0; }, 1000);
+    CHECK(woken >= 200000);
+    CHECK(woken <= 211000);
+    CHECK(!busy);
+    CHECK(robot.motions.getLastEnd() == robot::MotionEnd::TIMEOUT);
+}
+
+TEST_CASE(cancelEndsTheMotionAtOnce) {
+    Robot robot;
+    uint64_t took = UINT64_MAX;
+    bool cancelled = false;
+    pros::Task first([&]() { robot.motions.moveToPoint(0, 100, 5000); });
+    pros::Task second([&]() {
+        pros::delay(10);
+        robot.motions.moveToPoint(0, 100, 5000);
+    });
+    host::runFor(100);
+    CHECK(host::motor(1).voltage > 0);
+    pros::Task canceller([&]() {
+        const uint64_t start = pros::micros();
+        cancelled = robot.motions.cancelMotion();
+        took = pros::micros() - start;
+    });
+    host::runFor(1);
+    CHECK(cancelled);
+    CHECK(took < 1000);
+    CHECK(robot.motions.getLastEnd() == robot::MotionEnd::CANCELLED);
+    // the second motion took over without a pause
+    CHECK(robot.motions.getStats().motions == 2);
+    CHECK(robot.motions.isBusy());
+    int count = -1;
+    pros::Task cancelAll([&]() { count = robot.motions.cancelAllMotions(); });
+    host::runFor(1);
+    CHECK(count == 1);
+    CHECK(!robot.motions.isBusy());
+    CHECK(host::motor(1).voltage == 0);
+    CHECK(host::motor(2).voltage == 0);
+}
+
+TEST_CASE(stallEndsTheMotion) {
+    Robot robot;
+    robot.motions.setStallDetection({30, 1800, 200, 300});
+    // the robot is against a wall, so the motors draw full current without turning
+    pros::Task wall(
+        [&]() {
+            while (true) {
+                host::motor(1).velocity = 0;
+                host::motor(2).velocity = 0;
+                pros::delay(1);
+            }
+        },
+        TASK_PRIORITY_MAX);
+    pros::Task autonomous([&]() { robot.motions.moveToPoint(0, 100, 5000); });
+    CHECK(host::runUntil([&]() { return pros::millis() > 10 && !robot.motions.isBusy(); }, 2000));
+    CHECK(robot.motions.getLastEnd() == robot::MotionEnd::STALLED);
+    // 300ms of grace, then 200ms stalled, checked every 10ms
+    CHECK(pros::millis() >= 500);
+    CHECK(pros::millis() <= 520);
+    CHECK(host::motor(1).voltage == 0);
+}
+
+TEST_CASE(timeoutRunsOnTheWorkersClock) {
+    robot::ManualClock clock;
+    pros::Motor left(1, pros::E_MOTOR_GEARSET_06);
+    pros::Motor right(2, pros::E_MOTOR_GEARSET_06);
+    pros::MotorGroup leftMotors({left});
+    pros::MotorGroup rightMotors({right});
+    lemlib::Drivetrain drivetrain(&leftMotors, &rightMotors, 12, 3.25, 360, 8);
+    robot::MotionWorker motions(drivetrain, LINEAR, ANGULAR, clock);
+    lemlib::setPose(lemlib::Pose(0, 0, 0));
+    motions.start();
+    pros::Task autonomous([&]() { motions.moveToPoint(0, 100, 200); });
+    // the worker's clock stands still, so the motion runs on however long the scheduler runs
+    host::runFor(500);
+    CHECK(motions.isBusy());
+    clock.advance(199000);
+    host::runFor(20);
+    CHECK(motions.isBusy());
+    clock.advance(1000);
+    CHECK(host::runUntil([&]() { return !motions.isBusy(); }, 20));
+    CHECK(motions.getLastEnd() == robot::MotionEnd::TIMEOUT);
+}
+
+TEST_CASE(turnToSettlesOnTheHeading) {
+    DrivenRobot robot;
+    CHECK(robot.run([&]() { robot.motions.turnTo(24, 24, 2000); }, 2100));
+    CHECK(robot.motions.getLastEnd() == robot::MotionEnd::SETTLED);
+    CHECK_NEAR(heading(), 45, 3);
+    // backwards turns the back of the robot to the point
+    CHECK(robot.run([&]() { robot.motions.turnTo(24, 24, 2000, false); }, 2100));
+    CHECK(robot.motions.getLastEnd() == robot::MotionEnd::SETTLED);
+    CHECK_NEAR(heading(), -135, 3);
+    // turning in place
+    CHECK(distanceTo(0, 0) < 1);
+}
+
+TEST_CASE(moveToPointReachesTheTarget) {
+    DrivenRobot robot;
+    CHECK(robot.run([&]() { robot.motions.moveToPoint(12, 36, 3000); }, 3100));
+    CHECK(robot.motions.getLastEnd() == robot::MotionEnd::SETTLED);
+    CHECK(distanceTo(12, 36) < 2);
+    // backwards drives the back of the robot to the target, so it ends facing away from it
+    CHECK(robot.run([&]() { robot.motions.moveToPoint(12, 0, 3000, false); }, 3100));
+    CHECK(robot.motions.getLastEnd() == robot::MotionEnd::SETTLED);
+    CHECK(distanceTo(12, 0) < 2);
+    CHECK(std::fabs(heading()) < 30);
+}
+
+TEST_CASE(moveToPoseReachesTheTargetPose) {
+    DrivenRobot robot;
+    CHECK(robot.run([&]() { robot.motions.moveToPose(24, 36, 90, 4000); }, 4100));
+    CHECK(robot.motions.getLastEnd() == robot::MotionEnd::SETTLED);
+    CHECK(distanceTo(24, 36) < 2);
+    CHECK_NEAR(heading(), 90, 10);
+    // backwards ends with the robot facing the target heading, having backed onto it
+    CHECK(robot.run([&]() { robot.motions.moveToPose(0, 12, 0, 4000, false); }, 4100));
+    CHECK(robot.motions.getLastEnd() == robot::MotionEnd::SETTLED);
+    CHECK(distanceTo(0, 12) < 2);
+    CHECK_NEAR(heading(), 0, 10);
+}
+
+TEST_CASE(followEndsAtTheEndOfThePath) {
+    DrivenRobot robot;
+    static const asset path = quarterCircle();
+    float furthest = 0;
+    pros::Task watcher([&]() {
+        // how far the robot strays from the arc while following it
+        while (true) {
+            const lemlib::Pose pose = lemlib::getPose();
+            furthest = std::max(furthest, std::fabs(std::hypot(pose.x - 24, pose.y) - 24));
+            pros::delay(10);
+        }
+    });
+    CHECK(robot.run([&]() { robot.motions.follow(path, 10, 5000); }, 5100));
+    CHECK(robot.motions.getLastEnd() == robot::MotionEnd::SETTLED);
+    CHECK(distanceTo(24, 24) < 3);
+    CHECK_NEAR(heading(), 90, 15);
+    CHECK(furthest < 3);
+}
+
+TEST_CASE(newGainsReachTheRunningMotion) {
+    DrivenRobot robot;
+    // no gains, so the turn doesn't move
+    lemlib::ControllerSettings idle = ANGULAR;
+    idle.kP = 0;
+    idle.kD = 0;
+    robot.motions.setControllerSettings(LINEAR, idle, 12);
+    bool done = false;
+    pros::Task autonomous([&]() {
+        robot.motions.turnTo(24, 24, 3000);
+        robot.motions.waitUntilDone();
+        done = true;
+    });
+    host::runFor(500);
+    CHECK(std::fabs(heading()) < 0.1);
+    // the tuned gains arrive mid motion, and the same turn settles with them
+    robot.motions.setControllerSettings(LINEAR, ANGULAR, 12);
+    CHECK(host::runUntil([&]() { return done; }, 2000));
+    CHECK(robot.motions.getStats().motions == 1);
+    CHECK(robot.motions.getLastEnd() == robot::MotionEnd::SETTLED);
+    CHECK_NEAR(heading(), 45, 3);
+}
+
+int main() { return test::runAll(); }
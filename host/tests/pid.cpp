@@ -0,0 +1,71 @@
+/**
+ * @file host/tests/pid.cpp
+ * @brief Pid and DeltaTimer on a manual clock with uneven time between updates
+ */
+
+#include "robot/pid.hpp"
+#include "test.hpp"
+
+TEST_CASE(deltaTimerMeasuresEachInterval) {
+    robot::ManualClock clock(5000);
+    robot::DeltaTimer timer(clock);
+    CHECK(timer.update() == 0);
+    clock.advance(9700);
+    CHECK_NEAR(timer.update(), 0.0097, 1e-7);
+    clock.advance(12400);
+    CHECK_NEAR(timer.update(), 0.0124, 1e-7);
+    CHECK(timer.getLast() == 5000 + 9700 + 12400);
+    timer.reset();
+    clock.advance(10000);
+    CHECK(timer.update() == 0);
+}
+
+TEST_CASE(derivativeDividesByTheMeasuredDt) {
+    robot::ManualClock clock;
+    robot::Pid pid(0, 0, 1, 0, false, clock);
+    // no earlier error, so no derivative
+    CHECK(pid.update(10) == 0);
+    // the same change in error over a short and a long interval, as a 10ms loop woken early and late sees it
+    clock.advance(8600);
+    CHECK_NEAR(pid.update(9), -1 / 0.0086, 1e-2);
+    clock.advance(11400);
+    CHECK_NEAR(pid.update(8), -1 / 0.0114, 1e-2);
+    // a constant rate of change reads the same at any interval
+    clock.advance(3000);
+    const float fast = pid.update(7.7f);
+    clock.advance(17000);
+    const float slow = pid.update(6);
+    CHECK_NEAR(fast, -100, 1e-2);
+    CHECK_NEAR(slow, -100, 1e-2);
+}
+
+TEST_CASE(integralWeightsEachErrorByItsInterval) {
+    robot::ManualClock clock;
+    robot::Pid pid(0, 1, 0, 0, false, clock);
+    pid.update(4);
+    const uint64_t intervals[] = {9000, 13000, 7000, 11000};
+    float expected = 0;
+    for (uint64_t interval : intervals) {
+        clock.advance(interval);
+        pid.update(4);
+        expected += 4 * interval * 1e-6f;
+    }
+    // 40ms of an error of 4, however the updates were spread
+    CHECK_NEAR(expected, 0.16, 1e-6);
+    CHECK_NEAR(pid.getIntegral(), expected, 1e-6);
+}
+
+TEST_CASE(sameMicrosecondKeepsTheLastDerivative) {
+    robot::ManualClock clock;
+    robot::Pid pid(0, 1, 1, 0, false, clock);
+    pid.update(10);
+    clock.advance(10000);
+    pid.update(9);
+    const float derivative = pid.getDerivative();
+    const float integral = pid.getIntegral();
+    pid.update(3);
+    CHECK(pid.getDerivative() == derivative);
+    CHECK(pid.getIntegral() == integral);
+}
+
+int main() { return test::runAll(); }
@@ -0,0 +1,184 @@
+/**
+ * @file host/tests/rtos.cpp
+ * @brief Host scheduler: priority preemption, mutex hand-off and inheritance, notifications, delay_until, and the
+ * mutexes of deleted tasks
+ */
+
+#include <string>
+#include "pros/rtos.hpp"
+#include "test.hpp"
+
+TEST_CASE(higherPriorityTasksPreemptOnTheSpot) {
+    std::string order;
+    pros::Task low([&]() {
+        order += 'a';
+        // starting a higher priority task runs it before create() returns
+        pros::Task high(
+            [&]() {
+                order += 'b';
+                pros::c::task_notify_take(true, TIMEOUT_MAX);
+                order += 'd';
+            },
+            TASK_PRIORITY_DEFAULT + 1);
+        order += 'c';
+        // and so does waking it
+        high.notify();
+        order += 'e';
+    });
+    host::runFor(1);
+    CHECK(order == "abcde");
+    // of the tasks ready at once, the highest priority one runs first whatever order they were started in
+    order.clear();
+    pros::Task first([&]() { order += 'l'; });
+    pros::Task second([&]() { order += 'h'; }, TASK_PRIORITY_DEFAULT + 1);
+    host::runFor(1);
+    CHECK(order == "hl");
+}
+
+TEST_CASE(mutexesGoToTheHighestPriorityWaiter) {
+    pros::Mutex mutex;
+    std::string order;
+    uint32_t ownerPriority = 0;
+    pros::Task owner([&]() {
+        mutex.take();
+        pros::delay(10);
+        // inherits the priority of the highest task waiting
+        ownerPriority = pros::Task::current().get_priority();
+        order += 'o';
+        mutex.give();
+        order += 'r';
+    });
+    host::runFor(1);
+    pros::Task middle(
+        [&]() {
+            mutex.take();
+            order += 'm';
+            mutex.give();
+        },
+        TASK_PRIORITY_DEFAULT + 1);
+    pros::Task high(
+        [&]() {
+            mutex.take();
+            order += 'h';
+            mutex.give();
+        },
+        TASK_PRIORITY_DEFAULT + 2);
+    host::runFor(20);
+    CHECK(ownerPriority == TASK_PRIORITY_DEFAULT + 2);
+    // giving it up hands it to the highest priority waiter at once, and drops the owner back to its own priority
+    CHECK(order == "ohmr");
+    CHECK(owner.get_priority() == TASK_PRIORITY_DEFAULT);
+    // a take that times out leaves the mutex with its owner
+    bool timedOut = false;
+    bool release = false;
+    pros::Task holder([&]() {
+        mutex.take();
+        while (!release) pros::delay(1);
+        mutex.give();
+    });
+    host::runFor(1);
+    pros::Task waiter([&]() { timedOut = !mutex.take(5); });
+    host::runFor(10);
+    CHECK(timedOut);
+    CHECK(!mutex.try_lock());
+    release = true;
+    host::runFor(5);
+}
+
+TEST_CASE(notificationsWakeAndCount) {
+    uint32_t taken = 0;
+    uint32_t wokeAt = 0;
+    pros::Task waiter([&]() {
+        taken = pros::c::task_notify_take(false, TIMEOUT_MAX);
+        wokeAt = pros::millis();
+    });
+    host::runFor(10);
+    CHECK(taken == 0);
+    waiter.notify();
+    host::runFor(1);
+    CHECK(taken == 1);
+    CHECK(wokeAt == 10);
+    // notifications sent before the take are counted, and cleared or taken one at a time
+    uint32_t values[3] = {};
+    bool go = false;
+    pros::Task counter([&]() {
+        while (!go) pros::delay(1);
+        values[0] = pros::c::task_notify_take(false, 0);
+        values[1] = pros::c::task_notify_take(true, 0);
+        values[2] = pros::c::task_notify_take(true, 5);
+    });
+    host::runFor(1);
+    counter.notify();
+    counter.notify();
+    counter.notify();
+    go = true;
+    host::runFor(10);
+    CHECK(values[0] == 3);
+    CHECK(values[1] == 2);
+    // nothing left, so the take times out
+    CHECK(values[2] == 0);
+    // bits are merged, and a value that isn't overwritten is kept
+    pros::Task bits([&]() { pros::delay(100); });
+    bits.notify_ext(1, pros::E_NOTIFY_ACTION_BITS, nullptr);
+    bits.notify_ext(4, pros::E_NOTIFY_ACTION_BITS, nullptr);
+    uint32_t previous = 0;
+    CHECK(bits.notify_ext(2, pros::E_NOTIFY_ACTION_NO_OWRITE, &previous) == 0);
+    CHECK(previous == 5);
+    host::runFor(105);
+}
+
+TEST_CASE(delayUntilKeepsAFixedPeriod) {
+    uint32_t wakes[5] = {};
+    pros::Task loop([&]() {
+        uint32_t previous = pros::millis();
+        for (int i = 0; i < 5; i++) {
+            // work that takes a varying time doesn't move the period
+            pros::delay(i);
+            pros::Task::delay_until(&previous, 10);
+            wakes[i] = pros::millis();
+        }
+    });
+    host::runFor(60);
+    for (int i = 0; i < 5; i++) CHECK(wakes[i] == 10 * (i + 1u));
+    // a loop that ran late catches up without blocking
+    uint32_t late[3] = {};
+    pros::Task catchUp([&]() {
+        uint32_t previous = pros::millis();
+        pros::delay(25);
+        for (int i = 0; i < 3; i++) {
+            pros::Task::delay_until(&previous, 10);
+            late[i] = pros::millis();
+        }
+    });
+    host::runFor(40);
+    CHECK(late[0] == 85);
+    CHECK(late[1] == 85);
+    CHECK(late[2] == 90);
+}
+
+TEST_CASE(deletedTasksGiveUpTheirMutexes) {
+    pros::Mutex mutex;
+    pros::Mutex returned;
+    pros::Task owner([&]() {
+        mutex.take();
+        pros::delay(1000);
+    });
+    pros::Task quitter([&]() { returned.take(); });
+    host::runFor(1);
+    bool got = false;
+    pros::Task waiter([&]() {
+        got = mutex.take();
+        mutex.give();
+    });
+    host::runFor(5);
+    CHECK(!got);
+    // deleting the owner hands the mutex to the task waiting for it
+    owner.remove();
+    host::runFor(1);
+    CHECK(got);
+    // a task that returned holds nothing either
+    CHECK(returned.try_lock());
+    returned.give();
+}
+
+int main() { return test::runAll(); }
@@ -0,0 +1,89 @@
+/**
+ * @file host/tests/sdLogger.cpp
+ * @brief SD logger file layout: a header sector, then whole blocks however full they were when written
+ */
+
+#include <cstdio>
+#include <cstring>
+#include <vector>
+#include "robot/sdLogger.hpp"
+#include "test.hpp"
+
+namespace {
+const char* const PREFIX = "/tmp/robot-sd-test";
+const char* const FIRST_FILE = "/tmp/robot-sd-test000.bin";
+
+/**
+ * The size of the robot's drive records, which don't divide the block evenly
+ */
+struct Record {
+        uint32_t time;
+        float x;
+        float y;
+        float theta;
+        int16_t leftY;
+        int16_t rightY;
+};
+
+std::vector<uint8_t> readFile(const char* path) {
+    std::vector<uint8_t> data;
+    FILE* file = std::fopen(path, "rb");
+    if (file == nullptr) return data;
+    for (int c = std::fgetc(file); c != EOF; c = std::fgetc(file)) data.push_back(static_cast<uint8_t>(c));
+    std::fclose(file);
+    return data;
+}
+
+bool allZero(const uint8_t* data, size_t size) {
+    for (size_t i = 0; i < size; i++) {
+        if (data[i] != 0) return false;
+    }
+    return true;
+}
+} // namespace
+
+TEST_CASE(writesAHeaderSectorThenWholeBlocks) {
+    using robot::SdLogger;
+    std::remove(FIRST_FILE);
+    SdLogger logger(PREFIX, sizeof(Record));
+    CHECK(logger.start());
+    // a block and a half, then a sync closes the half full block
+    const uint32_t perBlock = (SdLogger::BLOCK_SIZE - sizeof(robot::LogBlockHeader)) / sizeof(Record);
+    const uint32_t count = perBlock * 3 / 2;
+    for (uint32_t i = 0; i < count; i++) {
+        CHECK(logger.log(Record {i, 1, 2, 3, 4, 5}));
+        if (i == perBlock) host::runFor(30);
+    }
+    logger.sync();
+    CHECK(host::runUntil([&]() { return logger.getWritten() == count; }, 1000));
+    CHECK(logger.getDropped() == 0);
+    const std::vector<uint8_t> data = readFile(FIRST_FILE);
+    CHECK(data.size() == SdLogger::SECTOR_SIZE + 2 * SdLogger::BLOCK_SIZE);
+    if (data.size() != SdLogger::SECTOR_SIZE + 2 * SdLogger::BLOCK_SIZE) return;
+    robot::LogFileHeader header;
+    std::memcpy(&header, data.data(), sizeof(header));
+    CHECK(std::memcmp(header.magic, "RLOG", 4) == 0);
+    CHECK(header.version == robot::LOG_VERSION);
+    CHECK(header.recordSize == sizeof(Record));
+    CHECK(allZero(data.data() + sizeof(header), SdLogger::SECTOR_SIZE - sizeof(header)));
+    // each block gives its record count, and is padded with zeros after its last record
+    uint32_t next = 0;
+    for (uint32_t block = 0; block < 2; block++) {
+        const uint8_t* start = data.data() + SdLogger::SECTOR_SIZE + block * SdLogger::BLOCK_SIZE;
+        robot::LogBlockHeader blockHeader;
+        std::memcpy(&blockHeader, start, sizeof(blockHeader));
+        CHECK(blockHeader.block == block);
+        CHECK(blockHeader.records == (block == 0 ? perBlock : count - perBlock));
+        for (uint32_t i = 0; i < blockHeader.records && i < perBlock; i++) {
+            Record record;
+            std::memcpy(&record, start + sizeof(blockHeader) + i * sizeof(Record), sizeof(record));
+            CHECK(record.time == next++);
+        }
+        const size_t used = sizeof(blockHeader) + blockHeader.records * sizeof(Record);
+        if (used <= SdLogger::BLOCK_SIZE) CHECK(allZero(start + used, SdLogger::BLOCK_SIZE - used));
+    }
+    CHECK(next == count);
+    std::remove(FIRST_FILE);
+}
+
+int main() { return test::runAll(); }
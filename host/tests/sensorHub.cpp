@@ -0,0 +1,91 @@
+/**
+ * @file host/tests/sensorHub.cpp
+ * @brief Sensor hub reads: only the values registered, and only while someone reads the snapshots
+ */
+
+#include "robot/sensorHub.hpp"
+#include "test.hpp"
+
+namespace {
+using robot::SensorHub;
+
+/**
+ * The devices of the robot's driver control, registered with what opcontrol reads or with everything
+ */
+struct Devices {
+        pros::Motor drive {1};
+        pros::Rotation cata {16};
+        pros::Controller controller {pros::E_CONTROLLER_MASTER};
+        SensorHub hub;
+        int cataRotation;
+
+        explicit Devices(bool everything) {
+            if (everything) {
+                cataRotation = hub.addRotation(&cata);
+                hub.setPhaseReference(hub.addMotor(&drive));
+                hub.setController(&controller);
+                return;
+            }
+            cataRotation = hub.addRotation(&cata, robot::RotationSnapshot::ANGLE);
+            hub.setPhaseReference(hub.addMotor(&drive, robot::MotorSnapshot::RAW_POSITION));
+            hub.setController(&controller,
+                              SensorHub::axis(pros::E_CONTROLLER_ANALOG_LEFT_Y) |
+                                  SensorHub::axis(pros::E_CONTROLLER_ANALOG_RIGHT_Y),
+                              SensorHub::button(pros::E_CONTROLLER_DIGITAL_A) |
+                                  SensorHub::button(pros::E_CONTROLLER_DIGITAL_B) |
+                                  SensorHub::button(pros::E_CONTROLLER_DIGITAL_R2) |
+                                  SensorHub::button(pros::E_CONTROLLER_DIGITAL_L1) |
+                                  SensorHub::button(pros::E_CONTROLLER_DIGITAL_L2));
+        }
+};
+} // namespace
+
+TEST_CASE(readsOnlyTheRegisteredValues) {
+    Devices all(true);
+    Devices used(false);
+    // a motor's 4 values, a rotation sensor's 3, and 4 joysticks and 12 buttons
+    CHECK(all.hub.getReadsPerSnapshot() == 23);
+    // the reference motor's raw position, the cata angle, 2 joysticks and 5 buttons
+    CHECK(used.hub.getReadsPerSnapshot() == 9);
+    host::controller(pros::E_CONTROLLER_MASTER).analog[pros::E_CONTROLLER_ANALOG_LEFT_Y] = 90;
+    host::controller(pros::E_CONTROLLER_MASTER).analog[pros::E_CONTROLLER_ANALOG_LEFT_X] = 40;
+    host::controller(pros::E_CONTROLLER_MASTER).digital[pros::E_CONTROLLER_DIGITAL_R2] = true;
+    host::controller(pros::E_CONTROLLER_MASTER).digital[pros::E_CONTROLLER_DIGITAL_X] = true;
+    host::rotation(16).position = 48000;
+    used.hub.update();
+    const robot::SensorSnapshot snapshot = used.hub.get();
+    CHECK(snapshot.analog[pros::E_CONTROLLER_ANALOG_LEFT_Y] == 90);
+    CHECK(snapshot.pressed(pros::E_CONTROLLER_DIGITAL_R2));
+    CHECK(snapshot.rotations[used.cataRotation].angle == 12000);
+    // not registered, so never read
+    CHECK(snapshot.analog[pros::E_CONTROLLER_ANALOG_LEFT_X] == 0);
+    CHECK(!snapshot.pressed(pros::E_CONTROLLER_DIGITAL_X));
+    CHECK(used.hub.getTotalReads() == 9);
+}
+
+TEST_CASE(stopsReadingWhileNobodyReadsTheSnapshots) {
+    Devices used(false);
+    used.hub.start();
+    // a driver control loop reading every snapshot for 200ms
+    bool driving = true;
+    pros::Task opcontrol([&]() {
+        uint32_t sequence = 0;
+        while (driving) sequence = used.hub.waitForUpdate(sequence).sequence;
+    });
+    host::runFor(200);
+    driving = false;
+    const uint32_t driven = used.hub.getTotalReads();
+    // the first snapshot from start(), then one every period
+    CHECK(driven >= 9 * 20);
+    CHECK(driven <= 9 * 22);
+    // nobody reads for a second, so the hub reads only until IDLE_TIME has passed
+    host::runFor(1000);
+    const uint32_t idle = used.hub.getTotalReads() - driven;
+    CHECK(idle <= 9 * (SensorHub::IDLE_TIME / SensorHub::PERIOD + 1));
+    // the next request brings it back within a period
+    const uint32_t sequence = used.hub.get().sequence;
+    host::runFor(SensorHub::PERIOD + 1);
+    CHECK(used.hub.get().sequence > sequence);
+}
+
+int main() { return test::runAll(); }
@@ -0,0 +1,55 @@
+/**
+ * @file host/tests/tasks.cpp
+ * @brief Task registry adoption: tasks a function creates get their configured priority, unless they can't be listed
+ */
+
+#include "robot/tasks.hpp"
+#include "test.hpp"
+
+namespace {
+/**
+ * Start a task at the default priority that waits until told to end, as LemLib starts its tasks
+ */
+pros::task_t idle(const bool& done) {
+    return pros::Task::create([&done]() {
+        while (!done) pros::delay(1);
+    });
+}
+} // namespace
+
+TEST_CASE(adoptsTheTasksAFunctionCreates) {
+    bool done = false;
+    const pros::task_t before = idle(done);
+    pros::task_t created = nullptr;
+    CHECK(robot::tasks::adopt("lemlib odom", [&]() { created = idle(done); }) == 1);
+    CHECK(pros::c::task_get_priority(created) == robot::tasks::PRIORITY_CONTROL);
+    CHECK(pros::c::task_get_priority(before) == TASK_PRIORITY_DEFAULT);
+    done = true;
+    host::runFor(5);
+}
+
+TEST_CASE(adoptsNothingWhenTasksCantBeListed) {
+    // one more task than adopt() can list
+    bool done = false;
+    bool firstDone = false;
+    idle(firstDone);
+    idle(firstDone);
+    for (int i = 0; i < robot::tasks::MAX_TASKS * 2 - 1; i++) idle(done);
+    // two tasks end while the function runs, so the tasks can be listed afterwards. Which are new still isn't known
+    pros::task_t created = nullptr;
+    CHECK(robot::tasks::adopt("lemlib odom", [&]() {
+        firstDone = true;
+        pros::delay(5);
+        created = idle(done);
+    }) == 0);
+    CHECK(created != nullptr);
+    CHECK(pros::c::task_get_priority(created) == TASK_PRIORITY_DEFAULT);
+    // listed before the function runs, but not after, since its task pushes the count over
+    pros::task_t over = nullptr;
+    CHECK(robot::tasks::adopt("lemlib odom", [&]() { over = idle(done); }) == 0);
+    CHECK(pros::c::task_get_priority(over) == TASK_PRIORITY_DEFAULT);
+    done = true;
+    host::runFor(5);
+}
+
+int main() { return test::runAll(); }
@@ -0,0 +1,94 @@
+/**
+ * @file host/tests/test.hpp
+ * @brief Minimal test harness for the host tests
+ *
+ * Each file in tests/ is one program. TEST_CASE registers a function, CHECK and CHECK_NEAR record failures without
+ * stopping the case, and the program's main returns test::runAll(), which runs every case after a host::reset() and
+ * returns non-zero if any check failed. make test builds and runs them all.
+ *
+ * <h3> Example Usage </h3>
+ * @code
+ * TEST_CASE(addsUp) {
+ *     CHECK(1 + 1 == 2);
+ *     CHECK_NEAR(0.1 + 0.2, 0.3, 1e-9);
+ * }
+ *
+ * int main() { return test::runAll(); }
+ * @endcode
+ */
+
+#pragma once
+
+#include <cmath>
+#include <cstdio>
+#include "host/sim.hpp"
+
+namespace test {
+struct Case {
+        const char* name;
+        void (*run)();
+        Case* next;
+};
+
+inline Case*& cases() {
+    static Case* first = nullptr;
+    return first;
+}
+
+inline int& failures() {
+    static int count = 0;
+    return count;
+}
+
+struct Registrar {
+        Registrar(Case& entry) {
+            // keep the cases in the order they appear in the file
+            Case** last = &cases();
+            while (*last != nullptr) last = &(*last)->next;
+            *last = &entry;
+        }
+};
+
+inline void check(bool passed, const char* expression, const char* file, int line) {
+    if (passed) return;
+    failures()++;
+    printf("%s:%d: check failed: %s\n", file, line, expression);
+}
+
+inline void checkNear(double actual, double expected, double tolerance, const char* expression, const char* file,
+                      int line) {
+    if (std::fabs(actual - expected) <= tolerance) return;
+    failures()++;
+    printf("%s:%d: check failed: %s, %g is not within %g of %g\n", file, line, expression, actual, tolerance,
+           expected);
+}
+
+/**
+ * @brief Run every registered case
+ *
+ * @return int - 0 if every check passed, 1 otherwise
+ */
+inline int runAll() {
+    int count = 0;
+    for (Case* entry = cases(); entry != nullptr; entry = entry->next) {
+        host::reset();
+        const int before = failures();
+        entry->run();
+        printf("%s %s\n", failures() == before ? "pass" : "FAIL", entry->name);
+        count++;
+    }
+    printf("%d cases, %d failed checks\n", count, failures());
+    return failures() == 0 ? 0 : 1;
+}
+} // namespace test
+
+#define TEST_CASE(name)                                                                                                \
+    static void name();                                                                                                \
+    static test::Case name##Case {#name, name, nullptr};                                                               \
+    static test::Registrar name##Registrar(name##Case);                                                                \
+    static void name()
+
+#define CHECK(expression) test::check(static_cast<bool>(expression), #expression, __FILE__, __LINE__)
+
+#define CHECK_NEAR(actual, expected, tolerance)                                                                        \
+    test::checkNear(actual, expected, tolerance, #actual " near " #expected, __FILE__, __LINE__)
@@ -0,0 +1,134 @@
+/**
+ * @file host/tests/trace.cpp
+ * @brief Trace rings of deleted tasks are named in dumps and then reused, and rings are kept while tasks can't be listed
+ *
+ * Built with ROBOT_TRACE and its own copy of the tracer, see the Makefile
+ */
+
+#include <cstring>
+#include <string>
+#include <vector>
+#include "pros/rtos.hpp"
+#include "robot/trace.hpp"
+#include "test.hpp"
+
+namespace {
+const char* const DUMP = "/tmp/robot-trace-test.bin";
+
+/**
+ * The task names of the rings in a dump, in ring order
+ */
+std::vector<std::string> ringNames(const char* path) {
+    std::vector<std::string> names;
+    FILE* file = fopen(path, "rb");
+    if (file == nullptr) return names;
+    char header[8];
+    uint16_t count = 0;
+    if (fread(header, 1, sizeof(header), file) == sizeof(header) && fread(&count, sizeof(count), 1, file) == 1) {
+        // the event names come first, then one task name per ring
+        for (int i = 0; i < count + header[6]; i++) {
+            std::string name;
+            for (int c = fgetc(file); c > 0; c = fgetc(file)) name += static_cast<char>(c);
+            if (i >= count) names.push_back(name);
+        }
+    }
+    fclose(file);
+    return names;
+}
+
+/**
+ * Start a task that records a counter, then waits until told to end
+ */
+pros::task_t recorder(const char* name, const bool& done) {
+    return pros::Task::create(
+        [&done]() {
+            TRACE_COUNTER("trace test", 1);
+            while (!done) pros::delay(1);
+        },
+        name);
+}
+} // namespace
+
+// runs first, while every ring is free, and frees them all again at the end
+TEST_CASE(ringsAreKeptWhileTasksCantBeListed) {
+    using robot::trace::MAX_RINGS;
+    // alive throughout, so the tracer can list tasks once the others have ended
+    bool keeperDone = false;
+    pros::Task keeper([&keeperDone]() {
+        while (!keeperDone) pros::delay(1);
+    });
+    bool done = false;
+    for (int i = 0; i < MAX_RINGS; i++) recorder("live", done);
+    host::runFor(5);
+    // the events are dumped, so the rings are empty but their tasks are alive
+    CHECK(robot::trace::dumpToFile(DUMP));
+    // more tasks than the tracer can list, so FreeRTOS lists none
+    bool idleDone = false;
+    for (int i = 0; i < 32; i++) {
+        pros::Task::create(
+            [&idleDone]() {
+                while (!idleDone) pros::delay(1);
+            },
+            "idle");
+    }
+    const uint32_t dropped = robot::trace::getDropped();
+    bool lateDone = false;
+    recorder("late", lateDone);
+    host::runFor(5);
+    // no ring was taken from a live task
+    CHECK(robot::trace::getDropped() == dropped + 1);
+    lateDone = true;
+    CHECK(robot::trace::dumpToFile(DUMP));
+    const std::vector<std::string> dumped = ringNames(DUMP);
+    CHECK(dumped.size() == static_cast<size_t>(MAX_RINGS));
+    for (const std::string& name : dumped) CHECK(name == "live");
+    // with the tasks listed again, the dump releases the rings of the ended tasks
+    idleDone = true;
+    done = true;
+    host::runFor(5);
+    CHECK(robot::trace::dumpToFile(DUMP));
+    keeperDone = true;
+    host::runFor(5);
+    remove(DUMP);
+}
+
+TEST_CASE(ringsOfDeletedTasksAreReused) {
+    using robot::trace::MAX_RINGS;
+    bool done = false;
+    char names[MAX_RINGS][16];
+    for (int i = 0; i < MAX_RINGS; i++) {
+        snprintf(names[i], sizeof(names[i]), "first %d", i);
+        recorder(names[i], done);
+    }
+    host::runFor(5);
+    // every ring is held by a live task
+    const uint32_t dropped = robot::trace::getDropped();
+    bool lateDone = false;
+    recorder("late", lateDone);
+    host::runFor(5);
+    CHECK(robot::trace::getDropped() == dropped + 1);
+    lateDone = true;
+    // the tasks end with their events still in their rings, which keep them until they are dumped
+    done = true;
+    host::runFor(5);
+    CHECK(robot::trace::dumpToFile(DUMP));
+    const std::vector<std::string> dumped = ringNames(DUMP);
+    CHECK(dumped.size() == static_cast<size_t>(MAX_RINGS));
+    for (int i = 0; i < MAX_RINGS && i < static_cast<int>(dumped.size()); i++) CHECK(dumped[i] == names[i]);
+    // the dump released the rings, so a new set of tasks records without dropping anything
+    bool secondDone = false;
+    for (int i = 0; i < MAX_RINGS; i++) recorder("second", secondDone);
+    host::runFor(5);
+    CHECK(robot::trace::getDropped() == dropped + 1);
+    // dumped while the tasks are alive, so they keep their rings, and then they end
+    CHECK(robot::trace::dumpToFile(DUMP));
+    secondDone = true;
+    host::runFor(5);
+    // their rings are empty, so they are released as soon as another task needs one
+    for (int i = 0; i < MAX_RINGS; i++) recorder("third", secondDone);
+    host::runFor(5);
+    CHECK(robot::trace::getDropped() == dropped + 1);
+    remove(DUMP);
+}
+
+int main() { return test::runAll(); }
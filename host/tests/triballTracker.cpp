@@ -0,0 +1,228 @@
+/**
+ * @file host/tests/triballTracker.cpp
+ * @brief Triball tracking on recorded frames: projection, association, confirmation, expiry, and driving to the
+ * nearest triball
+ *
+ * The frames are built from triballs at known field positions, seen from poses given to recordPose(), by running the
+ * camera projection backwards and rounding to whole pixels as the sensor does
+ */
+
+#include <cmath>
+#include "lemlib/chassis/odom.hpp"
+#include "lemlib/chassis/trackingWheel.hpp"
+#include "robot/motionWorker.hpp"
+#include "robot/triballTracker.hpp"
+#include "test.hpp"
+
+namespace {
+constexpr uint32_t SIGNATURE = 1;
+// 6 inches ahead of the tracking center, 10 inches up and tilted 20 degrees down
+const robot::CameraMount MOUNT = {6, 0, 10, 20};
+constexpr float TRIBALL_RADIUS = 3.5;
+constexpr float DEG_TO_RAD = M_PI / 180;
+// the vision task's period, in microseconds
+constexpr uint64_t FRAME = 20000;
+
+/**
+ * The box the sensor reports for a triball, or a box with a width of 0 if the triball is behind the lens
+ */
+pros::vision_object_s_t objectFor(float x, float y, const robot::PoseSample& pose) {
+    pros::vision_object_s_t object = {};
+    object.signature = SIGNATURE;
+    // the triball's center relative to the lens, ahead along the heading and to the right of it
+    const float dx = x - pose.x;
+    const float dy = y - pose.y;
+    const float heading = pose.theta * DEG_TO_RAD;
+    float ahead = dx * std::sin(heading) + dy * std::cos(heading) - MOUNT.forward;
+    float across = dx * std::cos(heading) - dy * std::sin(heading) - MOUNT.right;
+    // the bottom edge of the box is the near side of the triball
+    const float range = std::hypot(ahead, across);
+    ahead -= ahead / range * TRIBALL_RADIUS;
+    across -= across / range * TRIBALL_RADIUS;
+    if (ahead <= 0) return object;
+    const float pitch = MOUNT.pitch * DEG_TO_RAD;
+    const float v = (MOUNT.height * std::cos(pitch) - ahead * std::sin(pitch)) /
+                    (ahead * std::cos(pitch) + MOUNT.height * std::sin(pitch));
+    const float scale = MOUNT.height / (std::sin(pitch) + v * std::cos(pitch));
+    const float u = across / scale;
+    // a box 20 pixels across, whatever the distance
+    object.width = 20;
+    object.height = 20;
+    object.left_coord = static_cast<int16_t>(std::lround(u * MOUNT.focalLength + VISION_FOV_WIDTH / 2 - 10));
+    object.top_coord = static_cast<int16_t>(std::lround(v * MOUNT.focalLength + VISION_FOV_HEIGHT / 2 - 20));
+    return object;
+}
+
+/**
+ * Record the pose a frame is taken at, and process the frame the sensor reports for some triballs
+ *
+ * The frame is read the sensor's latency after it was taken, so its time is that much later than the pose's
+ */
+void see(robot::TriballTracker& tracker, const robot::PoseSample& pose, const float (*triballs)[2], int count) {
+    tracker.recordPose(pose);
+    robot::VisionFrame frame = {pose.micros + MOUNT.latency, 0, {}};
+    for (int i = 0; i < count; i++) frame.objects[frame.count++] = objectFor(triballs[i][0], triballs[i][1], pose);
+    tracker.process(frame);
+}
+
+/**
+ * The triball in a set with an id, or nullptr
+ */
+const robot::Triball* find(const robot::TriballSet& set, uint32_t id) {
+    for (int i = 0; i < set.count; i++) {
+        if (set.triballs[i].id == id) return &set.triballs[i];
+    }
+    return nullptr;
+}
+} // namespace
+
+TEST_CASE(projectsTheBottomEdgeOntoTheField) {
+    robot::PoseSource poses;
+    robot::TriballTracker tracker(nullptr, SIGNATURE, poses, MOUNT);
+    // the middle of the image is along the lens' axis, which meets the floor height / tan(pitch) ahead of the lens
+    pros::vision_object_s_t center = {};
+    center.signature = SIGNATURE;
+    center.width = 20;
+    center.height = 20;
+    center.left_coord = VISION_FOV_WIDTH / 2 - 10;
+    center.top_coord = VISION_FOV_HEIGHT / 2 - 20;
+    const float ahead = MOUNT.forward + MOUNT.height / std::tan(MOUNT.pitch * DEG_TO_RAD) + TRIBALL_RADIUS;
+    float x = 0;
+    float y = 0;
+    CHECK(tracker.project(center, {1, 0, 0, 0, 0}, x, y));
+    CHECK_NEAR(x, 0, 0.05);
+    CHECK_NEAR(y, ahead, 0.05);
+    // facing +x from (10, 20), the same box is ahead along x
+    CHECK(tracker.project(center, {1, 0, 10, 20, 90}, x, y));
+    CHECK_NEAR(x, 10 + ahead, 0.05);
+    CHECK_NEAR(y, 20, 0.05);
+    // a triball off to the side and behind the robot's heading, seen from a turned robot
+    const robot::PoseSample turned = {1, 0, -12, 8, 135};
+    CHECK(tracker.project(objectFor(6, -20, turned), turned, x, y));
+    CHECK_NEAR(x, 6, 0.5);
+    CHECK_NEAR(y, -20, 0.5);
+    // above the horizon, and past the maximum range
+    pros::vision_object_s_t sky = center;
+    sky.top_coord = 0;
+    sky.height = 10;
+    x = 99;
+    CHECK(!tracker.project(sky, {1, 0, 0, 0, 0}, x, y));
+    CHECK(x == 99);
+    CHECK(!tracker.project(objectFor(0, 120, {1, 0, 0, 0, 0}), {1, 0, 0, 0, 0}, x, y));
+}
+
+TEST_CASE(associatesAcrossFramesAndConfirms) {
+    robot::PoseSource poses;
+    robot::TriballTracker tracker(nullptr, SIGNATURE, poses, MOUNT);
+    const float triballs[2][2] = {{0, 40}, {12, 36}};
+    // the same triballs the other way around, as the sensor orders its boxes by size
+    const float swapped[2][2] = {{12, 36}, {0, 40}};
+    uint32_t ids[2] = {};
+    for (uint32_t frame = 0; frame < 12; frame++) {
+        // driving up the field an inch a frame, so the boxes move down the image
+        const robot::PoseSample pose = {frame + 1, (frame + 1) * FRAME, 0, static_cast<float>(frame), 0};
+        see(tracker, pose, frame % 2 == 0 ? triballs : swapped, 2);
+        const robot::TriballSet set = tracker.get();
+        CHECK(set.sequence == frame + 1);
+        if (frame + 1 < robot::TriballTracker::CONFIRM_HITS) {
+            CHECK(set.count == 0);
+            continue;
+        }
+        CHECK(set.count == 2);
+        if (set.count != 2) continue;
+        if (ids[0] == 0) {
+            ids[0] = set.nearest(0, 40)->id;
+            ids[1] = set.nearest(12, 36)->id;
+            CHECK(ids[0] != ids[1]);
+        }
+        // each triball keeps its track however the boxes are ordered and wherever they are in the image
+        const robot::Triball* first = find(set, ids[0]);
+        const robot::Triball* second = find(set, ids[1]);
+        CHECK(first != nullptr && second != nullptr);
+        if (first == nullptr || second == nullptr) continue;
+        CHECK(first->hits == frame + 1);
+        CHECK_NEAR(first->x, 0, 1);
+        CHECK_NEAR(first->y, 40, 1);
+        CHECK_NEAR(second->x, 12, 1);
+        CHECK_NEAR(second->y, 36, 1);
+    }
+}
+
+TEST_CASE(dropsTracksUnseenForTheTimeout) {
+    robot::PoseSource poses;
+    robot::TriballTracker tracker(nullptr, SIGNATURE, poses, MOUNT);
+    const float triball[1][2] = {{-6, 30}};
+    uint64_t time = 0;
+    for (uint32_t frame = 0; frame < robot::TriballTracker::CONFIRM_HITS; frame++) {
+        time += FRAME;
+        see(tracker, {frame + 1, time, 0, 0, 0}, triball, 1);
+    }
+    CHECK(tracker.get().count == 1);
+    const uint64_t lastSeen = tracker.get().triballs[0].lastSeen;
+    // the triball is picked up, so the frames after are empty. The track lasts the timeout and no longer
+    while (time + MOUNT.latency + FRAME - lastSeen <= robot::TriballTracker::TRACK_TIMEOUT) {
+        time += FRAME;
+        see(tracker, {0, time, 0, 0, 0}, triball, 0);
+        CHECK(tracker.get().count == 1);
+    }
+    time += FRAME;
+    see(tracker, {0, time, 0, 0, 0}, triball, 0);
+    CHECK(tracker.get().count == 0);
+    // seen again, it is a new triball and has to be confirmed again
+    time += FRAME;
+    see(tracker, {0, time, 0, 0, 0}, triball, 1);
+    CHECK(tracker.get().count == 0);
+}
+
+TEST_CASE(moveToNearestTriballStopsShortOfIt) {
+    // a drivetrain with odometry on its motors, as in the motion worker's closed loop cases
+    pros::Motor left(1, pros::E_MOTOR_GEARSET_06);
+    pros::Motor right(2, pros::E_MOTOR_GEARSET_06);
+    pros::MotorGroup leftMotors({left});
+    pros::MotorGroup rightMotors({right});
+    lemlib::Drivetrain drivetrain(&leftMotors, &rightMotors, 12, 3.25, 360, 8);
+    lemlib::TrackingWheel leftWheel(&leftMotors, 3.25, -6, 360);
+    lemlib::TrackingWheel rightWheel(&rightMotors, 3.25, 6, 360);
+    lemlib::setSensors(lemlib::OdomSensors(&leftWheel, &rightWheel, nullptr, nullptr, nullptr), drivetrain);
+    lemlib::update();
+    lemlib::setPose(lemlib::Pose(0, 0, 0));
+    pros::Task odometry(
+        []() {
+            while (true) {
+                lemlib::update();
+                pros::delay(10);
+            }
+        },
+        TASK_PRIORITY_MAX);
+    robot::MotionWorker motions(drivetrain, lemlib::ControllerSettings(10, 30, 1, 100, 3, 500, 20),
+                                lemlib::ControllerSettings(2, 10, 1, 100, 3, 500, 20));
+    robot::PoseSource poses;
+    robot::TriballTracker tracker(nullptr, SIGNATURE, poses, MOUNT);
+    // the nearer triball is 40 inches away, up and to the right
+    const float triballs[2][2] = {{24, 32}, {-30, 50}};
+    for (uint32_t frame = 0; frame < robot::TriballTracker::CONFIRM_HITS; frame++) {
+        see(tracker, {frame + 1, (frame + 1) * FRAME, 0, 0, 30}, triballs, 2);
+    }
+    CHECK(tracker.get().count == 2);
+    uint32_t id = 0;
+    bool done = false;
+    pros::Task autonomous([&]() {
+        id = motions.moveToNearestTriball(tracker, 3000, 10);
+        motions.waitUntilDone();
+        done = true;
+    });
+    CHECK(host::runUntil([&]() { return done; }, 3100));
+    CHECK(id == tracker.get().nearest(24, 32)->id);
+    CHECK(motions.getLastEnd() == robot::MotionEnd::SETTLED);
+    // 10 inches short of the triball, along the line from where the robot started
+    const lemlib::Pose pose = lemlib::getPose();
+    CHECK_NEAR(pose.x, 18, 2);
+    CHECK_NEAR(pose.y, 24, 2);
+    // with no triballs, nothing is queued
+    robot::PoseSource emptyPoses;
+    robot::TriballTracker empty(nullptr, SIGNATURE, emptyPoses, MOUNT);
+    CHECK(motions.moveToNearestTriball(empty, 3000, 10) == 0);
+    CHECK(!motions.isBusy());
+}
+
+int main() { return test::runAll(); }
@@ -0,0 +1,60 @@
+/**
+ * @file host/tools/bench.cpp
+ * @brief Run the benchmarks from include/robot/bench.hpp on a computer
+ *
+ * Builds the robot's drivetrain and odometry sensors on the host shim and runs robot::bench::runAll on them, timed by
+ * the host's clock since virtual time stands still while code runs. Prints the same Google Benchmark style JSON as
+ * the brain, so tools/benchcompare.py in the project root compares two host runs the same way.
+ *
+ * Build and run with make bench, or build with make bin/bench and run bin/bench > bench.json
+ */
+
+#include <chrono>
+#include <cstdio>
+#include "pros/imu.hpp"
+#include "pros/motors.hpp"
+#include "robot/bench.hpp"
+#include "robot/clock.hpp"
+#include "host/sim.hpp"
+
+/**
+ * @brief The host's monotonic clock
+ *
+ */
+class WallClock final : public robot::Clock {
+    public:
+        uint64_t micros() override {
+            return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start)
+                .count();
+        }
+    private:
+        const std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+};
+
+int main() {
+    host::reset();
+    // the drivetrain and sensors from src/main.cpp
+    pros::Motor lF(20, pros::E_MOTOR_GEARSET_06, true);
+    pros::Motor lM(18, pros::E_MOTOR_GEARSET_06, true);
+    pros::Motor lB(19, pros::E_MOTOR_GEARSET_06, false);
+    pros::Motor rF(11, pros::E_MOTOR_GEARSET_06, false);
+    pros::Motor rM(13, pros::E_MOTOR_GEARSET_06, false);
+    pros::Motor rB(12, pros::E_MOTOR_GEARSET_06, true);
+    pros::MotorGroup leftMotors({lF, lM, lB});
+    pros::MotorGroup rightMotors({rF, rM, rB});
+    pros::Imu imu(17);
+    lemlib::Drivetrain drivetrain(&leftMotors, &rightMotors, 12, lemlib::Omniwheel::NEW_325, 360, 8);
+    lemlib::OdomSensors sensors(nullptr, nullptr, nullptr, nullptr, &imu);
+    WallClock clock;
+    // runAll raises its task's priority and starts tasks of its own, so it runs in a task like initialize() does
+    bool done = false;
+    pros::Task initialize([&]() {
+        robot::bench::runAll(sensors, drivetrain, clock);
+        done = true;
+    });
+    if (!host::runUntil([&]() { return done; }, 60000)) {
+        std::fprintf(stderr, "bench: the benchmarks did not finish\n");
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,211 @@
+/**
+ * @file host/tools/replay.cpp
+ * @brief Replay a recording from robot::Recorder through LemLib odometry on a computer
+ *
+ * Feeds every sample's raw motor counts, inertial sensor rotation, rotation sensor position and controller inputs into
+ * the host device state, runs odometry on them, and compares the replayed pose against the pose the robot computed
+ * during the run. Odometry constants can be overridden to check a change before it goes on the robot.
+ *
+ * The odometry replayed is the host's rebuild of LemLib, not the prebuilt LemLib 0.5.0-rc2 the robot runs, see
+ * host/src/lemlib.cpp. A recording replayed with its own constants should match the recorded pose, so drift there
+ * points at a difference between the two builds rather than at the constants.
+ *
+ * Build with make replay, then run bin/replay /path/to/replay.bin [options]
+ *
+ * --csv <file>              write time, recorded pose and replayed pose for every sample
+ * --track-width <inches>    override the recorded drivetrain track width
+ * --wheel-diameter <inches> override the recorded wheel diameter
+ * --rpm <rpm>               override the recorded wheel rpm
+ * --threshold <inches>      fail if the replayed position drifts further than this from the recording. Default 0.5
+ */
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+#include "lemlib/chassis/odom.hpp"
+#include "lemlib/chassis/trackingWheel.hpp"
+#include "lemlib/util.hpp"
+#include "pros/imu.hpp"
+#include "pros/misc.hpp"
+#include "pros/rotation.hpp"
+#include "robot/odom.hpp"
+#include "robot/recorder.hpp"
+#include "host/sim.hpp"
+
+// ports the replay uses for the sensors. The recording doesn't store them since only the values matter
+static constexpr uint8_t IMU_PORT = 1;
+static constexpr uint8_t ROTATION_PORT = 2;
+
+/**
+ * @brief Get the number of encoder counts in a degree of output shaft rotation
+ *
+ */
+static double countsPerDegree(uint8_t gearset) {
+    switch (gearset) {
+        case pros::E_MOTOR_GEARSET_36: return 1800.0 / 360;
+        case pros::E_MOTOR_GEARSET_06: return 300.0 / 360;
+        default: return 900.0 / 360;
+    }
+}
+
+/**
+ * @brief Read a recording
+ *
+ * @return true the file is a recording from this version of the code
+ * @return false the file could not be read, or has a different format
+ */
+static bool readRecording(const char* path, robot::RecordingHeader& header, std::vector<robot::SensorSample>& samples) {
+    FILE* file = std::fopen(path, "rb");
+    if (file == nullptr) {
+        std::fprintf(stderr, "replay: could not open %s\n", path);
+        return false;
+    }
+    bool valid = std::fread(&header, sizeof(header), 1, file) == 1 && std::memcmp(header.magic, "RREC", 4) == 0;
+    if (!valid) {
+        std::fprintf(stderr, "replay: %s is not a recording\n", path);
+    } else if (header.version != robot::RECORDING_VERSION || header.sampleSize != sizeof(robot::SensorSample) ||
+               header.motorCount > robot::RECORDING_MAX_MOTORS ||
+               header.leftCount + header.rightCount > header.motorCount) {
+        std::fprintf(stderr, "replay: %s is recording version %d, expected %d\n", path, header.version,
+                     robot::RECORDING_VERSION);
+        valid = false;
+    } else {
+        samples.resize(header.sampleCount);
+        valid = std::fread(samples.data(), sizeof(robot::SensorSample), samples.size(), file) == samples.size();
+        if (!valid) std::fprintf(stderr, "replay: %s is truncated\n", path);
+    }
+    std::fclose(file);
+    return valid;
+}
+
+/**
+ * @brief Write the raw values in a sample to the host device state
+ *
+ */
+static void applySample(const robot::RecordingHeader& header, const robot::SensorSample& sample) {
+    for (int i = 0; i < header.motorCount; i++) {
+        host::MotorState& motor = host::motor(std::abs(header.ports[i]));
+        // raw counts are in the motor's frame, the host keeps positions in the physical frame
+        const double direction = header.ports[i] < 0 ? -1 : 1;
+        motor.position = direction * sample.motorPositions[i] / countsPerDegree(header.gearsets[i]);
+    }
+    host::imu(IMU_PORT).rotation = sample.imuRotation;
+    host::rotation(ROTATION_PORT).position = sample.rotationPosition;
+    host::ControllerState& controller = host::controller(pros::E_CONTROLLER_MASTER);
+    for (int i = 0; i < 4; i++) controller.analog[i] = sample.analog[i];
+    for (int i = 0; i < 12; i++) controller.digital[pros::E_CONTROLLER_DIGITAL_L1 + i] = sample.buttons & (1 << i);
+}
+
+int main(int argc, char** argv) {
+    const char* path = nullptr;
+    const char* csvPath = nullptr;
+    float trackWidth = NAN;
+    float wheelDiameter = NAN;
+    float rpm = NAN;
+    float threshold = 0.5;
+    for (int i = 1; i < argc; i++) {
+        const bool hasValue = i + 1 < argc;
+        if (std::strcmp(argv[i], "--csv") == 0 && hasValue) csvPath = argv[++i];
+        else if (std::strcmp(argv[i], "--track-width") == 0 && hasValue) trackWidth = std::atof(argv[++i]);
+        else if (std::strcmp(argv[i], "--wheel-diameter") == 0 && hasValue) wheelDiameter = std::atof(argv[++i]);
+        else if (std::strcmp(argv[i], "--rpm") == 0 && hasValue) rpm = std::atof(argv[++i]);
+        else if (std::strcmp(argv[i], "--threshold") == 0 && hasValue) threshold = std::atof(argv[++i]);
+        else if (path == nullptr && argv[i][0] != '-') path = argv[i];
+        else {
+            std::fprintf(stderr, "usage: replay <recording> [--csv file] [--track-width in] [--wheel-diameter in] "
+                                 "[--rpm rpm] [--threshold in]\n");
+            return 2;
+        }
+    }
+    if (path == nullptr) {
+        std::fprintf(stderr, "usage: replay <recording> [options]\n");
+        return 2;
+    }
+
+    robot::RecordingHeader header;
+    std::vector<robot::SensorSample> samples;
+    if (!readRecording(path, header, samples)) return 2;
+    if (samples.empty()) {
+        std::fprintf(stderr, "replay: %s has no samples\n", path);
+        return 2;
+    }
+    if (std::isnan(trackWidth)) trackWidth = header.trackWidth;
+    if (std::isnan(wheelDiameter)) wheelDiameter = header.wheelDiameter;
+    if (std::isnan(rpm)) rpm = header.rpm;
+
+    const auto wallStart = std::chrono::steady_clock::now();
+    host::reset();
+    // rebuild the drivetrain from the recorded ports
+    std::vector<pros::Motor> left;
+    std::vector<pros::Motor> right;
+    for (int i = 0; i < header.leftCount + header.rightCount; i++) {
+        pros::Motor motor(std::abs(header.ports[i]), static_cast<pros::motor_gearset_e_t>(header.gearsets[i]),
+                          header.ports[i] < 0);
+        if (i < header.leftCount) left.push_back(motor);
+        else right.push_back(motor);
+    }
+    pros::Motor_Group leftMotors(left);
+    pros::Motor_Group rightMotors(right);
+    lemlib::Drivetrain drivetrain(&leftMotors, &rightMotors, trackWidth, wheelDiameter, rpm, 0);
+    pros::Imu imu(IMU_PORT);
+    pros::Rotation rotation(ROTATION_PORT, false);
+
+    // start odometry from the first sample, at the pose the robot had then
+    applySample(header, samples[0]);
+    lemlib::OdomSensors sensors =
+        robot::withDrivetrainWheels(lemlib::OdomSensors(nullptr, nullptr, nullptr, nullptr, &imu), drivetrain);
+    sensors.vertical1->reset();
+    sensors.vertical2->reset();
+    lemlib::setSensors(sensors, drivetrain);
+    lemlib::update();
+    lemlib::setPose(lemlib::Pose(samples[0].poseX, samples[0].poseY, samples[0].poseTheta));
+
+    FILE* csv = csvPath != nullptr ? std::fopen(csvPath, "w") : nullptr;
+    if (csvPath != nullptr && csv == nullptr) std::fprintf(stderr, "replay: could not open %s\n", csvPath);
+    if (csv != nullptr) std::fprintf(csv, "time,recorded x,recorded y,recorded theta,x,y,theta\n");
+
+    double maxError = 0;
+    double sumSquaredError = 0;
+    double maxHeadingError = 0;
+    int64_t firstOverThreshold = -1;
+    for (size_t i = 0; i < samples.size(); i++) {
+        const robot::SensorSample& sample = samples[i];
+        if (i > 0) {
+            applySample(header, sample);
+            // keep the virtual clock in step with the recording, so millis() in replayed code matches
+            host::runFor(sample.time - samples[i - 1].time);
+            lemlib::update();
+        }
+        const lemlib::Pose pose = lemlib::getPose();
+        const double error = std::hypot(pose.x - sample.poseX, pose.y - sample.poseY);
+        const double headingError = std::fabs(lemlib::angleError(pose.theta, sample.poseTheta, false));
+        if (error > maxError) maxError = error;
+        if (headingError > maxHeadingError) maxHeadingError = headingError;
+        sumSquaredError += error * error;
+        if (error > threshold && firstOverThreshold < 0) firstOverThreshold = sample.time - samples[0].time;
+        if (csv != nullptr) {
+            std::fprintf(csv, "%u,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f\n", sample.time, sample.poseX, sample.poseY,
+                         sample.poseTheta, pose.x, pose.y, pose.theta);
+        }
+    }
+    if (csv != nullptr) std::fclose(csv);
+    const double wallTime =
+        std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - wallStart).count();
+
+    const lemlib::Pose pose = lemlib::getPose();
+    const robot::SensorSample& last = samples.back();
+    std::printf("replayed %zu samples (%.1f s) in %.1f ms\n", samples.size(),
+                (last.time - samples[0].time) / 1000.0, wallTime);
+    std::printf("final pose     %8.2f %8.2f %8.2f\n", pose.x, pose.y, pose.theta);
+    std::printf("recorded pose  %8.2f %8.2f %8.2f\n", last.poseX, last.poseY, last.poseTheta);
+    std::printf("position error max %.3f in, rms %.3f in\n", maxError, std::sqrt(sumSquaredError / samples.size()));
+    std::printf("heading error max %.3f deg\n", maxHeadingError);
+    if (firstOverThreshold >= 0) {
+        std::printf("position error first exceeded %.2f in at %.2f s\n", threshold, firstOverThreshold / 1000.0);
+        return 1;
+    }
+    return 0;
+}
@@ -17,9 +17,14 @@
 
 #include <stdarg.h>   
 #include <stdbool.h>  
+// leave _GNU_SOURCE alone if the compiler already defines it, as g++ does on the host build
+#ifndef _GNU_SOURCE
 #define _GNU_SOURCE
 #include <stdio.h>  
 #undef _GNU_SOURCE
+#else
+#include <stdio.h>
+#endif
 #include <stdint.h>
 
 #include "pros/colors.h"     // c color macros
@@ -0,0 +1,61 @@
+/**
+ * @file include/robot/bench.hpp
+ * @brief On-brain math benchmarks
+ *
+ * LemLib and okapi only exist in this project as prebuilt ARM libraries, so their hot paths can only be measured on
+ * the brain itself. The benchmarks are compiled out unless ROBOT_BENCH is defined, e.g. by adding -DROBOT_BENCH to
+ * EXTRA_CXXFLAGS in the Makefile. When compiled in, initialize() runs them once and prints the results to the
+ * terminal as a single line of Google Benchmark style JSON. tools/benchcompare.py extracts that line from a saved
+ * terminal log and compares two runs.
+ *
+ * make bench in host/ runs the same suite on a computer against the host shim, timed by the host's clock, which is
+ * quicker for checking that a change to project code is faster. LemLib and okapi calls there measure the shim's
+ * rebuilds of them rather than the prebuilt libraries, and squiggles' spline generator, which only exists in okapi's
+ * ARM library, is left out.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include "lemlib/chassis/chassis.hpp"
+#include "robot/clock.hpp"
+
+namespace robot {
+namespace bench {
+/**
+ * @brief Result of a single benchmark
+ *
+ */
+struct Result {
+        /** name of the benchmark */
+        const char* name;
+        /** number of times the benchmarked code was run */
+        uint32_t iterations;
+        /** average time per iteration, in nanoseconds */
+        float nanoseconds;
+};
+
+/**
+ * @brief Keep the compiler from optimizing away a value
+ *
+ * @param value the value to keep
+ */
+template <typename T> inline void doNotOptimize(const T& value) { asm volatile("" : : "g"(&value) : "memory"); }
+
+#ifdef ROBOT_BENCH
+/**
+ * @brief Run all benchmarks and print the results as JSON
+ *
+ * This points LemLib's odometry at the given sensors and runs odometry updates, so it should be called before the
+ * pose is set
+ *
+ * @param sensors the odometry sensors of the chassis
+ * @param drivetrain the drivetrain of the chassis
+ * @param clock the clock the benchmarks are timed with. Must not stand still while code runs
+ */
+void runAll(const lemlib::OdomSensors& sensors, const lemlib::Drivetrain& drivetrain, Clock& clock = systemClock());
+#else
+inline void runAll(const lemlib::OdomSensors&, const lemlib::Drivetrain&, Clock& = systemClock()) {}
+#endif
+} // namespace bench
+} // namespace robot
@@ -0,0 +1,149 @@
+/**
+ * @file include/robot/clock.hpp
+ * @brief Monotonic microsecond clock
+ *
+ * pros::millis() counts whole milliseconds, so at a 10ms loop the time between two updates reads as 9, 10 or 11ms
+ * depending on where the ticks fall, and a derivative divided by a fixed 10ms is off by as much as the scheduling
+ * jitter. Clock reads pros::micros() instead, and DeltaTimer turns it into the time since the last update in seconds.
+ *
+ * Everything that measures time through a Clock can be given a ManualClock in host tests, which only moves when told
+ * to, so dt can be made as uneven as the test needs. The default, systemClock(), follows virtual time on the host
+ * shim like every other pros time call.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include "pros/rtos.hpp"
+
+namespace robot {
+/**
+ * @brief Source of monotonic time
+ *
+ */
+class Clock {
+    public:
+        /**
+         * @brief Get the current time
+         *
+         * @return uint64_t - time since an arbitrary start, in microseconds. Never decreases
+         */
+        virtual uint64_t micros() = 0;
+    protected:
+        ~Clock() = default;
+};
+
+/**
+ * @brief Clock that reads pros::micros()
+ *
+ */
+class SystemClock final : public Clock {
+    public:
+        uint64_t micros() override { return pros::micros(); }
+};
+
+/**
+ * @brief Clock that only moves when it is set or advanced, for tests
+ *
+ * <h3> Example Usage </h3>
+ * @code
+ * robot::ManualClock clock;
+ * robot::Pid pid(10, 0, 0.3, 0, false, clock);
+ * pid.update(12);
+ * clock.advance(9700);
+ * pid.update(11.5);
+ * @endcode
+ */
+class ManualClock final : public Clock {
+    public:
+        explicit ManualClock(uint64_t start = 0) : now(start) {}
+
+        uint64_t micros() override { return now; }
+
+        /**
+         * @brief Set the time
+         *
+         * @param time the new time, in microseconds. Must not be before the current time
+         */
+        void set(uint64_t time) { now = time; }
+
+        /**
+         * @brief Move the time forward
+         *
+         * @param time how far to move it, in microseconds
+         */
+        void advance(uint64_t time) { now += time; }
+    private:
+        std::atomic<uint64_t> now;
+};
+
+/**
+ * @brief Get the clock shared by everything that isn't given another one
+ *
+ * @return Clock& - a SystemClock
+ */
+inline Clock& systemClock() {
+    static SystemClock clock;
+    return clock;
+}
+
+/**
+ * @brief Measures the time between updates
+ *
+ * <h3> Example Usage </h3>
+ * @code
+ * robot::DeltaTimer timer;
+ * while (true) {
+ *     const float dt = timer.update(); // 0 the first time
+ *     pros::delay(10);
+ * }
+ * @endcode
+ */
+class DeltaTimer {
+    public:
+        /**
+         * @brief Construct a new Delta Timer
+         *
+         * @param clock the clock to read. Must outlive the timer
+         */
+        explicit DeltaTimer(Clock& clock = systemClock()) : clock(clock) {}
+
+        /**
+         * @brief Take the time, and return how long it has been since the last update
+         *
+         * @return float - time since the last update, in seconds. 0 on the first update after construction or reset
+         */
+        float update() {
+            const uint64_t now = clock.micros();
+            const float dt = started ? (now - last) * 1e-6f : 0;
+            last = now;
+            started = true;
+            return dt;
+        }
+
+        /**
+         * @brief Forget the last update, so the next one returns 0
+         *
+         */
+        void reset() { started = false; }
+
+        /**
+         * @brief Get the time of the last update
+         *
+         * @return uint64_t - time of the last update, in microseconds. 0 before the first update
+         */
+        uint64_t getLast() { return started ? last : 0; }
+
+        /**
+         * @brief Get the clock the timer reads
+         *
+         * @return Clock&
+         */
+        Clock& getClock() { return clock; }
+    private:
+        Clock& clock;
+        uint64_t last = 0;
+        bool started = false;
+};
+} // namespace robot
@@ -0,0 +1,180 @@
+/**
+ * @file include/robot/config.hpp
+ * @brief Tunable parameter store declarations
+ *
+ * Gains, the track width and path lookaheads are compiled into the program, so every tuning change means a rebuild
+ * and an upload. ConfigStore holds them as named parameters instead, with a default and a valid range each, and reads
+ * new values from a text file on the SD card at startup and whenever a "reload" command arrives over serial.
+ *
+ * A file is checked completely before anything is applied: an unknown name, a value that isn't a number or one out of
+ * range rejects the whole file and keeps the parameters in use. Accepted values are published together as a new
+ * parameter set, double buffered like SensorHub's snapshots, so a reader never sees half of one set and half of
+ * another.
+ *
+ * The file has one parameter per line, a name and a value separated by spaces or '='. Anything after a '#' is a
+ * comment, and parameters that aren't in the file keep their current value:
+ * @code
+ * # linear controller
+ * linear.kP = 10
+ * linear.kD = 30
+ * @endcode
+ *
+ * Commands, one per line over serial:
+ * - reload: read the file again
+ * - set <name> <value>: change one parameter
+ * - get: log every parameter
+ * - save: write every parameter to the file
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include "pros/rtos.hpp"
+#include "robot/doubleBuffer.hpp"
+
+namespace robot {
+/**
+ * @brief Values of every parameter, published together
+ *
+ */
+struct ConfigSet {
+        /** @brief maximum number of parameters */
+        static constexpr int MAX_PARAMS = 32;
+
+        /** number of sets published up to and including this one */
+        uint32_t version;
+        /** values, indexed by the parameter returned from ConfigStore::add */
+        float values[MAX_PARAMS];
+
+        float operator[](int param) const { return values[param]; }
+};
+
+/**
+ * @brief Named parameters, loaded from the SD card and changed over serial while the program runs
+ *
+ * <h3> Example Usage </h3>
+ * @code
+ * robot::ConfigStore config("/usd/config.txt");
+ * const int lookahead = config.add("path.lookahead", 15, 1, 40);
+ * config.onChange([](const robot::ConfigSet& set) { lemlib::infoSink()->debug("lookahead {}", set[lookahead]); });
+ * // in initialize
+ * config.load();
+ * config.start();
+ * // anywhere
+ * motions.follow(path, config.get(lookahead), 3000);
+ * @endcode
+ */
+class ConfigStore {
+    public:
+        /** @brief longest parameter name, including the terminator */
+        static constexpr int NAME_LENGTH = 32;
+        /** @brief longest line in the file or in a command */
+        static constexpr int LINE_LENGTH = 96;
+
+        /**
+         * @brief Construct a new Config Store
+         *
+         * @param path path of the parameter file on the SD card, e.g. "/usd/config.txt"
+         */
+        explicit ConfigStore(const char* path);
+        ConfigStore(const ConfigStore&) = delete;
+        ConfigStore& operator=(const ConfigStore&) = delete;
+        /**
+         * @brief Add a parameter
+         *
+         * Must be called before anything is loaded
+         *
+         * @param name name of the parameter in the file and in commands
+         * @param value default value, used until a file or command sets another
+         * @param min smallest valid value
+         * @param max largest valid value
+         * @return int - the parameter, or -1 if there is no room for another one or the name is too long
+         */
+        int add(const char* name, float value, float min, float max);
+        /**
+         * @brief Call a function every time a new set is published
+         *
+         * The function runs in the task that published the set, after it was published. It is how parameters that
+         * are copied elsewhere, like chassis gains, get updated
+         *
+         * @param callback the function, given the new set
+         */
+        void onChange(std::function<void(const ConfigSet&)> callback);
+        /**
+         * @brief Read the parameter file and publish its values
+         *
+         * @return true the file was read and its values published
+         * @return false the file could not be read or was rejected. The parameters in use are kept
+         */
+        bool load();
+        /**
+         * @brief Write every parameter to the parameter file
+         *
+         * @return true the file was written
+         * @return false the file could not be written
+         */
+        bool save();
+        /**
+         * @brief Start the "config" task, which runs commands read from serial
+         *
+         */
+        void start();
+        /**
+         * @brief Run one command
+         *
+         * @param line the command, as typed over serial
+         * @return true the command was run
+         * @return false the command was unknown or failed
+         */
+        bool command(const char* line);
+        /**
+         * @brief Get the current value of a parameter
+         *
+         * @param param the parameter, as returned by add
+         * @return float - the value, or 0 if there is no such parameter
+         */
+        float get(int param);
+        /**
+         * @brief Get every parameter at once
+         *
+         * Safe to call from any number of tasks at once. Never blocks
+         *
+         * @return ConfigSet - a copy of the latest set
+         */
+        ConfigSet getSet();
+    private:
+        struct Param {
+                char name[NAME_LENGTH];
+                float min;
+                float max;
+        };
+
+        /**
+         * @brief Find a parameter by name
+         *
+         * @return int - the parameter, or -1 if there is none
+         */
+        int find(const char* name, int length);
+        /**
+         * @brief Apply one "name value" line to a set
+         *
+         * @return true the line was blank, a comment or a valid parameter
+         */
+        bool parseLine(const char* line, int number, ConfigSet& set);
+        /**
+         * @brief Publish a set and call the change callback. Must be called with the writer mutex taken
+         *
+         */
+        void publish(const ConfigSet& set);
+
+        const char* path;
+        Param params[ConfigSet::MAX_PARAMS];
+        int paramCount = 0;
+        std::function<void(const ConfigSet&)> callback;
+        pros::Task* task = nullptr;
+        // the double buffer has one writer at a time, so loads and commands take this to publish
+        pros::Mutex writerMutex;
+        DoubleBuffer<ConfigSet> sets;
+};
+} // namespace robot
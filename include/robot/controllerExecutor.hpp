@@ -0,0 +1,137 @@
+/**
+ * @file include/robot/controllerExecutor.hpp
+ * @brief Shared okapi controller executor declarations
+ *
+ * okapi runs each iterative controller in its own task: AsyncWrapper, and everything built on it like
+ * AsyncPosPIDController or ChassisControllerPID, starts a task that steps the controller and sleeps for its sample
+ * time. A few controllers mean a few tasks, each waking up every 10ms and switching context to do a few microseconds
+ * of work.
+ *
+ * ControllerExecutor steps every registered controller in the one "controllers" task instead. Each controller runs at
+ * its own sample time, read from the controller every step as AsyncWrapper does, and controllers due at the same time
+ * run in the order they were added, so every run steps them in the same order. The executor measures how long each
+ * step takes and counts the steps that started a whole sample time late.
+ *
+ * The schedule is kept in microseconds on a robot::Clock, so a sample time that isn't a whole number of milliseconds
+ * doesn't drift, and only the sleep between steps is rounded to the RTOS tick.
+ *
+ * Only iterative controllers with an input and an output can be added, the pieces AsyncWrapper is built from.
+ * AsyncMotionProfileController and the chassis controllers like ChassisControllerPID step themselves in a loop of
+ * their own that okapi keeps private, and start its task when they are built, so they can't be moved onto the
+ * executor. They keep their own tasks.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include "okapi/api/control/controllerInput.hpp"
+#include "okapi/api/control/controllerOutput.hpp"
+#include "okapi/api/control/iterative/iterativeController.hpp"
+#include "pros/rtos.hpp"
+#include "robot/clock.hpp"
+
+namespace robot {
+/**
+ * @brief Execution time of a controller
+ *
+ */
+struct ControllerTiming {
+        /** number of steps run */
+        uint32_t steps;
+        /** average time to read the input, step the controller and write the output, in microseconds */
+        uint32_t averageMicros;
+        /** longest time to read the input, step the controller and write the output, in microseconds */
+        uint32_t maxMicros;
+        /** number of steps that started a whole sample time or more after they were due. Missed steps are skipped */
+        uint32_t late;
+};
+
+/**
+ * @brief Steps okapi iterative controllers in one shared task
+ *
+ * Replaces one AsyncWrapper per controller. The controllers are used directly: setTarget, isSettled and flipDisable
+ * work the same way, and a disabled controller isn't stepped
+ *
+ * <h3> Example Usage </h3>
+ * @code
+ * okapi::IterativePosPIDController cataPid(0.004, 0, 0.0001, 0, okapi::TimeUtilFactory::createDefault());
+ * okapi::Motor cataMotor(15);
+ * okapi::RotationSensor cataSensor(16);
+ * robot::ControllerExecutor controllers;
+ * controllers.add("cata", &cataPid, &cataSensor, &cataMotor);
+ * controllers.start();
+ * cataPid.setTarget(5500);
+ * @endcode
+ */
+class ControllerExecutor {
+    public:
+        /** @brief maximum number of controllers */
+        static constexpr int MAX_CONTROLLERS = 8;
+
+        /**
+         * @brief Construct a new Controller Executor
+         *
+         * @param clock clock to schedule and time the steps with. Must outlive the executor
+         */
+        explicit ControllerExecutor(Clock& clock = systemClock());
+        ControllerExecutor(const ControllerExecutor&) = delete;
+        ControllerExecutor& operator=(const ControllerExecutor&) = delete;
+        /**
+         * @brief Add a controller
+         *
+         * Must be called before the executor starts. Every step reads the input, steps the controller with it and
+         * writes the controller's output, like AsyncWrapper does
+         *
+         * @param name name of the controller in the report
+         * @param controller the controller. Must outlive the executor
+         * @param input where the controller reads from, e.g. a sensor. Must outlive the executor
+         * @param output where the controller writes to, e.g. a motor. Must outlive the executor
+         * @return int - the controller, or -1 if there is no room for another one
+         */
+        int add(const char* name, okapi::IterativeController<double, double>* controller,
+                okapi::ControllerInput<double>* input, okapi::ControllerOutput<double>* output);
+        /**
+         * @brief Start the "controllers" task
+         *
+         */
+        void start();
+        /**
+         * @brief Step every controller that is due, and return how long until the next one is
+         *
+         * Called by the executor task. Only one task may call it
+         *
+         * @return uint32_t - time until the next controller is due, in milliseconds
+         */
+        uint32_t update();
+        /**
+         * @brief Get the execution time of a controller
+         *
+         * @param controller the controller, as returned by add
+         * @return ControllerTiming
+         */
+        ControllerTiming getTiming(int controller);
+        /**
+         * @brief Log the execution time of every controller through the info sink, at debug level
+         *
+         */
+        void report();
+    private:
+        struct Entry {
+                const char* name;
+                okapi::IterativeController<double, double>* controller;
+                okapi::ControllerInput<double>* input;
+                okapi::ControllerOutput<double>* output;
+                // time the next step is due, in microseconds on the clock
+                uint64_t due;
+                uint32_t steps;
+                uint64_t totalMicros;
+                uint32_t maxMicros;
+                uint32_t late;
+        };
+
+        Clock& clock;
+        Entry entries[MAX_CONTROLLERS];
+        int entryCount = 0;
+        pros::Task* task = nullptr;
+};
+} // namespace robot
@@ -0,0 +1,308 @@
+/**
+ * @file include/robot/coroutine.hpp
+ * @brief Coroutine executor declarations
+ *
+ * autonomous() is a script of blocking waits, so doing two things at once, like reloading the catapult while driving,
+ * takes another task. With coroutines, each thing is a Routine that co_awaits motions, distance markers and delays,
+ * and a CoroutineExecutor runs every routine in the one task that calls run(), resuming each once what it waits for
+ * has happened.
+ *
+ * Coroutines need C++20, and the project builds with --std=gnu++17 from common.mk. Adding --std=gnu++20 -fcoroutines
+ * to EXTRA_CXXFLAGS in the Makefile enables them; without it this header declares nothing.
+ *
+ * Coroutine frames are never allocated on the heap. Each one takes a fixed size slot of a static arena, and a
+ * coroutine whose frame doesn't fit, or that finds every slot taken, doesn't run at all and logs a warning. The
+ * arena's peak use is in getArenaStats(), for sizing it.
+ *
+ * Waits are checked in spawn order every PERIOD, so routines run in the same order on every run, and in virtual time
+ * on the host shim like any other task.
+ */
+
+#pragma once
+
+#ifdef __cpp_impl_coroutine
+#include <coroutine>
+#include <cstddef>
+#include <cstdint>
+#include <exception>
+#include <utility>
+#include "pros/rtos.hpp"
+#include "robot/motionWorker.hpp"
+
+namespace robot {
+/** @brief number of coroutine frames that can exist at once */
+constexpr int COROUTINE_FRAMES = 16;
+/** @brief largest coroutine frame, in bytes */
+constexpr std::size_t COROUTINE_FRAME_SIZE = 512;
+
+/**
+ * @brief Use of the coroutine frame arena
+ *
+ */
+struct ArenaStats {
+        /** number of frames in use */
+        int used;
+        /** most frames in use at once */
+        int peak;
+        /** largest frame requested, in bytes */
+        std::size_t largestFrame;
+        /** number of coroutines that didn't run because their frame didn't fit */
+        uint32_t failures;
+};
+
+/**
+ * @brief A coroutine that can be run by a CoroutineExecutor or awaited by another Routine
+ *
+ * A routine doesn't start when it is called. It starts when it is spawned, or when another routine co_awaits it, which
+ * runs it to the end before the awaiting routine continues
+ *
+ * <h3> Example Usage </h3>
+ * @code
+ * robot::Routine reload() {
+ *     cata.move(127);
+ *     co_await robot::waitFor([]() { return cata_rot.get_angle() > 5500; });
+ *     cata.move(0);
+ * }
+ * @endcode
+ */
+class Routine {
+    public:
+        struct promise_type {
+                /** routine that awaits this one, resumed when this one ends */
+                std::coroutine_handle<> continuation;
+
+                static void* operator new(std::size_t size) noexcept;
+                static void operator delete(void* frame) noexcept;
+
+                static Routine get_return_object_on_allocation_failure() { return Routine(nullptr); }
+
+                Routine get_return_object() {
+                    return Routine(std::coroutine_handle<promise_type>::from_promise(*this));
+                }
+
+                std::suspend_always initial_suspend() noexcept { return {}; }
+
+                auto final_suspend() noexcept {
+                    struct Final {
+                            bool await_ready() noexcept { return false; }
+
+                            std::coroutine_handle<> await_suspend(std::coroutine_handle<promise_type> handle) noexcept {
+                                const std::coroutine_handle<> next = handle.promise().continuation;
+                                return next ? next : std::noop_coroutine();
+                            }
+
+                            void await_resume() noexcept {}
+                    };
+
+                    return Final {};
+                }
+
+                void return_void() {}
+
+                void unhandled_exception() { std::terminate(); }
+        };
+
+        Routine(Routine&& other) noexcept : handle(std::exchange(other.handle, nullptr)) {}
+
+        Routine& operator=(Routine&&) = delete;
+
+        ~Routine() {
+            if (handle) handle.destroy();
+        }
+
+        bool await_ready() const noexcept { return !handle || handle.done(); }
+
+        std::coroutine_handle<> await_suspend(std::coroutine_handle<> caller) noexcept {
+            handle.promise().continuation = caller;
+            return handle;
+        }
+
+        void await_resume() const noexcept {}
+    private:
+        friend class CoroutineExecutor;
+
+        explicit Routine(std::coroutine_handle<promise_type> handle) : handle(handle) {}
+
+        std::coroutine_handle<promise_type> handle;
+};
+
+/**
+ * @brief Something a routine can co_await
+ *
+ * Subclasses say when the wait is over. Awaited outside an executor, the wait blocks the calling task instead
+ */
+class CoroutineWait {
+    public:
+        bool await_ready() { return ready(); }
+
+        bool await_suspend(std::coroutine_handle<> handle);
+
+        void await_resume() {}
+
+        /**
+         * @brief Whether the wait is over
+         *
+         */
+        virtual bool ready() = 0;
+    protected:
+        ~CoroutineWait() = default;
+};
+
+/**
+ * @brief Runs routines in the calling task
+ *
+ * <h3> Example Usage </h3>
+ * @code
+ * robot::CoroutineExecutor executor;
+ * executor.spawn(drive());
+ * executor.spawn(reload());
+ * executor.run();
+ * @endcode
+ */
+class CoroutineExecutor {
+    public:
+        /** @brief number of routines that can run at once */
+        static constexpr int MAX_ROUTINES = 8;
+        /** @brief time between checks of what the routines wait for, in milliseconds */
+        static constexpr uint32_t PERIOD = 1;
+
+        CoroutineExecutor() = default;
+        CoroutineExecutor(const CoroutineExecutor&) = delete;
+        CoroutineExecutor& operator=(const CoroutineExecutor&) = delete;
+        /**
+         * @brief Add a routine
+         *
+         * May be called from a running routine, to start another one alongside it
+         *
+         * @param routine the routine
+         * @return true the routine will run
+         * @return false there was no room for another routine, or its frame could not be allocated
+         */
+        bool spawn(Routine&& routine);
+        /**
+         * @brief Run the routines until every one has ended
+         *
+         */
+        void run();
+        /**
+         * @brief Get the number of routines that haven't ended
+         *
+         * @return int
+         */
+        int getCount();
+        /**
+         * @brief Get the use of the coroutine frame arena
+         *
+         * @return ArenaStats
+         */
+        static ArenaStats getArenaStats();
+    private:
+        friend class CoroutineWait;
+
+        struct Slot {
+                // the spawned routine, null if the slot is free
+                std::coroutine_handle<Routine::promise_type> root;
+                // innermost routine it is waiting in, and what it waits for. Resumed once the wait is ready
+                std::coroutine_handle<> resume;
+                CoroutineWait* wait;
+        };
+
+        Slot slots[MAX_ROUTINES] = {};
+        // slot being resumed, -1 between resumes
+        int running = -1;
+};
+
+/**
+ * @brief Wait that ends after a number of milliseconds
+ *
+ */
+class Delay : public CoroutineWait {
+    public:
+        explicit Delay(uint32_t time) : end(pros::millis() + time) {}
+
+        bool ready() override { return static_cast<int32_t>(pros::millis() - end) >= 0; }
+    private:
+        const uint32_t end;
+};
+
+/**
+ * @brief Wait that ends once a condition is true
+ *
+ */
+template <typename Condition> class WaitFor : public CoroutineWait {
+    public:
+        explicit WaitFor(Condition condition) : condition(std::move(condition)) {}
+
+        bool ready() override { return condition(); }
+    private:
+        Condition condition;
+};
+
+/**
+ * @brief Wait that ends once the current motion has traveled a distance, or ended
+ *
+ */
+class Traveled : public CoroutineWait {
+    public:
+        Traveled(MotionWorker& motions, float dist) : motions(motions), dist(dist) {}
+
+        bool ready() override { return motions.hasTraveled(dist); }
+    private:
+        MotionWorker& motions;
+        const float dist;
+};
+
+/**
+ * @brief Wait that ends once no motion is running or queued
+ *
+ * Motion calls block until their motion starts, which stops every routine if another motion is still running. Calling
+ * them right after this wait starts the motion straight away
+ */
+class Idle : public CoroutineWait {
+    public:
+        explicit Idle(MotionWorker& motions) : motions(motions) {}
+
+        bool ready() override { return !motions.isBusy(); }
+    private:
+        MotionWorker& motions;
+};
+
+/**
+ * @brief Wait for a number of milliseconds
+ *
+ * <h3> Example Usage </h3>
+ * @code
+ * co_await robot::delay(250);
+ * @endcode
+ */
+inline Delay delay(uint32_t time) { return Delay(time); }
+
+/**
+ * @brief Wait until a condition is true
+ *
+ * @param condition function returning whether to stop waiting, called every PERIOD
+ */
+template <typename Condition> WaitFor<Condition> waitFor(Condition condition) {
+    return WaitFor<Condition>(std::move(condition));
+}
+
+/**
+ * @brief Wait until the current motion has traveled a distance, or ended
+ *
+ * @param dist distance, in inches for moves and degrees for turns
+ */
+inline Traveled traveled(MotionWorker& motions, float dist) { return Traveled(motions, dist); }
+
+/**
+ * @brief Wait until no motion is running or queued
+ *
+ * <h3> Example Usage </h3>
+ * @code
+ * co_await robot::idle(motions);
+ * motions.moveToPose(11, -4, 309, 1000);
+ * co_await robot::traveled(motions, 1);
+ * @endcode
+ */
+inline Idle idle(MotionWorker& motions) { return Idle(motions); }
+} // namespace robot
+#endif
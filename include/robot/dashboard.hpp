@@ -0,0 +1,138 @@
+/**
+ * @file include/robot/dashboard.hpp
+ * @brief Brain screen dashboard declarations
+ *
+ * The dashboard replaces pros::lcd::print polling. Each field keeps the last value it drew, quantized to its
+ * precision, and its label is only touched when that quantized value changes. All changed labels are written in one
+ * update() call so LVGL coalesces them into a single refresh.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include "display/lvgl.h"
+
+namespace robot {
+/**
+ * @brief Format a float with a fixed number of decimal places
+ *
+ * This is a replacement for printf("%.nf") on the hot path. It rounds to the nearest value and does not use any
+ * floating point formatting code.
+ *
+ * @param buffer buffer to write to. Always null terminated if size > 0
+ * @param size size of the buffer
+ * @param value value to format. Values too large for an int32 once scaled are clamped
+ * @param precision number of decimal places, from 0 to 4
+ * @return int - the number of characters written, not including the null terminator
+ */
+int formatFixed(char* buffer, int size, float value, int precision);
+
+/**
+ * @brief Quantize a float to an integer at the given decimal precision
+ *
+ * @param value value to quantize
+ * @param precision number of decimal places, from 0 to 4
+ * @return int32_t - value * 10^precision, rounded to the nearest integer and clamped
+ */
+int32_t quantize(float value, int precision);
+
+/**
+ * @brief Timing statistics for the dashboard
+ *
+ */
+struct DashboardStats {
+        /** number of update() calls */
+        uint32_t updates = 0;
+        /** number of label writes, which is the number of fields redrawn */
+        uint32_t labelWrites = 0;
+        /** total time spent in update(), in microseconds */
+        uint64_t totalMicros = 0;
+        /** longest update(), in microseconds */
+        uint32_t maxMicros = 0;
+};
+
+/**
+ * @brief Brain screen dashboard
+ *
+ * <h3> Example Usage </h3>
+ * @code
+ * robot::Dashboard dashboard;
+ * int x = dashboard.addField("X", 2);
+ * dashboard.init();
+ * // in a loop
+ * dashboard.set(x, chassis.getPose().x);
+ * dashboard.update();
+ * @endcode
+ */
+class Dashboard {
+    public:
+        /** @brief maximum number of fields on the dashboard */
+        static constexpr int MAX_FIELDS = 12;
+        /** @brief maximum length of a field's text, including the name */
+        static constexpr int TEXT_SIZE = 32;
+
+        Dashboard() = default;
+        Dashboard(const Dashboard&) = delete;
+        Dashboard& operator=(const Dashboard&) = delete;
+        /**
+         * @brief Add a field to the dashboard
+         *
+         * Fields are laid out top to bottom in the order they are added. Must be called before init()
+         *
+         * @param name name of the field. Must outlive the dashboard
+         * @param precision number of decimal places to display, from 0 to 4
+         * @return int - index of the field, or -1 if the dashboard is full
+         */
+        int addField(const char* name, int precision);
+        /**
+         * @brief Create the labels on the screen
+         *
+         * Must be called after the display is up, i.e. in initialize()
+         *
+         * @param parent parent object. The active screen if nullptr
+         */
+        void init(lv_obj_t* parent = nullptr);
+        /**
+         * @brief Set the value of a field
+         *
+         * This only stores the value. Nothing is drawn until update() is called
+         *
+         * @param field index of the field
+         * @param value new value
+         */
+        void set(int field, float value);
+        /**
+         * @brief Redraw all fields whose quantized value changed since the last update
+         *
+         * @return int - the number of fields redrawn
+         */
+        int update();
+        /**
+         * @brief Get the timing statistics of the dashboard
+         *
+         * @return DashboardStats
+         */
+        DashboardStats getStats() const;
+        /**
+         * @brief Reset the timing statistics
+         *
+         */
+        void resetStats();
+    private:
+        struct Field {
+                const char* name = nullptr;
+                int precision = 0;
+                int prefixLength = 0;
+                int32_t pending = 0;
+                int32_t drawn = 0;
+                float value = 0;
+                bool dirty = true;
+                lv_obj_t* label = nullptr;
+                char text[TEXT_SIZE] = {};
+        };
+
+        Field fields[MAX_FIELDS];
+        int fieldCount = 0;
+        DashboardStats stats;
+};
+} // namespace robot
@@ -0,0 +1,101 @@
+/**
+ * @file include/robot/doubleBuffer.hpp
+ * @brief Double buffered publishing of a value from one writer to any number of readers
+ *
+ * The writer fills one buffer while readers copy the other, then publishes it by bumping a sequence number. Readers
+ * never block the writer: value n is written to buffers[n % 2], and begun is bumped before the writer starts on it, so a
+ * reader whose copy of value n took long enough for the writer to begin value n + 2 in the same buffer notices and
+ * copies again. Sensor snapshots, poses, triball sets and config sets are all published this way.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+namespace robot {
+/**
+ * @brief A value published by one task and copied by any number of others without locks
+ *
+ * <h3> Example Usage </h3>
+ * @code
+ * robot::DoubleBuffer<Sample> samples;
+ * // in the writer
+ * uint32_t sequence;
+ * Sample& sample = samples.beginWrite(sequence);
+ * sample = {sequence, pros::millis(), reading};
+ * samples.publish();
+ * // in any task
+ * const Sample latest = samples.get();
+ * @endcode
+ */
+template <typename T> class DoubleBuffer {
+    public:
+        /**
+         * @brief Start writing the next value
+         *
+         * Only one task may write at a time. Readers keep copying the last published value until publish() is called
+         *
+         * @param sequence set to the sequence number of the new value, one more than the last published one
+         * @return T& - the buffer to write the value into. It holds the value published two before it
+         */
+        T& beginWrite(uint32_t& sequence) {
+            sequence = published + 1;
+            begun = sequence;
+            return buffers[sequence % 2];
+        }
+
+        /**
+         * @brief Publish the value started by beginWrite(), once it is complete
+         *
+         */
+        void publish() { published = begun.load(); }
+
+        /**
+         * @brief Copy the latest published value
+         *
+         * Never blocks the writer. Copies again if the writer came back around to the buffer during the copy
+         *
+         * @return T - the value, or a default constructed value before anything is published
+         */
+        T get() {
+            while (true) {
+                const uint32_t sequence = published;
+                const T value = buffers[sequence % 2];
+                // the buffer is only written again by value sequence + 2. If that hasn't begun, the copy is intact
+                std::atomic_thread_fence(std::memory_order_acquire);
+                if (begun - sequence < 2) return value;
+                retries++;
+            }
+        }
+
+        /**
+         * @brief Get the latest published value in place
+         *
+         * For the writer, which is the only task that changes the buffers, and for fields that are read in a single
+         * access. Writing through it changes the value readers are copying, so it is only done before anyone reads
+         *
+         * @return T& - the value
+         */
+        T& getLatest() { return buffers[published % 2]; }
+
+        /**
+         * @brief Get the sequence number of the latest published value
+         *
+         * @return uint32_t - the number of values published so far
+         */
+        uint32_t getSequence() { return published; }
+
+        /**
+         * @brief Get the number of times a reader had to copy again because the writer overwrote its copy
+         *
+         * @return uint32_t
+         */
+        uint32_t getRetries() { return retries; }
+    private:
+        std::atomic<uint32_t> begun {0};
+        std::atomic<uint32_t> published {0};
+        std::atomic<uint32_t> retries {0};
+        T buffers[2] = {};
+};
+} // namespace robot
@@ -0,0 +1,108 @@
+/**
+ * @file include/robot/fastMath.hpp
+ * @brief Fast trigonometry
+ *
+ * The brain has no hardware for sin, cos or atan2, and the soft float libm versions work in double precision for float
+ * arguments. The approximations here are float polynomials with a few multiplies each:
+ * - approxSinCos reduces the angle to within pi/4 of a multiple of pi/2 and evaluates a degree 7 sine and degree 8
+ * cosine polynomial. The error is under 1e-7 for angles within 1000 radians of 0, and grows with the angle after that
+ * as the reduction loses precision. Angles past 65536 radians, where the quadrant no longer fits the reduction, and NaN
+ * go to the standard library instead
+ * - approxAtan2 evaluates a degree 11 arctangent polynomial on the smaller of the two ratios. The error is under 2e-6
+ * radians, 1.2e-4 degrees. (0, 0) gives 0 like std::atan2
+ *
+ * sin, cos, sinCos and atan2 use the approximations when ROBOT_FAST_MATH is defined, e.g. by adding -DROBOT_FAST_MATH
+ * to EXTRA_CXXFLAGS in the Makefile, and the standard library otherwise. The benchmarks compare the two on the brain.
+ */
+
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+
+namespace robot {
+namespace fastmath {
+/**
+ * @brief Approximate the sine and cosine of an angle together
+ *
+ * @param angle angle, in radians
+ * @param sine set to the sine
+ * @param cosine set to the cosine
+ */
+inline void approxSinCos(float angle, float& sine, float& cosine) {
+    if (!(std::fabs(angle) <= 65536)) {
+        // the quadrant no longer fits the reduction below. libm reduces exactly, and no heading ever gets here
+        sine = std::sin(angle);
+        cosine = std::cos(angle);
+        return;
+    }
+    // angle = quadrant * pi/2 + r, with pi/2 split in three so the reduction stays exact for large quadrants
+    const int32_t nearest = static_cast<int32_t>(angle * 0.636619772f + (angle < 0 ? -0.5f : 0.5f));
+    const float quadrant = nearest;
+    const float r = ((angle - quadrant * 1.5703125f) - quadrant * 4.837512969970703125e-4f) -
+                    quadrant * 7.54978995489188216e-8f;
+    const float r2 = r * r;
+    // minimax polynomials on [-pi/4, pi/4], from Cephes' sinf and cosf
+    const float s = r + r * r2 * (-1.6666654611e-1f + r2 * (8.3321608736e-3f + r2 * -1.9515295891e-4f));
+    const float c = 1 - 0.5f * r2 + r2 * r2 * (4.166664568298827e-2f + r2 * (-1.388731625493765e-3f +
+                                                                             r2 * 2.443315711809948e-5f));
+    switch (nearest & 3) {
+        case 0: sine = s, cosine = c; break;
+        case 1: sine = c, cosine = -s; break;
+        case 2: sine = -s, cosine = -c; break;
+        default: sine = -c, cosine = s; break;
+    }
+}
+
+/**
+ * @brief Approximate the angle of a point from the +x axis
+ *
+ * @param y y coordinate of the point
+ * @param x x coordinate of the point
+ * @return float - angle, in radians from -pi to pi, counterclockwise positive like std::atan2
+ */
+inline float approxAtan2(float y, float x) {
+    const float ax = std::fabs(x);
+    const float ay = std::fabs(y);
+    const float largest = ax > ay ? ax : ay;
+    if (largest == 0) return 0;
+    // atan of a ratio in [0, 1], then unfold into the right octant
+    const float a = (ax < ay ? ax : ay) / largest;
+    const float s = a * a;
+    float angle = a * (0.99997726f + s * (-0.33262347f + s * (0.19354346f + s * (-0.11643287f + s * (0.05265332f +
+                                                                                                  s * -0.01172120f)))));
+    if (ay > ax) angle = 1.57079637f - angle;
+    if (x < 0) angle = 3.14159274f - angle;
+    return y < 0 ? -angle : angle;
+}
+
+#ifdef ROBOT_FAST_MATH
+inline void sinCos(float angle, float& sine, float& cosine) { approxSinCos(angle, sine, cosine); }
+
+inline float sin(float angle) {
+    float sine, cosine;
+    approxSinCos(angle, sine, cosine);
+    return sine;
+}
+
+inline float cos(float angle) {
+    float sine, cosine;
+    approxSinCos(angle, sine, cosine);
+    return cosine;
+}
+
+inline float atan2(float y, float x) { return approxAtan2(y, x); }
+#else
+inline void sinCos(float angle, float& sine, float& cosine) {
+    sine = std::sin(angle);
+    cosine = std::cos(angle);
+}
+
+inline float sin(float angle) { return std::sin(angle); }
+
+inline float cos(float angle) { return std::cos(angle); }
+
+inline float atan2(float y, float x) { return std::atan2(y, x); }
+#endif
+} // namespace fastmath
+} // namespace robot
@@ -0,0 +1,115 @@
+/**
+ * @file include/robot/fieldMap.hpp
+ * @brief Live field map declarations
+ *
+ * Draws the robot, the path being followed and the pure pursuit lookahead point on the brain screen. The robot and
+ * the lookahead point are small LVGL objects that are moved rather than redrawn, so LVGL only invalidates the
+ * rectangles around their old and new positions. Nothing is invalidated while the robot is still.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include "display/lvgl.h"
+#include "pros/rtos.hpp"
+#include "lemlib/asset.hpp"
+#include "lemlib/pose.hpp"
+#include "robot/path.hpp"
+
+namespace robot {
+/**
+ * @brief Live field map
+ *
+ * setPath() may be called from any task. init() and update() must be called from the same task, since LVGL is not
+ * thread safe.
+ *
+ * <h3> Example Usage </h3>
+ * @code
+ * robot::FieldMap fieldMap;
+ * fieldMap.init(250, 10, 220);
+ * // in autonomous
+ * motions.follow(path, 15, 3000);
+ * const uint32_t motion = motions.getStats().motions;
+ * fieldMap.setPath(path, 15, [motion]() { return motions.getStats().finished < motion; });
+ * // in the screen task
+ * fieldMap.update(lemlib::getPose());
+ * @endcode
+ */
+class FieldMap {
+    public:
+        /** @brief maximum number of path waypoints drawn. Longer paths are decimated */
+        static constexpr int MAX_PATH_POINTS = 64;
+        /** @brief maximum number of waypoints used to find the lookahead point */
+        static constexpr int MAX_WAYPOINTS = 256;
+        /** @brief side length of the field, in inches */
+        static constexpr float FIELD_SIZE = 144;
+
+        FieldMap() = default;
+        FieldMap(const FieldMap&) = delete;
+        FieldMap& operator=(const FieldMap&) = delete;
+        /**
+         * @brief Create the map on the screen
+         *
+         * @param x x position of the map on the screen, in pixels
+         * @param y y position of the map on the screen, in pixels
+         * @param size side length of the map, in pixels
+         * @param parent parent object. The active screen if nullptr
+         */
+        void init(lv_coord_t x, lv_coord_t y, lv_coord_t size, lv_obj_t* parent = nullptr);
+        /**
+         * @brief Set the path being followed
+         *
+         * The path is drawn on the next update(), and cleared by the first update() after the motion following it
+         * ends
+         *
+         * @param path the path asset
+         * @param lookahead the lookahead distance used to follow it, in inches
+         * @param following whether the motion following the path is still running. Called by update(). If empty,
+         * the path stays until clearPath() or the next setPath()
+         */
+        void setPath(const asset& path, float lookahead, std::function<bool()> following = nullptr);
+        /**
+         * @brief Stop showing the path and lookahead point
+         *
+         */
+        void clearPath();
+        /**
+         * @brief Move the robot and lookahead point on the map
+         *
+         * @param pose pose of the robot, theta in degrees
+         */
+        void update(lemlib::Pose pose);
+    private:
+        /**
+         * @brief Convert a field position to a position on the map
+         *
+         */
+        lv_point_t toScreen(float x, float y) const;
+        void applyPath();
+
+        lv_obj_t* field = nullptr;
+        lv_obj_t* pathLine = nullptr;
+        lv_obj_t* robot = nullptr;
+        lv_obj_t* heading = nullptr;
+        lv_obj_t* lookahead = nullptr;
+        lv_coord_t size = 0;
+        float scale = 1;
+
+        // LVGL keeps pointers to line points, so they live here rather than in LVGL's heap
+        lv_point_t pathPoints[MAX_PATH_POINTS];
+        lv_point_t headingPoints[2];
+        lv_point_t drawnRobot = {-1, -1};
+        lv_point_t drawnHeading = {-1, -1};
+        lv_point_t drawnLookahead = {-1, -1};
+
+        // waypoints of the active path, written by setPath() and read by update()
+        pros::Mutex mutex;
+        PathPoint waypoints[MAX_WAYPOINTS];
+        int waypointCount = 0;
+        int closest = 0;
+        float lookaheadDist = 0;
+        std::function<bool()> following;
+        bool pathChanged = false;
+};
+} // namespace robot
@@ -0,0 +1,37 @@
+/**
+ * @file include/robot/freertos.hpp
+ * @brief FreeRTOS declarations the PROS kernel exports but does not put in its headers
+ */
+
+#pragma once
+
+#include <cstdint>
+#include "pros/apix.h"
+
+extern "C" {
+/**
+ * FreeRTOS 10 TaskStatus_t, as laid out by the PROS kernel. The kernel only exports the functions that use it, not
+ * the header that declares it.
+ */
+struct FreeRTOSTaskStatus {
+        pros::task_t handle;
+        const char* name;
+        uint32_t number;
+        pros::task_state_e_t state;
+        uint32_t currentPriority;
+        uint32_t basePriority;
+        uint32_t runTimeCounter;
+        void* stackBase;
+        uint16_t stackHighWaterMark;
+};
+
+/**
+ * @brief Get the status of every task
+ *
+ * @param statuses array to fill
+ * @param size size of the array
+ * @param totalRunTime set to the total run time counter, if not nullptr
+ * @return uint32_t - the number of statuses filled in
+ */
+uint32_t uxTaskGetSystemState(FreeRTOSTaskStatus* const statuses, const uint32_t size, uint32_t* const totalRunTime);
+}
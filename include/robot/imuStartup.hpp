@@ -0,0 +1,234 @@
+/**
+ * @file include/robot/imuStartup.hpp
+ * @brief Inertial sensor startup declarations
+ *
+ * chassis.calibrate() resets the inertial sensor and blocks for its whole calibration, around 3 seconds, before
+ * odometry starts. ImuStartup runs the calibration in its own task instead, and autonomous waits on it only if it
+ * hasn't finished by then.
+ *
+ * The sensor already calibrates itself when it powers on, and the brain can't hand it a bias, so there is no way to
+ * skip its calibration and keep its accuracy exactly. What is left after its calibration is a slow drift, which the
+ * sensor can't correct but software can. CorrectedImu subtracts that drift from every rotation and heading it reports.
+ * While the robot is disabled and sits still, ImuStartup measures the drift and refines the estimate, and saves it to
+ * the SD card.
+ *
+ * In fast start mode, ImuStartup skips the reset when a saved drift exists, keeps the sensor's power on calibration
+ * and corrects the drift it saved last time, so odometry starts as soon as the sensor is up instead of seconds later.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include "lemlib/chassis/chassis.hpp"
+#include "pros/imu.hpp"
+#include "pros/rtos.hpp"
+
+namespace robot {
+/** @brief version of the saved drift format */
+constexpr uint16_t IMU_DRIFT_VERSION = 1;
+
+/**
+ * @brief Drift estimate saved on the SD card
+ *
+ */
+struct ImuDriftFile {
+        /** "RIMU" */
+        char magic[4];
+        /** IMU_DRIFT_VERSION */
+        uint16_t version;
+        /** smart port of the sensor the drift was measured on */
+        uint16_t port;
+        /** drift, in degrees per second. Positive if the reported rotation creeps up */
+        float drift;
+        /** total time the drift was measured over, in seconds */
+        float measured;
+};
+
+static_assert(sizeof(ImuDriftFile) == 16, "imu drift file layout changed");
+
+/**
+ * @brief Inertial sensor that subtracts a constant drift from its rotation and heading
+ *
+ * Can be used anywhere a pros::Imu is, including in lemlib::OdomSensors. Resetting, taring or setting the rotation or
+ * heading restarts the correction from that point
+ *
+ * <h3> Example Usage </h3>
+ * @code
+ * robot::CorrectedImu imu(17);
+ * imu.setDrift(0.002);
+ * double rotation = imu.get_rotation();
+ * @endcode
+ */
+class CorrectedImu : public pros::Imu {
+    public:
+        /**
+         * @brief Construct a new Corrected IMU
+         *
+         * @param port smart port of the sensor
+         */
+        explicit CorrectedImu(uint8_t port);
+        double get_rotation() const override;
+        double get_heading() const override;
+        std::int32_t reset(bool blocking = false) const override;
+        std::int32_t tare_rotation() const override;
+        std::int32_t tare_heading() const override;
+        std::int32_t set_rotation(const double target) const override;
+        std::int32_t set_heading(const double target) const override;
+        /**
+         * @brief Get the rotation without the drift correction
+         *
+         * @return double - rotation, in degrees. PROS_ERR_F if the sensor can't be read
+         */
+        double getRawRotation() const;
+        /**
+         * @brief Set the drift to correct from now on
+         *
+         * The correction built up so far is kept
+         *
+         * @param drift drift, in degrees per second
+         */
+        void setDrift(float drift);
+        /**
+         * @brief Get the drift being corrected
+         *
+         * @return float - drift, in degrees per second
+         */
+        float getDrift() const;
+        /**
+         * @brief Get the correction subtracted from the rotation right now
+         *
+         * @return double - correction, in degrees
+         */
+        double getCorrection() const;
+        /**
+         * @brief Drop the correction built up so far, and correct from now on
+         *
+         * For when the sensor's rotation was reset outside this class
+         */
+        void resetCorrection() const;
+        /**
+         * @brief Get the smart port of the sensor
+         *
+         * @return uint8_t
+         */
+        uint8_t getPort() const;
+    private:
+        const uint8_t port;
+        // correction built up until since, in degrees, and time since, in milliseconds
+        mutable pros::Mutex mutex;
+        mutable double correction = 0;
+        mutable uint32_t since = 0;
+        float drift = 0;
+};
+
+/**
+ * @brief Calibrates the inertial sensor and starts odometry without blocking
+ *
+ * <h3> Example Usage </h3>
+ * @code
+ * robot::ImuStartup imuStartup(chassis, imu, drivetrain, "/usd/imu.bin");
+ * // in competition_initialize
+ * imuStartup.start(true);
+ * // in autonomous
+ * imuStartup.waitUntilReady(3000);
+ * // in disabled
+ * imuStartup.save();
+ * @endcode
+ */
+class ImuStartup {
+    public:
+        /** @brief time the drivetrain has to stay still for a drift measurement, in milliseconds */
+        static constexpr uint32_t WINDOW = 2000;
+        /** @brief fastest drive motor speed that still counts as still, in rpm */
+        static constexpr float STILL_VELOCITY = 1;
+        /** @brief largest drift a measurement can give, in degrees per second. A window that turned faster than this
+         * was the robot being moved, and is thrown away */
+        static constexpr float MAX_DRIFT = 0.1;
+        /** @brief weight of each new measurement in the drift estimate */
+        static constexpr float SMOOTHING = 0.2;
+
+        /**
+         * @brief Construct a new IMU Startup
+         *
+         * @param chassis the chassis. Must outlive the startup
+         * @param imu the sensor the chassis uses. Must outlive the startup
+         * @param drivetrain the drivetrain, watched to tell when the robot is still
+         * @param path path of the saved drift on the SD card, e.g. "/usd/imu.bin"
+         */
+        ImuStartup(lemlib::Chassis& chassis, CorrectedImu& imu, const lemlib::Drivetrain& drivetrain, const char* path);
+        ImuStartup(const ImuStartup&) = delete;
+        ImuStartup& operator=(const ImuStartup&) = delete;
+        /**
+         * @brief Start calibrating in the "imu startup" task and return straight away
+         *
+         * The task calibrates the chassis, which starts odometry, and then keeps measuring the drift whenever the
+         * robot is disabled and still. Does nothing if it was already started
+         *
+         * @param fastStart skip resetting the sensor if a drift for it was saved, and correct that drift instead
+         */
+        void start(bool fastStart);
+        /**
+         * @brief Whether calibration has finished and odometry is running
+         *
+         * @return true the chassis is ready
+         * @return false calibration is still running, or hasn't started
+         */
+        bool isReady();
+        /**
+         * @brief Block until calibration has finished
+         *
+         * @param timeout longest time to wait, in milliseconds
+         * @return true the chassis is ready
+         * @return false the timeout expired first
+         */
+        bool waitUntilReady(uint32_t timeout);
+        /**
+         * @brief Whether the last start skipped the reset and used a saved drift
+         *
+         * @return true the saved drift was used
+         * @return false the sensor was reset
+         */
+        bool usedSavedDrift();
+        /**
+         * @brief Save the drift estimate to the SD card
+         *
+         * Should be called while disabled, since writing to the SD card is slow. Does nothing until a drift has been
+         * measured since startup
+         *
+         * @return true the drift was saved
+         * @return false nothing new was measured, or the file could not be written
+         */
+        bool save();
+    private:
+        /**
+         * @brief Read the saved drift
+         *
+         * @return true a drift for this sensor was read into drift and measured
+         */
+        bool load();
+        /**
+         * @brief Calibrate, then measure the drift forever. Run by the startup task
+         *
+         */
+        void run(bool fastStart);
+        /**
+         * @brief Whether every drive motor is still
+         *
+         */
+        bool still();
+
+        lemlib::Chassis& chassis;
+        CorrectedImu& imu;
+        const lemlib::Drivetrain drivetrain;
+        const char* path;
+        pros::Task* task = nullptr;
+        std::atomic<bool> ready {false};
+        std::atomic<bool> savedDriftUsed {false};
+        // drift estimate and the total time it was measured over, in seconds
+        std::atomic<float> drift {0};
+        std::atomic<float> measured {0};
+        // whether a measurement was made since the drift was last loaded or saved
+        std::atomic<bool> unsaved {false};
+};
+} // namespace robot
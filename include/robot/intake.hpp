@@ -0,0 +1,208 @@
+/**
+ * @file include/robot/intake.hpp
+ * @brief Intake subsystem declarations
+ *
+ * Run by hand, the intake keeps spinning after a triball is in until someone notices, and autonomous has to guess how
+ * long to run it for. The intake subsystem watches an optical sensor in the intake instead, and decides the motor
+ * power from every sample it reads:
+ * - an object is in the intake once its proximity reaches enterProximity, and has left once it drops below
+ * exitProximity. The gap between the two keeps a triball sitting at the edge from flickering in and out
+ * - while intaking, the intake stops as soon as a triball enters and holds it. An object whose hue isn't a triball's
+ * is spit back out, with the intake reversed until it leaves
+ * - while outtaking, the intake runs backwards until it is stopped
+ *
+ * The sensor is set to its shortest integration time, 3ms, so the value it sends is at most 3ms old. It still only
+ * sends one every 10ms, with every other device, and reading it more often than that reads the same value again. The
+ * "intake" task reads it once per device update, moved to just after each update the way the sensor hub does, using
+ * the intake motor's update timestamp, and writes the motor in the same step. The motor applies the new power at the
+ * next device update. An edge is seen after up to 3ms of integration and 10ms until the next update, read 1ms after
+ * that, and applied up to 10ms later, so the intake reacts within 24ms of an edge. Every triball that enters and
+ * leaves again counts as a cycle.
+ *
+ * process() takes a sample and returns the motor power without reading or writing any device, so recorded sensor
+ * traces can be replayed through it on the host.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include "pros/motors.hpp"
+#include "pros/optical.hpp"
+#include "pros/rtos.hpp"
+#include "robot/clock.hpp"
+
+namespace robot {
+/**
+ * @brief What the intake has been told to do
+ *
+ */
+enum class IntakeMode { STOP, INTAKE, OUTTAKE };
+
+/**
+ * @brief Thresholds of the intake's optical sensor
+ *
+ */
+struct IntakeSettings {
+        /** proximity at which an object is in the intake, from 0 to 255 */
+        int32_t enterProximity = 150;
+        /** proximity below which an object has left the intake, from 0 to 255 */
+        int32_t exitProximity = 100;
+        /** lowest hue of a triball, in degrees */
+        double minHue = 70;
+        /** highest hue of a triball, in degrees */
+        double maxHue = 150;
+        /** power to run the intake at, from 0 to 127 */
+        int32_t power = 127;
+};
+
+/**
+ * @brief One reading of the optical sensor
+ *
+ */
+struct OpticalSample {
+        /** time the sensor was read, in microseconds */
+        uint64_t micros;
+        /** proximity, from 0 to 255 */
+        int32_t proximity;
+        /** hue, in degrees from 0 to 360 */
+        double hue;
+};
+
+/**
+ * @brief Triballs through the intake so far
+ *
+ */
+struct IntakeStats {
+        /** number of objects that entered the intake */
+        uint32_t entries;
+        /** number of objects that left the intake */
+        uint32_t exits;
+        /** number of triballs that entered and then left the intake */
+        uint32_t cycles;
+        /** number of objects that weren't triballs and were spit back out */
+        uint32_t rejects;
+        /** time the last triball spent in the intake, in milliseconds */
+        uint32_t lastCycleTime;
+        /** longest time from reading a sample to writing the motor power it changed, in microseconds */
+        uint32_t maxReactionMicros;
+};
+
+/**
+ * @brief Runs the intake from an optical sensor
+ *
+ * <h3> Example Usage </h3>
+ * @code
+ * pros::Motor intake(14, pros::E_MOTOR_GEARSET_06);
+ * pros::Optical intakeOptical(10);
+ * robot::Intake triballIntake(&intake, &intakeOptical);
+ * triballIntake.start();
+ * // stops by itself once a triball is in
+ * triballIntake.intake();
+ * @endcode
+ */
+class Intake {
+    public:
+        /** @brief integration time of the optical sensor, in milliseconds */
+        static constexpr uint32_t INTEGRATION_TIME = 3;
+        /** @brief time between device updates, and between samples, in milliseconds */
+        static constexpr uint32_t DEVICE_PERIOD = 10;
+        /** @brief time after a device update to read the sensor at, in milliseconds */
+        static constexpr uint32_t PHASE_TARGET = 1;
+
+        /**
+         * @brief Construct a new Intake
+         *
+         * @param motor the intake motor. Must outlive the intake
+         * @param sensor the optical sensor in the intake. Must outlive the intake. nullptr without one, which reads as
+         * an empty intake, so the intake runs like a manual one
+         * @param settings thresholds of the sensor
+         * @param clock clock to time samples with. Must outlive the intake
+         */
+        Intake(pros::Motor* motor, pros::Optical* sensor, const IntakeSettings& settings = {},
+               Clock& clock = systemClock());
+        Intake(const Intake&) = delete;
+        Intake& operator=(const Intake&) = delete;
+        /**
+         * @brief Set up the sensor and start the "intake" task
+         *
+         */
+        void start();
+        /**
+         * @brief Run the intake until a triball is in it
+         *
+         * Returns straight away. Does nothing more if a triball is already held
+         */
+        void intake();
+        /**
+         * @brief Run the intake backwards until stopped
+         *
+         */
+        void outtake();
+        /**
+         * @brief Stop the intake
+         *
+         */
+        void stop();
+        /**
+         * @brief Get what the intake has been told to do
+         *
+         * @return IntakeMode
+         */
+        IntakeMode getMode();
+        /**
+         * @brief Whether a triball is in the intake
+         *
+         * @return true a triball entered and hasn't left
+         * @return false the intake is empty, or holds something that isn't a triball
+         */
+        bool isHolding();
+        /**
+         * @brief Read a sample, process it and write the motor power if it changed
+         *
+         * Called by the intake task once per device update
+         */
+        void update();
+        /**
+         * @brief Read the optical sensor
+         *
+         * @return OpticalSample
+         */
+        OpticalSample read();
+        /**
+         * @brief Find the edges in a sample and decide the motor power
+         *
+         * Only one task may process samples
+         *
+         * @param sample the sample. Samples must be processed in order of time
+         * @return int32_t - motor power, from -127 to 127
+         */
+        int32_t process(const OpticalSample& sample);
+        /**
+         * @brief Get the triballs through the intake so far
+         *
+         * @return IntakeStats
+         */
+        IntakeStats getStats();
+    private:
+        pros::Motor* const motor;
+        pros::Optical* const sensor;
+        const IntakeSettings settings;
+        Clock& clock;
+        pros::Task* task = nullptr;
+        std::atomic<IntakeMode> mode {IntakeMode::STOP};
+        // whether an object is in the intake, and whether it is a triball, judged by its hue when it entered
+        bool present = false;
+        std::atomic<bool> triball {false};
+        uint64_t enteredAt = 0;
+        // last power written to the motor, so it is only written when it changes
+        int32_t lastPower = 0;
+        bool written = false;
+        std::atomic<uint32_t> entries {0};
+        std::atomic<uint32_t> exits {0};
+        std::atomic<uint32_t> cycles {0};
+        std::atomic<uint32_t> rejects {0};
+        std::atomic<uint32_t> lastCycleTime {0};
+        std::atomic<uint32_t> maxReactionMicros {0};
+};
+} // namespace robot
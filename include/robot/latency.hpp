@@ -0,0 +1,100 @@
+/**
+ * @file include/robot/latency.hpp
+ * @brief Latency histogram declarations
+ *
+ * Latency measurement is compiled out unless ROBOT_LATENCY is defined, e.g. by adding -DROBOT_LATENCY to
+ * EXTRA_CXXFLAGS in the Makefile. When compiled out, every method of LatencyHistogram does nothing.
+ *
+ * When compiled in, each histogram counts samples in fixed 250us buckets, so adding a sample is one increment and
+ * never allocates. The report gives the median, 90th and 99th percentiles and the maximum, at bucket resolution.
+ *
+ * <h3> Example Usage </h3>
+ * @code
+ * robot::LatencyHistogram latency;
+ * while (true) {
+ *     const uint64_t start = pros::micros();
+ *     update();
+ *     latency.add(pros::micros() - start);
+ *     pros::delay(10);
+ * }
+ * // later, when the robot is disabled
+ * latency.report("update");
+ * @endcode
+ */
+
+#pragma once
+
+#include <cstdint>
+
+namespace robot {
+#ifdef ROBOT_LATENCY
+/**
+ * @brief Distribution of latencies
+ *
+ */
+class LatencyHistogram {
+    public:
+        /** @brief width of each bucket, in microseconds */
+        static constexpr uint32_t BUCKET_MICROS = 250;
+        /** @brief number of buckets. Samples past the last bucket are counted in it */
+        static constexpr int BUCKETS = 100;
+
+        /**
+         * @brief Add a sample
+         *
+         * @param micros latency, in microseconds
+         */
+        void add(uint32_t micros);
+        /**
+         * @brief Get a percentile of the samples
+         *
+         * @param percent percentile, from 0 to 100
+         * @return uint32_t - upper edge of the bucket the percentile falls in, in microseconds. 0 if there are no
+         * samples
+         */
+        uint32_t percentile(float percent);
+        /**
+         * @brief Get the number of samples
+         *
+         * @return uint32_t
+         */
+        uint32_t getCount();
+        /**
+         * @brief Get the largest sample
+         *
+         * @return uint32_t - latency, in microseconds
+         */
+        uint32_t getMax();
+        /**
+         * @brief Log the distribution through the info sink, at debug level
+         *
+         * @param name what was measured
+         */
+        void report(const char* name);
+        /**
+         * @brief Remove every sample
+         *
+         */
+        void reset();
+    private:
+        uint32_t buckets[BUCKETS] = {};
+        uint32_t count = 0;
+        uint32_t max = 0;
+};
+#else
+class LatencyHistogram {
+    public:
+        void add(uint32_t) {}
+
+        uint32_t percentile(float) { return 0; }
+
+        uint32_t getCount() { return 0; }
+
+        uint32_t getMax() { return 0; }
+
+        void report(const char*) {}
+
+        void reset() {}
+};
+#endif
+} // namespace robot
@@ -0,0 +1,437 @@
+/**
+ * @file include/robot/motionWorker.hpp
+ * @brief Motion worker declarations
+ *
+ * LemLib runs each async motion in a new task: every call allocates a task and its stack, and then sleeps the caller
+ * while the task starts. The motion worker runs every motion in one task created up front, fed from a preallocated
+ * queue. The task is "motion" in the task registry, so motions also run at control priority instead of the default.
+ *
+ * The motions are the chassis' turnTo, moveToPoint, moveToPose and follow, with the same parameters and LemLib's
+ * control laws, but run by the worker itself rather than by the chassis so they can be stopped: LemLib's motions
+ * can't be. Each iteration of a motion's loop starts by checking whether the motion was cancelled, and between
+ * iterations the worker sleeps on its task notification, which a cancellation sends. A cancelled motion ends straight
+ * away, the way a motion that settled does, and the worker goes on to the next queued motion. Nothing is deleted and
+ * the chassis is never touched, so a motion can be cancelled at any point. The controllers are robot::Pid, so a late
+ * iteration doesn't inflate the derivative term. Timeouts, settling, stalls and latency are measured in microseconds
+ * on a robot::Clock as well, and only the sleeps between iterations count RTOS ticks.
+ *
+ * Motion calls behave the same as LemLib's async ones: a call waits for the motions before it to finish, and returns
+ * as soon as its own motion has started. Until then the motion waits in the queue, so calls from several tasks run in
+ * the order they were made.
+ *
+ * LemLib's waitUntil sleeps 10ms at a time until the distance traveled passes the threshold, so whatever follows it
+ * runs up to a whole period late. While a motion runs, the "motion progress" task measures the distance traveled the
+ * same way the chassis does, every millisecond so it sees each odometry update within a millisecond of it, and
+ * notifies the tasks waiting on a threshold as soon as it is crossed. Waiting tasks are blocked until then and use no
+ * cpu, and the progress task sleeps whenever no motion is running.
+ *
+ * The progress task also watches the drivetrain for stalls, and cancels a motion that is pushing against something it
+ * can't move. Every motion logs why it ended through the telemetry sink.
+ *
+ * Where the motions differ from LemLib's:
+ * - kD acts on the change in error per second of measured time, scaled so it matches LemLib's at exactly 10ms
+ * - a settle range's timer restarts whenever the error leaves the range. LemLib's FAPID::settled keeps counting from
+ *   the first time the error entered it
+ * - timeouts count from when the worker starts the motion, not from the call
+ * - moveToPoint and moveToPose stop steering towards the target, and stop speeding up, once within SETTLE_DISTANCE,
+ *   and moveToPose turns to the target heading from there
+ * - follow reads at most MAX_PATH_POINTS waypoints, and ends as soon as the closest waypoint is the last one or has a
+ *   speed of 0, without a settle time
+ * - follow steers with the worker's track width, which setControllerSettings changes along with the gains while a
+ *   motion runs. LemLib's chassis keeps the settings it was constructed with
+ * - waitUntil sees the distance traveled every millisecond rather than every 10ms, and a motion can end early by
+ *   being cancelled or stalling
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include "lemlib/asset.hpp"
+#include "lemlib/chassis/chassis.hpp"
+#include "pros/rtos.hpp"
+#include "robot/clock.hpp"
+#include "robot/path.hpp"
+
+namespace robot {
+class TriballTracker;
+
+/**
+ * @brief Startup latency of the motions run so far
+ *
+ */
+struct MotionStats {
+        /** number of motions started */
+        uint32_t motions;
+        /** average time from a motion being able to start to the worker starting it, in microseconds. A motion can
+         * start once it is queued and the motion before it has finished */
+        uint32_t averageLatency;
+        /** longest time from a motion being able to start to the worker starting it, in microseconds */
+        uint32_t maxLatency;
+        /** number of motions ended, including queued motions that were cancelled before they started */
+        uint32_t finished;
+};
+
+/**
+ * @brief Why a motion ended
+ *
+ * SETTLED if the chassis reached the target, TIMEOUT if the motion ran for its whole timeout, CANCELLED if
+ * cancelMotion() or cancelAllMotions() stopped it, and STALLED if the drivetrain stalled
+ */
+enum class MotionEnd { SETTLED, TIMEOUT, CANCELLED, STALLED };
+
+/**
+ * @brief When the drivetrain counts as stalled
+ *
+ * The drivetrain is stalled while its average speed is below maxVelocity and its average current draw is above
+ * minCurrent. A motion that stays stalled for stallTime is cancelled
+ */
+struct StallSettings {
+        /** average motor speed below which the drivetrain may be stalled, in rpm. 0 disables stall detection */
+        float maxVelocity;
+        /** average motor current above which the drivetrain may be stalled, in milliamps */
+        int32_t minCurrent;
+        /** time the drivetrain has to stay stalled before the motion is cancelled, in milliseconds */
+        uint32_t stallTime;
+        /** time after a motion starts before stalls are checked, so the drivetrain can speed up, in milliseconds */
+        uint32_t grace;
+};
+
+/**
+ * @brief Runs the motions of a chassis in one persistent task
+ *
+ * <h3> Example Usage </h3>
+ * @code
+ * robot::MotionWorker motions(drivetrain, linearController, angularController);
+ * motions.setStallDetection({30, 1800, 200, 300});
+ * motions.moveToPose(11, -4, 309, 1000);
+ * motions.waitUntil(1);
+ * wings.set_value(false);
+ * motions.waitUntilDone();
+ * @endcode
+ */
+class MotionWorker {
+    public:
+        /** @brief number of motions that can wait to run at once */
+        static constexpr int QUEUE_SIZE = 4;
+        /** @brief number of tasks that can wait on motions at once */
+        static constexpr int MAX_WAITERS = 8;
+        /** @brief maximum number of path waypoints follow() uses. Waypoints past this are dropped */
+        static constexpr int MAX_PATH_POINTS = 256;
+        /** @brief distance from the target within which moves stop steering and settle, in inches, as in LemLib */
+        static constexpr float SETTLE_DISTANCE = 7.5;
+
+        /**
+         * @brief Construct a new Motion Worker
+         *
+         * Motions read the pose from LemLib's odometry, so the chassis has to be calibrated before they run
+         *
+         * @param drivetrain the drivetrain the motions drive, and watch for stalls
+         * @param linear settings of the distance controller, the same as the chassis'
+         * @param angular settings of the heading controller, the same as the chassis'
+         * @param clock clock to time the motions with. Must outlive the worker
+         */
+        MotionWorker(const lemlib::Drivetrain& drivetrain, const lemlib::ControllerSettings& linear,
+                     const lemlib::ControllerSettings& angular, Clock& clock = systemClock());
+        MotionWorker(const MotionWorker&) = delete;
+        MotionWorker& operator=(const MotionWorker&) = delete;
+        /**
+         * @brief Create the worker tasks
+         *
+         * Creates the motion and motion progress tasks. Called by the first motion if it hasn't been already. Calling
+         * it in initialize() keeps the task creation out of autonomous
+         */
+        void start();
+        /**
+         * @brief Turn the chassis so it is facing the target point
+         *
+         * The parameters are the same as lemlib::Chassis::turnTo
+         */
+        void turnTo(float x, float y, int timeout, bool forwards = true, float maxSpeed = 127);
+        /**
+         * @brief Move the chassis towards the target pose
+         *
+         * The parameters are the same as lemlib::Chassis::moveToPose
+         */
+        void moveToPose(float x, float y, float theta, int timeout, bool forwards = true, float chasePower = 0,
+                        float lead = 0.6, float maxSpeed = 127);
+        /**
+         * @brief Move the chassis towards a target point
+         *
+         * The parameters are the same as lemlib::Chassis::moveToPoint
+         */
+        void moveToPoint(float x, float y, int timeout, bool forwards = true, float maxSpeed = 127);
+        /**
+         * @brief Move the chassis to the confirmed triball nearest to it
+         *
+         * The target is where the tracker estimates the triball is when the motion is queued. It doesn't follow the
+         * triball if it moves afterwards
+         *
+         * @param tracker the triball tracker
+         * @param timeout longest time the motion can run for, in milliseconds
+         * @param stopShort distance to stop before the center of the triball, in inches, so the intake reaches it
+         * rather than the tracking center
+         * @param maxSpeed the maximum speed the chassis can move at, from 0 to 127
+         * @return uint32_t - id of the triball, or 0 if the tracker has none and no motion was queued
+         */
+        uint32_t moveToNearestTriball(TriballTracker& tracker, int timeout, float stopShort = 0, float maxSpeed = 127);
+        /**
+         * @brief Move the chassis along a path
+         *
+         * The parameters are the same as lemlib::Chassis::follow
+         *
+         * @param path the path asset. Must outlive the motion, which ASSET globals do
+         */
+        void follow(const asset& path, float lookahead, int timeout, bool forwards = true);
+        /**
+         * @brief Wait until the robot has traveled a certain distance in the current motion
+         *
+         * Returns when the distance is passed or the motion ends, whichever comes first
+         *
+         * @param dist distance, in inches for moves and degrees for turns
+         */
+        void waitUntil(float dist);
+        /**
+         * @brief Whether the robot has traveled a certain distance in the current motion
+         *
+         * The same condition waitUntil waits for, for callers that can't block
+         *
+         * @param dist distance, in inches for moves and degrees for turns
+         * @return true the distance was passed, the motion ended, or no motion was started
+         * @return false the current motion hasn't traveled that far yet
+         */
+        bool hasTraveled(float dist);
+        /**
+         * @brief Wait until every queued motion has finished
+         *
+         */
+        void waitUntilDone();
+        /**
+         * @brief Get the distance traveled in the current motion
+         *
+         * Updated every millisecond while a motion runs
+         *
+         * @return float - distance, in inches for moves and degrees for turns. -1 if no motion is running
+         */
+        float getProgress();
+        /**
+         * @brief Cancel the current motion
+         *
+         * Returns once the motion has stopped, which it does as soon as the worker task runs. The next queued motion
+         * starts straight away. If nothing is queued the drivetrain is stopped. Waiting tasks see the motion as ended
+         *
+         * @return true a motion was cancelled
+         * @return false no motion was running
+         */
+        bool cancelMotion();
+        /**
+         * @brief Cancel the current motion and every queued motion
+         *
+         * Returns once every cancelled motion has ended. Motions queued after this call run as usual
+         *
+         * @return int - the number of motions cancelled
+         */
+        int cancelAllMotions();
+        /**
+         * @brief Set the controller settings the motions use
+         *
+         * The running motion picks them up on its next iteration, keeping its controllers' state, and every motion
+         * after it starts with them. May be called from any task
+         *
+         * @param linear settings of the distance controller
+         * @param angular settings of the heading controller
+         * @param trackWidth distance between the wheels on each side, in inches, which follow steers with. Odometry
+         * keeps the track width the chassis was calibrated with
+         */
+        void setControllerSettings(const lemlib::ControllerSettings& linear, const lemlib::ControllerSettings& angular,
+                                   float trackWidth);
+        /**
+         * @brief Set when the drivetrain counts as stalled
+         *
+         * Stall detection is off until this is called. Should be called before motions start
+         *
+         * @param settings the stall settings
+         */
+        void setStallDetection(const StallSettings& settings);
+        /**
+         * @brief Get why the last motion ended
+         *
+         * @return MotionEnd - SETTLED if no motion has ended yet
+         */
+        MotionEnd getLastEnd();
+        /**
+         * @brief Whether a motion is running or queued
+         *
+         * @return true the chassis is busy
+         * @return false the chassis is idle
+         */
+        bool isBusy();
+        /**
+         * @brief Get the startup latency of the motions run so far
+         *
+         * @return MotionStats
+         */
+        MotionStats getStats();
+    private:
+        struct Command {
+                enum class Type { TURN_TO, MOVE_TO_POSE, MOVE_TO_POINT, FOLLOW };
+
+                Type type;
+                float x;
+                float y;
+                float theta;
+                int timeout;
+                bool forwards;
+                float chasePower;
+                float lead;
+                float maxSpeed;
+                const asset* path;
+                // task that queued the command, notified when it starts and when it finishes
+                pros::task_t caller;
+                // time the command was queued, in microseconds on the clock
+                uint64_t queued;
+        };
+
+        /**
+         * @brief Queue a command and wait for it to start
+         *
+         */
+        void run(Command command);
+        struct Waiter {
+                // waiting task, nullptr if the slot is free
+                pros::task_t task;
+                // index of the motion waited on
+                uint32_t motion;
+                // distance to wait for, or infinity to wait for the end of the motion
+                float threshold;
+                std::atomic<bool> woken;
+        };
+
+        /**
+         * @brief Whether a motion has passed a distance or ended
+         *
+         */
+        bool reached(uint32_t motion, float threshold);
+        /**
+         * @brief Block until a motion has passed a distance or ended
+         *
+         */
+        void wait(uint32_t motion, float threshold);
+        /**
+         * @brief Notify every waiting task whose motion has passed its distance or ended
+         *
+         */
+        void wakeWaiters();
+        /**
+         * @brief Measure the distance traveled in each motion. Only run by the motion progress task
+         *
+         */
+        void trackProgress();
+        /**
+         * @brief Start the queued commands as they come in. Run by the worker task
+         *
+         */
+        void work();
+        /**
+         * @brief Run a command, blocking until the motion ends
+         *
+         * Only called by the worker task
+         *
+         * @return MotionEnd - why the motion ended
+         */
+        MotionEnd execute(uint32_t motion, const Command& command);
+        /**
+         * @brief The loop of each kind of motion, run until it settles, times out or is stopped
+         *
+         */
+        MotionEnd turnToLoop(uint32_t motion, const Command& command);
+        MotionEnd moveToPointLoop(uint32_t motion, const Command& command);
+        MotionEnd moveToPoseLoop(uint32_t motion, const Command& command);
+        MotionEnd followLoop(uint32_t motion, const Command& command);
+        /**
+         * @brief Copy the settings last set with setControllerSettings, if they changed. Only called by the worker task
+         *
+         * @return true the settings changed, so the controllers need the new gains
+         * @return false the settings are the ones already in use
+         */
+        bool loadSettings();
+        /**
+         * @brief Sleep until the next iteration of a motion's loop
+         *
+         * @param motion index of the motion
+         * @param wake time of the last iteration, in milliseconds. Moved on to the next one
+         * @return true the motion may go on
+         * @return false the motion was cancelled, and has to end
+         */
+        bool nextIteration(uint32_t motion, uint32_t& wake);
+        /**
+         * @brief Mark a motion as ended, wake its waiters and log why it ended
+         *
+         */
+        void finish(uint32_t motion, Command::Type type, MotionEnd reason, uint32_t duration);
+        /**
+         * @brief Make every motion below an index end, and wake the worker so the current one ends now
+         *
+         */
+        void stopBefore(uint32_t end, MotionEnd reason);
+        /**
+         * @brief Drive forwards and turn, with turning taking priority when the two add up to more than maxSpeed
+         *
+         * @param linear power along the heading, from -127 to 127
+         * @param angular turning power, positive clockwise
+         * @param maxSpeed maximum power of either side
+         * @param forwards false if the heading was flipped to drive backwards
+         */
+        void drive(float linear, float angular, float maxSpeed, bool forwards);
+        /**
+         * @brief Whether the drivetrain is stalled right now
+         *
+         */
+        bool stalled();
+
+        const lemlib::Drivetrain drivetrain;
+        Clock& clock;
+        // settings last set, guarded by settingsMutex, and the number of times they were set
+        lemlib::ControllerSettings nextLinear;
+        lemlib::ControllerSettings nextAngular;
+        float nextTrackWidth;
+        pros::Mutex settingsMutex;
+        std::atomic<uint32_t> settingsVersion {0};
+        // settings in use, copied from the ones above at the start of each iteration they changed before. Only used by
+        // the worker task
+        lemlib::ControllerSettings linearSettings;
+        lemlib::ControllerSettings angularSettings;
+        float trackWidth;
+        uint32_t loadedVersion = 0;
+        std::atomic<pros::Task*> task {nullptr};
+        pros::Task* progressTask = nullptr;
+        // guards the back of the queue against callers in different tasks
+        pros::Mutex mutex;
+        Command commands[QUEUE_SIZE];
+        // commands queued, started and finished so far. Command n is in commands[n % QUEUE_SIZE]
+        std::atomic<uint32_t> queued {0};
+        std::atomic<uint32_t> started {0};
+        std::atomic<uint32_t> finished {0};
+        // whether the current motion is a turn, which measures progress in degrees from where it started
+        std::atomic<bool> turning {false};
+        // type and start time of the current motion, in microseconds on the clock
+        Command::Type type = Command::Type::TURN_TO;
+        std::atomic<uint64_t> startTime {0};
+        // motions below this index end at their next check, or are skipped if they haven't started, for stopReason
+        std::atomic<uint32_t> stopIndex {0};
+        std::atomic<MotionEnd> stopReason {MotionEnd::CANCELLED};
+        // waypoints of the path being followed. Only used by the worker task
+        PathPoint pathPoints[MAX_PATH_POINTS];
+        StallSettings stall = {0, 0, 0, 0};
+        std::atomic<MotionEnd> lastEnd {MotionEnd::SETTLED};
+        // time the last motion ended, in microseconds on the clock
+        uint64_t lastFinished = 0;
+        // distance traveled in a motion, and the index of that motion. Only written by the motion progress task
+        std::atomic<float> progress {0};
+        std::atomic<uint32_t> progressMotion {UINT32_MAX};
+        pros::Mutex waiterMutex;
+        Waiter waiters[MAX_WAITERS] = {};
+        uint64_t totalLatency = 0;
+        uint32_t maxLatency = 0;
+};
+} // namespace robot
@@ -0,0 +1,24 @@
+/**
+ * @file include/robot/odom.hpp
+ * @brief Helpers for running LemLib odometry outside of the chassis
+ */
+
+#pragma once
+
+#include "lemlib/chassis/chassis.hpp"
+
+namespace robot {
+/**
+ * @brief Fill in the vertical tracking wheels the same way LemLib's chassis does
+ *
+ * Chassis::calibrate replaces missing vertical tracking wheels with the drivetrain's motor encoders before it hands
+ * the sensors to odometry, and odometry assumes both vertical wheels exist. Anything else that calls
+ * lemlib::setSensors has to do the same.
+ *
+ * @param sensors the odometry sensors
+ * @param drivetrain the drivetrain
+ * @return lemlib::OdomSensors - the sensors with both vertical tracking wheels set. Substituted wheels are allocated
+ * once and never freed, like the chassis does
+ */
+lemlib::OdomSensors withDrivetrainWheels(lemlib::OdomSensors sensors, const lemlib::Drivetrain& drivetrain);
+} // namespace robot
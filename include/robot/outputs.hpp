@@ -0,0 +1,154 @@
+/**
+ * @file include/robot/outputs.hpp
+ * @brief Write-combining output declarations
+ *
+ * The driver control loop commands every motor and solenoid every tick, whether or not the command changed, and some
+ * actuators are commanded more than once in the same tick. Each command is a separate write to the device, and two
+ * conflicting commands in one tick briefly drive the actuator one way before the other.
+ *
+ * Outputs collects the commands of a tick instead, keeping only the last one for each actuator, and writes them all at
+ * once in flush(). A command equal to the one last written is not written again.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include "pros/adi.hpp"
+#include "pros/motors.hpp"
+
+namespace robot {
+/**
+ * @brief Command counts of a tick, or of every tick so far
+ *
+ */
+struct OutputCounts {
+        /** number of move() and set() calls */
+        uint32_t commands;
+        /** number of commands replaced by a later command to the same actuator before the flush */
+        uint32_t overwritten;
+        /** number of commands dropped because the actuator already had that command */
+        uint32_t unchanged;
+        /** number of writes to devices */
+        uint32_t writes;
+};
+
+/**
+ * @brief Collects actuator commands over a tick and writes each changed one once
+ *
+ * Only one task may use an Outputs. Actuators commanded directly, like by a chassis motion, should be marked stale with
+ * invalidate() before the Outputs takes them back over
+ *
+ * <h3> Example Usage </h3>
+ * @code
+ * robot::Outputs outputs;
+ * const int intakeOutput = outputs.addMotor(&intake);
+ * const int wingsOutput = outputs.addDigital(&wings);
+ * while (true) {
+ *     outputs.move(intakeOutput, 127);
+ *     if (stop) outputs.move(intakeOutput, 0);
+ *     outputs.set(wingsOutput, wingsValue);
+ *     outputs.flush();
+ *     pros::delay(10);
+ * }
+ * @endcode
+ */
+class Outputs {
+    public:
+        /** @brief maximum number of actuators */
+        static constexpr int MAX_OUTPUTS = 16;
+
+        Outputs() = default;
+        Outputs(const Outputs&) = delete;
+        Outputs& operator=(const Outputs&) = delete;
+        /**
+         * @brief Add a motor, commanded with move()
+         *
+         * @param motor the motor. Must outlive the outputs
+         * @return int - the output, or -1 if there is no room for another actuator
+         */
+        int addMotor(pros::Motor* motor);
+        /**
+         * @brief Add a motor group, commanded with move(). All its motors get the same command
+         *
+         * @param motors the motor group. Must outlive the outputs
+         * @return int - the output, or -1 if there is no room for another actuator
+         */
+        int addMotorGroup(pros::Motor_Group* motors);
+        /**
+         * @brief Add a digital output like a solenoid, commanded with set()
+         *
+         * @param digital the digital output. Must outlive the outputs
+         * @return int - the output, or -1 if there is no room for another actuator
+         */
+        int addDigital(pros::ADIDigitalOut* digital);
+        /**
+         * @brief Command a motor or motor group for this tick
+         *
+         * @param output the output
+         * @param power power, from -127 to 127, as in pros::Motor::move
+         */
+        void move(int output, int32_t power);
+        /**
+         * @brief Command a digital output for this tick
+         *
+         * @param output the output
+         * @param value the value
+         */
+        void set(int output, bool value);
+        /**
+         * @brief Write the last command of this tick to each actuator whose command changed
+         *
+         * Call once per tick, after every command
+         */
+        void flush();
+        /**
+         * @brief Write every actuator on the next flush, even if its command didn't change
+         *
+         * For when actuators were commanded without going through the outputs
+         */
+        void invalidate();
+        /**
+         * @brief Get the counts of the last flushed tick
+         *
+         * @return OutputCounts
+         */
+        OutputCounts getLastTick();
+        /**
+         * @brief Get the counts of every tick so far
+         *
+         * @return OutputCounts
+         */
+        OutputCounts getTotals();
+    private:
+        struct Output {
+                enum class Type { MOTOR, MOTOR_GROUP, DIGITAL };
+
+                Type type;
+                void* device;
+                // command of this tick, if pending is set
+                int32_t command;
+                bool pending;
+                // command last written to the device, if written is set
+                int32_t last;
+                bool written;
+        };
+
+        /**
+         * @brief Add an actuator
+         *
+         */
+        int add(Output::Type type, void* device);
+        /**
+         * @brief Record a command for this tick
+         *
+         */
+        void command(int output, int32_t value);
+
+        Output outputs[MAX_OUTPUTS];
+        int outputCount = 0;
+        OutputCounts tick = {};
+        OutputCounts lastTick = {};
+        OutputCounts totals = {};
+};
+} // namespace robot
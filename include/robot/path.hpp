@@ -0,0 +1,64 @@
+/**
+ * @file include/robot/path.hpp
+ * @brief Path asset parsing and pure pursuit geometry
+ *
+ * Path assets are the files in static/, generated by path.jerryio. Each line before "endData" is a waypoint in the
+ * form "x, y, speed". These functions work on fixed size arrays so they can be called from any task without
+ * allocating.
+ */
+
+#pragma once
+
+#include "lemlib/asset.hpp"
+#include "lemlib/pose.hpp"
+
+namespace robot {
+/**
+ * @brief A single waypoint of a path
+ *
+ */
+struct PathPoint {
+        /** x position, in inches */
+        float x;
+        /** y position, in inches */
+        float y;
+        /** target speed, from 0 to 127 */
+        float speed;
+};
+
+/**
+ * @brief Parse a path asset into an array of waypoints
+ *
+ * @param path the path asset
+ * @param points array to write the waypoints to
+ * @param maxPoints the size of the array. Waypoints past this are dropped
+ * @return int - the number of waypoints written
+ */
+int parsePath(const asset& path, PathPoint* points, int maxPoints);
+
+/**
+ * @brief Find the index of the waypoint closest to a pose
+ *
+ * @param points waypoints of the path
+ * @param count number of waypoints
+ * @param pose the pose to search from
+ * @param start index to start searching from. Pure pursuit never moves backwards along the path
+ * @return int - index of the closest waypoint
+ */
+int closestPoint(const PathPoint* points, int count, lemlib::Pose pose, int start = 0);
+
+/**
+ * @brief Find the pure pursuit lookahead point
+ *
+ * Searches forwards from the closest point for the last path segment that intersects a circle of radius lookahead
+ * around the pose. If no segment intersects, the last waypoint is used.
+ *
+ * @param points waypoints of the path
+ * @param count number of waypoints, must be at least 1
+ * @param pose the pose of the robot
+ * @param closest index of the closest waypoint
+ * @param lookahead lookahead distance, in inches
+ * @return lemlib::Pose - the lookahead point. Theta is the speed of the segment it lies on
+ */
+lemlib::Pose lookaheadPoint(const PathPoint* points, int count, lemlib::Pose pose, int closest, float lookahead);
+} // namespace robot
@@ -0,0 +1,104 @@
+/**
+ * @file include/robot/pid.hpp
+ * @brief PID controller with measured dt
+ *
+ * LemLib's FAPID adds kD times the change in error since the last update and kI times the sum of every error, so its
+ * gains assume every update is one loop period apart. A late update makes the derivative term too big by the
+ * fraction it was late, and since LemLib's timers count whole milliseconds there is no way to correct for it there.
+ *
+ * Pid measures the time since its last update with a DeltaTimer, and divides the change in error by it and multiplies
+ * the error by it, so the gains are per second and an uneven loop changes nothing but the resolution. Gains tuned for
+ * FAPID at a 10ms loop are the same with kI divided by 0.01 and kD multiplied by 0.01.
+ */
+
+#pragma once
+
+#include "robot/clock.hpp"
+
+namespace robot {
+/**
+ * @brief PID controller with integral and derivative terms scaled by the measured time between updates
+ *
+ * <h3> Example Usage </h3>
+ * @code
+ * robot::Pid cataPid(0.5, 0, 0.02);
+ * while (true) {
+ *     cata.move(cataPid.update(5500 - cata_rot.get_angle()));
+ *     pros::delay(10);
+ * }
+ * @endcode
+ */
+class Pid {
+    public:
+        /**
+         * @brief Construct a new Pid
+         *
+         * @param kP proportional gain, multiplied by error
+         * @param kI integral gain, multiplied by the integral of error over time, in seconds
+         * @param kD derivative gain, multiplied by the rate of change of error, per second
+         * @param windupRange error range where the integral accumulates. 0 accumulates at any error
+         * @param signFlipReset whether to clear the integral when the error changes sign
+         * @param clock clock to measure the time between updates with. Must outlive the controller
+         */
+        Pid(float kP, float kI, float kD, float windupRange = 0, bool signFlipReset = false,
+            Clock& clock = systemClock());
+        /**
+         * @brief Set the gains
+         *
+         * Leaves the integral and the last error as they are
+         *
+         * @param kP proportional gain
+         * @param kI integral gain, per second of error
+         * @param kD derivative gain, per unit of error per second
+         */
+        void setGains(float kP, float kI, float kD);
+        /**
+         * @brief Update the controller with the time since the last update
+         *
+         * The first update after construction or reset has no derivative term, since there is no earlier error
+         *
+         * @param error target minus the current value
+         * @return float - output
+         */
+        float update(float error);
+        /**
+         * @brief Update the controller with a known time since the last update
+         *
+         * For callers that already know dt, like a replay of recorded samples. The clock isn't read
+         *
+         * @param error target minus the current value
+         * @param dt time since the last update, in seconds. 0 or less skips the integral and derivative
+         * @return float - output
+         */
+        float update(float error, float dt);
+        /**
+         * @brief Clear the integral and the last error
+         *
+         */
+        void reset();
+        /**
+         * @brief Get the integral of error over time
+         *
+         * @return float - integral, in error seconds
+         */
+        float getIntegral();
+        /**
+         * @brief Get the rate of change of error at the last update
+         *
+         * @return float - derivative, in error per second
+         */
+        float getDerivative();
+    private:
+        float kP;
+        float kI;
+        float kD;
+        const float windupRange;
+        const bool signFlipReset;
+        DeltaTimer timer;
+        // whether prevError holds a real error, false until the first update
+        bool started = false;
+        float prevError = 0;
+        float integral = 0;
+        float derivative = 0;
+};
+} // namespace robot
@@ -0,0 +1,148 @@
+/**
+ * @file include/robot/poseSource.hpp
+ * @brief Shared pose declarations
+ *
+ * LemLib's odometry task writes the pose one field at a time, so a task that reads it while the odometry task is
+ * partway through an update can see a pose that never existed. okapi's odometry classes run their own estimator on
+ * top of that, in their own task, with a pose that disagrees with LemLib's.
+ *
+ * PoseSource copies LemLib's pose once per odometry period into a double buffered sample, the same way SensorHub
+ * publishes snapshots, and any task can copy the latest sample without blocking. LemLibOdometry is an okapi::Odometry
+ * that reads PoseSource instead of estimating anything, so okapi chassis controllers and LemLib's chassis share one
+ * estimator and one pose.
+ *
+ * The copy is consistent because of priorities. The pose task runs below the odometry task, so whenever it runs the
+ * odometry task is not partway through an update, and it raises itself above every task for the few reads of the copy
+ * so the odometry task can't start one either.
+ *
+ * Samples are timed in microseconds, so the time between two of them is the real time between the copies rather than
+ * a whole number of milliseconds, for velocities worked out from the difference.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include "lemlib/pose.hpp"
+#include "okapi/api/odometry/odometry.hpp"
+#include "pros/rtos.hpp"
+#include "robot/clock.hpp"
+#include "robot/doubleBuffer.hpp"
+
+namespace robot {
+/**
+ * @brief LemLib's pose at one point in time
+ *
+ */
+struct PoseSample {
+        /** number of samples taken up to and including this one. 0 until the first sample */
+        uint32_t sequence;
+        /** time the pose was copied, in microseconds from the source's clock */
+        uint64_t micros;
+        /** x position, in inches */
+        float x;
+        /** y position, in inches */
+        float y;
+        /** heading, in degrees. 0 is along +y, clockwise is positive */
+        float theta;
+};
+
+/**
+ * @brief Publishes LemLib's pose for any task to read without blocking
+ *
+ * <h3> Example Usage </h3>
+ * @code
+ * robot::PoseSource poseSource;
+ * // in initialize, after the chassis is calibrated
+ * poseSource.start();
+ * // in any task
+ * const robot::PoseSample pose = poseSource.get();
+ * @endcode
+ */
+class PoseSource {
+    public:
+        /**
+         * @brief Construct a new Pose Source
+         *
+         * @param clock clock to time samples with. Must outlive the source
+         */
+        explicit PoseSource(Clock& clock = systemClock()) : clock(clock) {}
+        PoseSource(const PoseSource&) = delete;
+        PoseSource& operator=(const PoseSource&) = delete;
+        /**
+         * @brief Take the first sample and start the "pose" task
+         *
+         */
+        void start();
+        /**
+         * @brief Copy LemLib's pose into a new sample and publish it
+         *
+         * Called by the pose task once per odometry period. Must be called from a task below the odometry task's
+         * priority
+         */
+        void update();
+        /**
+         * @brief Set LemLib's pose, and publish it straight away
+         *
+         * Same as lemlib::Chassis::setPose, but the odometry task can't update the pose halfway through. Must be
+         * called from a task below the odometry task's priority
+         *
+         * @param pose the new pose, in inches and degrees
+         */
+        void setPose(lemlib::Pose pose);
+        /**
+         * @brief Get the latest sample
+         *
+         * Safe to call from any number of tasks at once. Never blocks
+         *
+         * @return PoseSample - a copy of the latest sample
+         */
+        PoseSample get();
+    private:
+        /**
+         * @brief Write a sample into the next buffer and publish it. Must be called at the highest priority
+         *
+         */
+        void publish(const lemlib::Pose& pose);
+
+        Clock& clock;
+        pros::Task* task = nullptr;
+        DoubleBuffer<PoseSample> samples;
+};
+
+/**
+ * @brief okapi odometry backed by LemLib's pose
+ *
+ * step() does nothing, since LemLib's odometry task already keeps the pose up to date, so okapi's odometry thread
+ * doesn't need to be started for it
+ *
+ * <h3> Example Usage </h3>
+ * @code
+ * auto odometry = std::make_shared<robot::LemLibOdometry>(poseSource, okapi::ChassisScales({3.25_in, 12_in}, 300));
+ * const okapi::OdomState state = odometry->getState(okapi::StateMode::CARTESIAN);
+ * @endcode
+ */
+class LemLibOdometry : public okapi::Odometry {
+    public:
+        /**
+         * @brief Construct a new LemLib Odometry
+         *
+         * @param source the published pose. Must outlive the odometry
+         * @param scales the chassis scales, returned by getScales
+         * @param model the chassis model, returned by getModel. Not used by the odometry itself
+         */
+        LemLibOdometry(PoseSource& source, const okapi::ChassisScales& scales,
+                       std::shared_ptr<okapi::ReadOnlyChassisModel> model = nullptr);
+        void setScales(const okapi::ChassisScales& scales) override;
+        void step() override;
+        okapi::OdomState getState(const okapi::StateMode& mode = okapi::StateMode::FRAME_TRANSFORMATION) const override;
+        void setState(const okapi::OdomState& state,
+                      const okapi::StateMode& mode = okapi::StateMode::FRAME_TRANSFORMATION) override;
+        std::shared_ptr<okapi::ReadOnlyChassisModel> getModel() override;
+        okapi::ChassisScales getScales() override;
+    private:
+        PoseSource& source;
+        okapi::ChassisScales scales;
+        std::shared_ptr<okapi::ReadOnlyChassisModel> model;
+};
+} // namespace robot
@@ -0,0 +1,185 @@
+/**
+ * @file include/robot/recorder.hpp
+ * @brief Raw sensor recorder declarations
+ *
+ * Records the raw inputs of a run every 10ms into a preallocated buffer, and saves them to the SD card afterwards so
+ * the run can be replayed through odometry off the robot with host/tools/replay.cpp. The file is the header followed
+ * by the samples, written as they are laid out in memory. Both the brain and the host are little endian with the same
+ * alignment rules, so the replay tool reads it back with the same structs.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include "lemlib/chassis/chassis.hpp"
+#include "pros/misc.hpp"
+#include "pros/rtos.hpp"
+
+namespace robot {
+/** @brief maximum number of motors in a recording */
+constexpr int RECORDING_MAX_MOTORS = 8;
+/** @brief version of the recording format. Bump when the structs below change */
+constexpr uint16_t RECORDING_VERSION = 1;
+
+/**
+ * @brief Header at the start of a recording
+ *
+ */
+struct RecordingHeader {
+        /** "RREC" */
+        char magic[4];
+        /** RECORDING_VERSION */
+        uint16_t version;
+        /** sizeof(SensorSample), so readers can reject files from a different build */
+        uint16_t sampleSize;
+        /** number of motors recorded */
+        uint8_t motorCount;
+        /** the first leftCount motors are the left side of the drivetrain */
+        uint8_t leftCount;
+        /** the next rightCount motors are the right side of the drivetrain. The rest are other mechanisms */
+        uint8_t rightCount;
+        /** time between samples, in milliseconds */
+        uint8_t period;
+        /** port of each motor. Negative if the motor is reversed */
+        int8_t ports[RECORDING_MAX_MOTORS];
+        /** cartridge of each motor, a pros::motor_gearset_e_t */
+        uint8_t gearsets[RECORDING_MAX_MOTORS];
+        /** drivetrain track width, in inches */
+        float trackWidth;
+        /** drivetrain wheel diameter, in inches */
+        float wheelDiameter;
+        /** drivetrain wheel rpm */
+        float rpm;
+        /** number of samples that follow */
+        uint32_t sampleCount;
+};
+
+static_assert(sizeof(RecordingHeader) == 44, "recording header layout changed");
+
+/**
+ * @brief Raw sensor values at one point in time
+ *
+ */
+struct SensorSample {
+        /** time the sample was taken, in milliseconds since the program started */
+        uint32_t time;
+        /** raw encoder count of each motor, from get_raw_position */
+        int32_t motorPositions[RECORDING_MAX_MOTORS];
+        /** time each motor last updated its encoder count, in milliseconds */
+        uint32_t motorTimestamps[RECORDING_MAX_MOTORS];
+        /** inertial sensor rotation, in degrees */
+        float imuRotation;
+        /** rotation sensor position, in centidegrees */
+        int32_t rotationPosition;
+        /** controller joysticks, indexed by pros::controller_analog_e_t */
+        int8_t analog[4];
+        /** controller buttons. Bit i is pros::E_CONTROLLER_DIGITAL_L1 + i */
+        uint16_t buttons;
+        /** unused, keeps the pose aligned */
+        uint16_t padding;
+        /** pose from odometry on the robot, in inches and degrees. The replay is compared against it */
+        float poseX;
+        float poseY;
+        float poseTheta;
+};
+
+static_assert(sizeof(SensorSample) == 96, "sensor sample layout changed");
+
+/**
+ * @brief Raw sensor recorder
+ *
+ * <h3> Example Usage </h3>
+ * @code
+ * robot::Recorder recorder(drivetrain, &imu, &rotation, &controller);
+ * recorder.addMotor(&intake);
+ * // in autonomous
+ * recorder.start();
+ * // in disabled
+ * if (recorder.stop()) recorder.save("/usd/replay.bin");
+ * @endcode
+ */
+class Recorder {
+    public:
+        /** @brief maximum number of samples, a full 60 second skills run */
+        static constexpr int MAX_SAMPLES = 6000;
+        /** @brief time between samples, in milliseconds. Matches the LemLib odometry loop */
+        static constexpr uint32_t PERIOD = 10;
+
+        /**
+         * @brief Construct a new Recorder
+         *
+         * The drivetrain motors are always recorded, left side first
+         *
+         * @param drivetrain the drivetrain
+         * @param imu inertial sensor, or nullptr
+         * @param rotation rotation sensor, or nullptr
+         * @param controller controller, or nullptr
+         */
+        Recorder(const lemlib::Drivetrain& drivetrain, pros::Imu* imu, pros::Rotation* rotation,
+                 pros::Controller* controller);
+        Recorder(const Recorder&) = delete;
+        Recorder& operator=(const Recorder&) = delete;
+        /**
+         * @brief Record another motor, after the drivetrain motors
+         *
+         * Must be called before recording starts
+         *
+         * @param motor the motor. Must outlive the recorder
+         * @return true the motor will be recorded
+         * @return false there is no room for another motor
+         */
+        bool addMotor(pros::Motor* motor);
+        /**
+         * @brief Start recording from an empty buffer
+         *
+         * Samples are taken in a task that is created the first time this is called. Recording stops by itself once
+         * the buffer is full
+         */
+        void start();
+        /**
+         * @brief Stop recording
+         *
+         * @return true the recorder was recording
+         * @return false the recorder was not recording
+         */
+        bool stop();
+        /**
+         * @brief Take one sample now
+         *
+         * Called by the recording task. Does nothing if the buffer is full
+         */
+        void sample();
+        /**
+         * @brief Save the samples to a file
+         *
+         * Should be called after stop(), since writing to the SD card is slow
+         *
+         * @param path path of the file, e.g. "/usd/replay.bin"
+         * @return true the file was written
+         * @return false the file could not be opened or written
+         */
+        bool save(const char* path);
+        /**
+         * @brief Get the number of samples recorded
+         *
+         * @return int
+         */
+        int getSampleCount();
+    private:
+        pros::Motor* motors[RECORDING_MAX_MOTORS];
+        int motorCount = 0;
+        int leftCount;
+        int rightCount;
+        float trackWidth;
+        float wheelDiameter;
+        float rpm;
+        pros::Imu* imu;
+        pros::Rotation* rotation;
+        pros::Controller* controller;
+        pros::Task* task = nullptr;
+        std::atomic<bool> recording = false;
+        std::atomic<int> sampleCount = 0;
+        SensorSample samples[MAX_SAMPLES];
+};
+} // namespace robot
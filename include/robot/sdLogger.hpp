@@ -0,0 +1,213 @@
+/**
+ * @file include/robot/sdLogger.hpp
+ * @brief SD card binary logger declarations
+ *
+ * Producers append fixed size records into one of two blocks without taking a lock, and a low priority task writes
+ * whole blocks to the SD card while the other one fills. A producer never waits on the card: if both blocks are full
+ * the record is dropped and counted instead.
+ *
+ * Each file starts with a LogFileHeader padded with zeros to a whole sector, followed by blocks of BLOCK_SIZE bytes.
+ * Each block is a LogBlockHeader, the records in it as they were logged, and zeros up to the end of the block. Every
+ * write is then whole sectors on a sector boundary, which the card takes without reading back and rewriting a partial
+ * sector, even when a sync writes a block before it is full. Files are rotated once they reach a size limit, so a crash
+ * or a pulled card only loses the file being written.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include "pros/rtos.hpp"
+
+namespace robot {
+/** @brief version of the log file format */
+constexpr uint16_t LOG_VERSION = 2;
+
+/**
+ * @brief Header at the start of every log file
+ *
+ */
+struct LogFileHeader {
+        /** "RLOG" */
+        char magic[4];
+        /** LOG_VERSION */
+        uint16_t version;
+        /** size of each record, in bytes */
+        uint16_t recordSize;
+        /** index of this file, counting from 0 for the first file the logger opened */
+        uint32_t index;
+        /** time the file was opened, in milliseconds since the program started */
+        uint32_t time;
+};
+
+static_assert(sizeof(LogFileHeader) == 16, "log file header layout changed");
+
+/**
+ * @brief Header at the start of every block
+ *
+ */
+struct LogBlockHeader {
+        /** number of records in the block */
+        uint32_t records;
+        /** index of the block among every block the logger closed, from 0. A gap is a block that failed to write */
+        uint32_t block;
+};
+
+static_assert(sizeof(LogBlockHeader) == 8, "log block header layout changed");
+
+/**
+ * @brief SD card binary logger
+ *
+ * <h3> Example Usage </h3>
+ * @code
+ * struct DriveRecord {
+ *         uint32_t time;
+ *         float x, y, theta;
+ * };
+ *
+ * robot::SdLogger logger("/usd/drive", sizeof(DriveRecord));
+ * logger.start();
+ * // in any task
+ * logger.log(DriveRecord {pros::millis(), pose.x, pose.y, pose.theta});
+ * // in disabled
+ * logger.sync();
+ * @endcode
+ */
+class SdLogger {
+    public:
+        /** @brief size of the card's sectors, in bytes. The file header is padded to one */
+        static constexpr uint32_t SECTOR_SIZE = 512;
+        /** @brief size of each block, in bytes, including its header. A multiple of SECTOR_SIZE */
+        static constexpr uint32_t BLOCK_SIZE = 4096;
+        /** @brief maximum length of the path prefix */
+        static constexpr int MAX_PREFIX = 24;
+
+        /**
+         * @brief Construct a new SD Logger
+         *
+         * @param prefix start of the path of each file. Files are named <prefix>000.bin, <prefix>001.bin and so on
+         * @param recordSize size of each record, in bytes. At most BLOCK_SIZE less the block header, larger records are
+         * never logged
+         * @param maxFileSize size at which the logger moves on to the next file, in bytes
+         * @param syncInterval longest time a record stays in memory, in milliseconds. Partly filled blocks are written
+         * and the file is flushed at this interval
+         */
+        SdLogger(const char* prefix, uint16_t recordSize, uint32_t maxFileSize = 1024 * 1024,
+                 uint32_t syncInterval = 1000);
+        SdLogger(const SdLogger&) = delete;
+        SdLogger& operator=(const SdLogger&) = delete;
+        /**
+         * @brief Start the writer task
+         *
+         * Records logged before this are kept until the writer starts, as long as they fit in the two blocks. The task
+         * is "sdLogger" in the task registry, below every task that logs
+         *
+         * @return true the writer task is running
+         * @return false there is no SD card
+         */
+        bool start();
+        /**
+         * @brief Append a record
+         *
+         * Safe to call from any number of tasks at once. Never blocks
+         *
+         * @param record pointer to recordSize bytes
+         * @return true the record will be written
+         * @return false both blocks are waiting to be written, and the record was dropped
+         */
+        bool log(const void* record);
+        /**
+         * @brief Append a record
+         *
+         * @param record the record. Its size must be the record size of the logger
+         * @return true the record will be written
+         * @return false the record was dropped, or has the wrong size
+         */
+        template <typename T> bool log(const T& record) {
+            if (sizeof(T) != recordSize) return false;
+            return log(static_cast<const void*>(&record));
+        }
+        /**
+         * @brief Write everything logged so far to the card
+         *
+         * Closes the current block early and asks the writer to flush the file. Does not wait for the writer
+         */
+        void sync();
+        /**
+         * @brief Start a new file
+         *
+         * Everything logged before this call goes in the current file
+         */
+        void rotate();
+        /**
+         * @brief Get the number of records dropped because both blocks were full
+         *
+         * @return uint32_t
+         */
+        uint32_t getDropped();
+        /**
+         * @brief Get the number of records written to the card
+         *
+         * @return uint32_t
+         */
+        uint32_t getWritten();
+        /**
+         * @brief Get the number of files opened so far
+         *
+         * The file being written is the last one, <prefix> followed by getFileCount() - 1
+         *
+         * @return uint32_t
+         */
+        uint32_t getFileCount();
+    private:
+        /**
+         * @brief Close the block being filled, if any records are in it
+         *
+         */
+        void closeBlock();
+        /**
+         * @brief Write every closed block whose records have all been copied in
+         *
+         * Only called by the writer task
+         *
+         * @return true at least one block was written
+         */
+        bool writeBlocks();
+        /**
+         * @brief Close the current file and open the next one
+         *
+         * Only called by the writer task
+         */
+        void openFile();
+
+        char prefix[MAX_PREFIX + 1];
+        const uint16_t recordSize;
+        // number of records that fit in a block after its header
+        const uint32_t recordsPerBlock;
+        const uint32_t maxFileSize;
+        const uint32_t syncInterval;
+        std::atomic<pros::Task*> task {nullptr};
+        FILE* file = nullptr;
+        // number of files opened so far
+        std::atomic<uint32_t> fileCount {0};
+        uint32_t fileSize = 0;
+        // records reserved so far. Record n goes in block n / recordsPerBlock, which uses buffer block % 2
+        std::atomic<uint32_t> head {0};
+        // number of blocks written so far
+        std::atomic<uint32_t> flushed {0};
+        // records copied into each buffer
+        std::atomic<uint32_t> committed[2] = {};
+        // records in each buffer once its block is closed, 0 while it is still being filled
+        std::atomic<uint32_t> length[2] = {};
+        // the file is flushed once this many blocks have been written, if syncPending is set
+        std::atomic<uint32_t> syncAt {0};
+        std::atomic<bool> syncPending {false};
+        // the next file is opened before this block is written, if rotatePending is set
+        std::atomic<uint32_t> rotateAt {0};
+        std::atomic<bool> rotatePending {false};
+        std::atomic<uint32_t> dropped {0};
+        std::atomic<uint32_t> written {0};
+        alignas(8) uint8_t buffers[2][BLOCK_SIZE];
+};
+} // namespace robot
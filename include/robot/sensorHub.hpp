@@ -0,0 +1,302 @@
+/**
+ * @file include/robot/sensorHub.hpp
+ * @brief Sensor hub declarations
+ *
+ * Every task that reads a device asks the device itself, so a value read in several places is read several times each
+ * tick, and two tasks reading the same sensor can see different samples of it. The hub reads every registered device
+ * once per device update, every 10ms, into a snapshot that every reader copies instead.
+ *
+ * Every read is a call into the device layer, so the hub only reads what its readers use: each device is registered
+ * with the values to read from it, and the controller with the joysticks and buttons. The hub also only reads while
+ * someone reads its snapshots. Once nobody has asked for one for IDLE_TIME, as in autonomous, it stops reading
+ * devices until the next request.
+ *
+ * Snapshots are double buffered. The hub fills one buffer while readers copy the other, then publishes it by bumping a
+ * sequence number. Readers never block the hub: a reader that was too slow to finish its copy before the hub came back
+ * around to the same buffer notices and copies again.
+ *
+ * Devices send new values to the brain once every 10ms, and motors report when that happened with get_raw_position. A
+ * loop with an arbitrary phase reads values that are up to a whole period old. Given a reference motor, the hub moves
+ * its own reads to just after each device update, and loops that wait for each snapshot with waitForUpdate() run
+ * right behind it, on data that is at most a millisecond or two old.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include "pros/imu.hpp"
+#include "pros/misc.hpp"
+#include "pros/motors.hpp"
+#include "pros/rotation.hpp"
+#include "pros/rtos.hpp"
+#include "robot/doubleBuffer.hpp"
+
+namespace robot {
+/**
+ * @brief Values of one motor in a snapshot
+ *
+ */
+struct MotorSnapshot {
+        /** @brief read position, for addMotor. Values can be combined with | */
+        static constexpr uint8_t POSITION = 1 << 0;
+        /** @brief read velocity */
+        static constexpr uint8_t VELOCITY = 1 << 1;
+        /** @brief read rawPosition and timestamp */
+        static constexpr uint8_t RAW_POSITION = 1 << 2;
+        /** @brief read current */
+        static constexpr uint8_t CURRENT = 1 << 3;
+        /** @brief read every value */
+        static constexpr uint8_t ALL = POSITION | VELOCITY | RAW_POSITION | CURRENT;
+
+        /** position, in the motor's encoder units */
+        double position;
+        /** velocity, in rpm */
+        double velocity;
+        /** raw encoder count, from get_raw_position */
+        int32_t rawPosition;
+        /** time the motor last updated its encoder count, in milliseconds */
+        uint32_t timestamp;
+        /** current draw, in milliamps */
+        int32_t current;
+};
+
+/**
+ * @brief Values of one rotation sensor in a snapshot
+ *
+ */
+struct RotationSnapshot {
+        /** @brief read angle, for addRotation. Values can be combined with | */
+        static constexpr uint8_t ANGLE = 1 << 0;
+        /** @brief read position */
+        static constexpr uint8_t POSITION = 1 << 1;
+        /** @brief read velocity */
+        static constexpr uint8_t VELOCITY = 1 << 2;
+        /** @brief read every value */
+        static constexpr uint8_t ALL = ANGLE | POSITION | VELOCITY;
+
+        /** angle, in centidegrees from 0 to 36000 */
+        int32_t angle;
+        /** position, in centidegrees. Unbounded */
+        int32_t position;
+        /** velocity, in centidegrees per second */
+        int32_t velocity;
+};
+
+/**
+ * @brief Every registered device, read at one point in time
+ *
+ */
+struct SensorSnapshot {
+        /** @brief maximum number of motors in a snapshot */
+        static constexpr int MAX_MOTORS = 12;
+        /** @brief maximum number of rotation sensors in a snapshot */
+        static constexpr int MAX_ROTATIONS = 4;
+
+        /** number of snapshots taken up to and including this one. 0 until the hub has read the devices */
+        uint32_t sequence;
+        /** time the devices were read, in milliseconds since the program started */
+        uint32_t time;
+        /** time the hub started reading the devices, in microseconds since the program started */
+        uint64_t micros;
+        /** time since the reference motor last updated, in milliseconds. 0 without a reference motor */
+        uint32_t age;
+        /** motors, in the order they were added */
+        MotorSnapshot motors[MAX_MOTORS];
+        /** rotation sensors, in the order they were added */
+        RotationSnapshot rotations[MAX_ROTATIONS];
+        /** inertial sensor rotation, in degrees. Unbounded */
+        double imuRotation;
+        /** inertial sensor heading, in degrees from 0 to 360 */
+        double imuHeading;
+        /** controller joysticks, indexed by pros::controller_analog_e_t. 0 for joysticks that aren't read */
+        int8_t analog[4];
+        /** controller buttons. Bit i is pros::E_CONTROLLER_DIGITAL_L1 + i. 0 for buttons that aren't read */
+        uint16_t buttons;
+
+        /**
+         * @brief Whether a controller button was held
+         *
+         * @param button the button
+         * @return true the button was held when the snapshot was taken
+         * @return false the button was not held
+         */
+        bool pressed(pros::controller_digital_e_t button) const {
+            return buttons & (1 << (button - pros::E_CONTROLLER_DIGITAL_L1));
+        }
+};
+
+/**
+ * @brief Reads the registered devices once per tick into a shared snapshot, while anyone reads it
+ *
+ * <h3> Example Usage </h3>
+ * @code
+ * robot::SensorHub sensorHub;
+ * const int cataRotation = sensorHub.addRotation(&cata_rot, robot::RotationSnapshot::ANGLE);
+ * sensorHub.setController(&controller, 0, robot::SensorHub::button(pros::E_CONTROLLER_DIGITAL_R2));
+ * sensorHub.start();
+ * // in any task
+ * const robot::SensorSnapshot snapshot = sensorHub.get();
+ * if (snapshot.pressed(pros::E_CONTROLLER_DIGITAL_R2)) cata.move(127);
+ * const int32_t angle = snapshot.rotations[cataRotation].angle;
+ * @endcode
+ */
+class SensorHub {
+    public:
+        /** @brief time between snapshots, in milliseconds. Matches the V5 device update period */
+        static constexpr uint32_t PERIOD = 10;
+        /** @brief how long after a device update the hub aims to read the devices, in milliseconds */
+        static constexpr uint32_t PHASE_TARGET = 1;
+        /** @brief number of tasks that can wait for a snapshot at once */
+        static constexpr int MAX_WAITERS = 4;
+        /** @brief time without a request after which the hub stops reading devices, in milliseconds */
+        static constexpr uint32_t IDLE_TIME = 50;
+
+        /**
+         * @brief Get the bit of a joystick, for setController
+         *
+         * @param axis the joystick
+         * @return uint8_t - the bit
+         */
+        static constexpr uint8_t axis(pros::controller_analog_e_t axis) { return 1 << axis; }
+        /**
+         * @brief Get the bit of a button, for setController. The same bit as in SensorSnapshot::buttons
+         *
+         * @param button the button
+         * @return uint16_t - the bit
+         */
+        static constexpr uint16_t button(pros::controller_digital_e_t button) {
+            return 1 << (button - pros::E_CONTROLLER_DIGITAL_L1);
+        }
+
+        SensorHub() = default;
+        SensorHub(const SensorHub&) = delete;
+        SensorHub& operator=(const SensorHub&) = delete;
+        /**
+         * @brief Read a motor in every snapshot
+         *
+         * Must be called before the hub starts
+         *
+         * @param motor the motor. Must outlive the hub
+         * @param values the values to read, MotorSnapshot::POSITION and the rest combined with |
+         * @return int - index of the motor in SensorSnapshot::motors, or -1 if there is no room for another motor
+         */
+        int addMotor(pros::Motor* motor, uint8_t values = MotorSnapshot::ALL);
+        /**
+         * @brief Read a rotation sensor in every snapshot
+         *
+         * Must be called before the hub starts
+         *
+         * @param rotation the rotation sensor. Must outlive the hub
+         * @param values the values to read, RotationSnapshot::ANGLE and the rest combined with |
+         * @return int - index of the sensor in SensorSnapshot::rotations, or -1 if there is no room for another sensor
+         */
+        int addRotation(pros::Rotation* rotation, uint8_t values = RotationSnapshot::ALL);
+        /**
+         * @brief Set the inertial sensor to read in every snapshot
+         *
+         * Must be called before the hub starts
+         *
+         * @param imu the inertial sensor. Must outlive the hub
+         */
+        void setImu(pros::Imu* imu);
+        /**
+         * @brief Set the controller to read in every snapshot
+         *
+         * Must be called before the hub starts
+         *
+         * @param controller the controller. Must outlive the hub
+         * @param axes the joysticks to read, axis() of each combined with |
+         * @param buttons the buttons to read, button() of each combined with |
+         */
+        void setController(pros::Controller* controller, uint8_t axes = 0xf, uint16_t buttons = 0xfff);
+        /**
+         * @brief Align the hub's reads to the updates of a motor
+         *
+         * Every device updates on the same 10ms cycle, so any motor on the brain works as a reference. Its raw
+         * position is read from then on, whatever values it was added with
+         *
+         * @param motor index of the motor, as returned by addMotor. -1 to read at a fixed period with any phase
+         */
+        void setPhaseReference(int motor);
+        /**
+         * @brief Take the first snapshot and start the hub task
+         *
+         * The task is "sensor hub" in the task registry, above every task that reads the snapshot
+         */
+        void start();
+        /**
+         * @brief Read every registered device into a new snapshot and publish it
+         *
+         * Called by the hub task every PERIOD while the snapshots are in use. Only one task may call it
+         */
+        void update();
+        /**
+         * @brief Get the latest snapshot
+         *
+         * Safe to call from any number of tasks at once. Never blocks. If nothing asked for a snapshot for IDLE_TIME
+         * before this call, the snapshot is from before then, and the hub reads the devices again from its next period
+         *
+         * @return SensorSnapshot - a copy of the latest snapshot
+         */
+        SensorSnapshot get();
+        /**
+         * @brief Wait for a snapshot newer than the one given, and get it
+         *
+         * Blocks until the hub publishes a new snapshot, so a loop built on this runs once per snapshot, right after
+         * the devices were read. Returns the latest snapshot after two periods even if nothing new was published
+         *
+         * @param sequence sequence number of the last snapshot the caller used
+         * @return SensorSnapshot - a copy of the latest snapshot
+         *
+         * <h3> Example Usage </h3>
+         * @code
+         * uint32_t sequence = 0;
+         * while (true) {
+         *     const robot::SensorSnapshot snapshot = sensorHub.waitForUpdate(sequence);
+         *     sequence = snapshot.sequence;
+         *     // use the snapshot
+         * }
+         * @endcode
+         */
+        SensorSnapshot waitForUpdate(uint32_t sequence);
+        /**
+         * @brief Get the number of device reads per snapshot
+         *
+         * @return uint32_t
+         */
+        uint32_t getReadsPerSnapshot();
+        /**
+         * @brief Get the number of device reads since the hub started
+         *
+         * @return uint32_t
+         */
+        uint32_t getTotalReads();
+        /**
+         * @brief Get the number of times a reader had to copy a snapshot again because the hub overwrote it
+         *
+         * @return uint32_t
+         */
+        uint32_t getRetries();
+    private:
+        pros::Motor* motors[SensorSnapshot::MAX_MOTORS];
+        uint8_t motorValues[SensorSnapshot::MAX_MOTORS];
+        int motorCount = 0;
+        pros::Rotation* rotations[SensorSnapshot::MAX_ROTATIONS];
+        uint8_t rotationValues[SensorSnapshot::MAX_ROTATIONS];
+        int rotationCount = 0;
+        pros::Imu* imu = nullptr;
+        pros::Controller* controller = nullptr;
+        uint8_t axes = 0;
+        uint16_t buttons = 0;
+        // time of the last request for a snapshot, in milliseconds
+        std::atomic<uint32_t> lastRequest {0};
+        std::atomic<uint32_t> totalReads {0};
+        int reference = -1;
+        pros::Task* task = nullptr;
+        // tasks waiting for the next snapshot, nullptr for free slots
+        pros::Mutex waiterMutex;
+        pros::task_t waiters[MAX_WAITERS] = {};
+        DoubleBuffer<SensorSnapshot> snapshots;
+};
+} // namespace robot
@@ -0,0 +1,135 @@
+/**
+ * @file include/robot/taskMonitor.hpp
+ * @brief Task CPU and stack monitor declarations
+ *
+ * Samples every task in the system through FreeRTOS's uxTaskGetSystemState, which the PROS kernel exports but does
+ * not declare in apix.h. CPU share comes from the kernel's run time counters, stack headroom from each task's high
+ * water mark.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include "pros/apix.h"
+#include "pros/rtos.hpp"
+
+namespace robot {
+/**
+ * @brief A snapshot of a single task
+ *
+ */
+struct TaskSample {
+        /** handle of the task */
+        pros::task_t handle;
+        /** name of the task. Tasks created without a name have an empty name */
+        char name[TASK_NAME_MAX_LEN];
+        /** current priority */
+        uint32_t priority;
+        /** share of the cpu used since the previous sample, in percent */
+        float cpu;
+        /** least amount of free stack the task has ever had, in words */
+        uint32_t freeStack;
+        /** whether the task is over its cpu budget or under its stack budget */
+        bool overBudget;
+};
+
+/**
+ * @brief Task CPU and stack monitor
+ *
+ * <h3> Example Usage </h3>
+ * @code
+ * robot::TaskMonitor monitor;
+ * monitor.setBudget("screen", 5, 256);
+ * monitor.start(1000);
+ * @endcode
+ */
+class TaskMonitor {
+    public:
+        /** @brief maximum number of tasks that can be sampled */
+        static constexpr int MAX_TASKS = 32;
+        /** @brief maximum number of budgets */
+        static constexpr int MAX_BUDGETS = 16;
+
+        TaskMonitor() = default;
+        TaskMonitor(const TaskMonitor&) = delete;
+        TaskMonitor& operator=(const TaskMonitor&) = delete;
+        /**
+         * @brief Set the budget of a task
+         *
+         * Tasks that use more cpu or have less free stack than their budget are flagged, and a warning is logged
+         * through the info sink the first time it happens.
+         *
+         * @param name name of the task. Must outlive the monitor
+         * @param maxCpu maximum share of the cpu the task may use, in percent. 0 for no limit
+         * @param minFreeStack minimum free stack the task should keep, in words. 0 for no limit
+         */
+        void setBudget(const char* name, float maxCpu, uint32_t minFreeStack);
+        /**
+         * @brief Take a sample of all tasks
+         *
+         * CPU usage is measured between consecutive calls
+         */
+        void sample();
+        /**
+         * @brief Start sampling periodically in a low priority task
+         *
+         * The task is "taskMonitor" in the task registry
+         *
+         * Each sample is sent to the telemetry sink, one message per task in the form "task,<name>,<cpu>,<stack>"
+         *
+         * @param period time between samples, in milliseconds
+         */
+        void start(uint32_t period);
+        /**
+         * @brief Copy the most recent samples
+         *
+         * @param samples array to copy to
+         * @param maxSamples size of the array
+         * @return int - the number of samples copied
+         */
+        int getSamples(TaskSample* samples, int maxSamples);
+        /**
+         * @brief Get the highest cpu usage of any task other than the idle task in the most recent sample
+         *
+         * @return float - cpu usage, in percent
+         */
+        float getMaxCpu();
+        /**
+         * @brief Get the lowest free stack of any task in the most recent sample
+         *
+         * @return uint32_t - free stack, in words
+         */
+        uint32_t getMinFreeStack();
+        /**
+         * @brief Get the number of tasks that were over budget in the most recent sample
+         *
+         * @return int
+         */
+        int getOverBudgetCount();
+    private:
+        struct Budget {
+                const char* name;
+                float maxCpu;
+                uint32_t minFreeStack;
+                bool warned;
+        };
+
+        struct RunTime {
+                pros::task_t handle;
+                uint32_t counter;
+        };
+
+        Budget* findBudget(const char* name);
+
+        pros::Mutex mutex;
+        pros::Task* task = nullptr;
+        Budget budgets[MAX_BUDGETS];
+        int budgetCount = 0;
+        TaskSample samples[MAX_TASKS];
+        int sampleCount = 0;
+        // run time counters from the previous sample
+        RunTime previous[MAX_TASKS];
+        int previousCount = 0;
+        uint32_t previousTotal = 0;
+};
+} // namespace robot
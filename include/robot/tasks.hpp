@@ -0,0 +1,126 @@
+/**
+ * @file include/robot/tasks.hpp
+ * @brief Task registry declarations
+ *
+ * Every task the project runs is listed in one table with its priority, stack size and period, so the layout of the
+ * whole program can be read in one place. Tasks that close control loops run above the competition tasks, which run
+ * above SD card and serial I/O, which runs above the screen and diagnostics. A task that misses its period because
+ * the screen was redrawing is a bug; a screen that redraws late is not.
+ *
+ * Tasks created inside LemLib can't be given a priority when they are created, so they are adopted: the registry
+ * finds the tasks a function created and applies the configured priority to them.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include "pros/rtos.hpp"
+
+namespace robot {
+namespace tasks {
+/** @brief tasks that close control loops: odometry, motions and sensor sampling */
+constexpr uint32_t PRIORITY_CONTROL = TASK_PRIORITY_DEFAULT + 2;
+/** @brief the autonomous and driver control tasks PROS creates */
+constexpr uint32_t PRIORITY_COMPETITION = TASK_PRIORITY_DEFAULT;
+/** @brief tasks that move data to the SD card or over serial */
+constexpr uint32_t PRIORITY_IO = TASK_PRIORITY_DEFAULT - 3;
+/** @brief tasks that draw to the brain screen or the controller */
+constexpr uint32_t PRIORITY_UI = TASK_PRIORITY_DEFAULT - 5;
+/** @brief diagnostics that only matter when nothing else needs the cpu */
+constexpr uint32_t PRIORITY_DIAGNOSTIC = TASK_PRIORITY_MIN + 1;
+/** @brief maximum number of tasks in the registry */
+constexpr int MAX_TASKS = 24;
+
+/**
+ * @brief Configuration of a task
+ *
+ */
+struct TaskConfig {
+        /** name of the task. Must outlive the registry */
+        const char* name;
+        /** priority, usually one of the PRIORITY constants */
+        uint32_t priority;
+        /** stack size, in words */
+        uint16_t stackDepth;
+        /** time between iterations of the task's loop, in milliseconds. 0 if the task waits on events instead */
+        uint32_t period;
+};
+
+/**
+ * @brief Add a task to the registry
+ *
+ * The registry starts with every task the project itself runs. Subsystems with tasks of their own register them here
+ * before creating them. Registering a name that is already in the registry replaces its configuration
+ *
+ * @param config configuration of the task
+ * @return true the task was registered
+ * @return false the registry is full
+ */
+bool registerTask(const TaskConfig& config);
+
+/**
+ * @brief Get the configuration of a task
+ *
+ * @param name name of the task
+ * @return const TaskConfig* - the configuration, or nullptr if the task is not registered
+ */
+const TaskConfig* find(const char* name);
+
+/**
+ * @brief Get the period of a task
+ *
+ * @param name name of the task
+ * @return uint32_t - period, in milliseconds. 0 if the task is not registered or has no period
+ */
+uint32_t getPeriod(const char* name);
+
+/**
+ * @brief Create a task with its configured priority and stack size
+ *
+ * Tasks that aren't registered are created with the default priority and stack size, and a warning is logged
+ *
+ * @param name name of the task
+ * @param function function the task runs
+ * @return pros::Task* - the task. Never freed, tasks in this project run until the program ends
+ *
+ * <h3> Example Usage </h3>
+ * @code
+ * robot::tasks::create("screen", []() {
+ *     while (true) {
+ *         // draw
+ *         pros::delay(robot::tasks::getPeriod("screen"));
+ *     }
+ * });
+ * @endcode
+ */
+pros::Task* create(const char* name, std::function<void()> function);
+
+/**
+ * @brief Apply a configuration to the tasks a function creates
+ *
+ * For tasks created where the priority can't be chosen, like in LemLib. Tasks created by the function get the
+ * configured priority of the given name, and are listed under that name in the report. Tasks are found by their
+ * FreeRTOS task number, so a task another task creates while the function runs is adopted too. With more than
+ * MAX_TASKS * 2 tasks running, FreeRTOS can't list them, so the function still runs but nothing is adopted
+ *
+ * @param name name of the task in the registry
+ * @param function function that creates the task
+ * @return int - the number of tasks adopted
+ *
+ * <h3> Example Usage </h3>
+ * @code
+ * robot::tasks::adopt("lemlib odom", []() { chassis.calibrate(); });
+ * @endcode
+ */
+int adopt(const char* name, const std::function<void()>& function);
+
+/**
+ * @brief Log the task table through the info sink, at debug level
+ *
+ * Lists every registered task with its configured and current priority, stack size, free stack and period, followed
+ * by any running task that isn't registered
+ */
+void report();
+} // namespace tasks
+} // namespace robot
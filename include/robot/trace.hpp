@@ -0,0 +1,163 @@
+/**
+ * @file include/robot/trace.hpp
+ * @brief Hot path trace macros
+ *
+ * Tracing is compiled out unless ROBOT_TRACE is defined, e.g. by adding -DROBOT_TRACE to EXTRA_CXXFLAGS in the
+ * Makefile. When compiled out, every macro expands to nothing.
+ *
+ * When compiled in, each task writes 12 byte binary events into its own lock free ring, so tracing never blocks and
+ * tasks never contend with each other. Events are timestamped with pros::micros(), or with the Cortex-A9 cycle
+ * counter if ROBOT_TRACE_CYCLES is also defined. Rings are dumped on demand to a file on the SD card or to the
+ * serial port, and tools/trace2json.py converts the dump to Chrome trace JSON, which Perfetto can also open.
+ *
+ * <h3> Example Usage </h3>
+ * @code
+ * void update() {
+ *     TRACE_SCOPE("update");
+ *     int written = writeOutputs();
+ *     TRACE_COUNTER("outputs written", written);
+ * }
+ * // later, when the robot is disabled
+ * robot::trace::dumpToFile("/usd/trace.bin");
+ * @endcode
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+
+namespace robot {
+namespace trace {
+/**
+ * @brief Type of a trace event
+ *
+ */
+enum class EventType : uint8_t { BEGIN, END, COUNTER };
+
+/**
+ * @brief A single trace event, as stored in the rings and written to dumps
+ *
+ */
+struct Event {
+        /** timestamp, in microseconds or cycles */
+        uint32_t time;
+        /** id of the event name */
+        uint16_t name;
+        /** EventType of the event */
+        uint8_t type;
+        /** index of the ring that recorded the event */
+        uint8_t ring;
+        /** value of a counter event, 0 otherwise */
+        int32_t value;
+};
+
+#ifdef ROBOT_TRACE
+/** @brief maximum number of tasks that can record events at once. A deleted task's ring is reused once it is dumped */
+constexpr int MAX_RINGS = 8;
+/** @brief number of events each task can hold before events are dropped. Must be a power of 2 */
+constexpr int RING_SIZE = 1024;
+/** @brief maximum number of distinct event names */
+constexpr int MAX_NAMES = 128;
+
+/**
+ * @brief Get the id of an event name, registering it if it is new
+ *
+ * @param name name of the event. Must be a string literal or otherwise outlive the program
+ * @return uint16_t - id of the name
+ */
+uint16_t intern(const char* name);
+/**
+ * @brief Record an event from the current task
+ *
+ * @param type type of the event
+ * @param name id of the event name
+ * @param value value of counter events
+ */
+void record(EventType type, uint16_t name, int32_t value = 0);
+/**
+ * @brief Write all recorded events to a file in binary form, and clear the rings
+ *
+ * @param path path of the file, e.g. "/usd/trace.bin"
+ * @return true the dump was written
+ * @return false the file could not be opened
+ */
+bool dumpToFile(const char* path);
+/**
+ * @brief Write all recorded events to the serial port as text, one event per line, and clear the rings
+ *
+ * Each line is "trace,<task>,<type>,<name>,<time>,<value>"
+ */
+void dumpToSerial();
+/**
+ * @brief Get the number of events dropped because a ring was full
+ *
+ * @return uint32_t
+ */
+uint32_t getDropped();
+
+/**
+ * @brief Records a begin event when constructed and an end event when destroyed
+ *
+ */
+class Scope {
+    public:
+        explicit Scope(uint16_t name) : name(name) { record(EventType::BEGIN, name); }
+
+        ~Scope() { record(EventType::END, name); }
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+    private:
+        uint16_t name;
+};
+
+#define ROBOT_TRACE_CONCAT_(a, b) a##b
+#define ROBOT_TRACE_CONCAT(a, b) ROBOT_TRACE_CONCAT_(a, b)
+// the name is interned once per call site, the first time it is reached
+#define ROBOT_TRACE_ID(name)                                                                                           \
+    static const uint16_t ROBOT_TRACE_CONCAT(traceId, __LINE__) = robot::trace::intern(name)
+
+/** @brief Trace the rest of the enclosing scope */
+#define TRACE_SCOPE(name)                                                                                              \
+    ROBOT_TRACE_ID(name);                                                                                              \
+    robot::trace::Scope ROBOT_TRACE_CONCAT(traceScope, __LINE__)(ROBOT_TRACE_CONCAT(traceId, __LINE__))
+/** @brief Begin a traced region. Must be matched by TRACE_END with the same name in the same task */
+#define TRACE_BEGIN(name)                                                                                              \
+    do {                                                                                                               \
+        ROBOT_TRACE_ID(name);                                                                                          \
+        robot::trace::record(robot::trace::EventType::BEGIN, ROBOT_TRACE_CONCAT(traceId, __LINE__));                   \
+    } while (0)
+/** @brief End a traced region */
+#define TRACE_END(name)                                                                                                \
+    do {                                                                                                               \
+        ROBOT_TRACE_ID(name);                                                                                          \
+        robot::trace::record(robot::trace::EventType::END, ROBOT_TRACE_CONCAT(traceId, __LINE__));                     \
+    } while (0)
+/** @brief Record the value of a counter */
+#define TRACE_COUNTER(name, value)                                                                                     \
+    do {                                                                                                               \
+        ROBOT_TRACE_ID(name);                                                                                          \
+        robot::trace::record(robot::trace::EventType::COUNTER, ROBOT_TRACE_CONCAT(traceId, __LINE__),                  \
+                             static_cast<int32_t>(value));                                                             \
+    } while (0)
+#else
+inline bool dumpToFile(const char*) { return false; }
+
+inline void dumpToSerial() {}
+
+inline uint32_t getDropped() { return 0; }
+
+#define TRACE_SCOPE(name)
+#define TRACE_BEGIN(name)                                                                                              \
+    do {                                                                                                               \
+    } while (0)
+#define TRACE_END(name)                                                                                                \
+    do {                                                                                                               \
+    } while (0)
+#define TRACE_COUNTER(name, value)                                                                                     \
+    do {                                                                                                               \
+    } while (0)
+#endif
+} // namespace trace
+} // namespace robot
@@ -0,0 +1,253 @@
+/**
+ * @file include/robot/triballTracker.hpp
+ * @brief Vision sensor triball tracker declarations
+ *
+ * The vision sensor reports boxes around every object that matches a color signature, in pixels, with no idea which
+ * box in one frame is which box in the next. The tracker turns them into triballs on the field:
+ * - every frame, read_by_sig copies up to MAX_OBJECTS boxes into a fixed array
+ * - each box's bottom edge, where the triball touches the floor, is projected through the camera onto the floor, and
+ * from the robot onto the field using the pose at the time the frame was taken. Poses are kept in a short history,
+ * since the frame is older than the latest pose by the sensor's latency
+ * - each field position is matched to the nearest predicted track within GATE, closest pairs first, and updates that
+ * track's constant velocity Kalman filter. Positions that match nothing start new tracks
+ * - tracks become confirmed after CONFIRM_HITS frames, and are dropped once unseen for TRACK_TIMEOUT
+ *
+ * Confirmed tracks are published like SensorHub snapshots, so any task can copy them without blocking.
+ * MotionWorker::moveToNearestTriball drives to the nearest one.
+ *
+ * Nothing is allocated after construction. process() takes a frame and does the rest without reading any device, so
+ * recorded frames can be replayed through it on the host with poses given to recordPose().
+ */
+
+#pragma once
+
+#include <cstdint>
+#include "pros/rtos.hpp"
+#include "pros/vision.hpp"
+#include "robot/clock.hpp"
+#include "robot/doubleBuffer.hpp"
+#include "robot/poseSource.hpp"
+
+namespace robot {
+/**
+ * @brief Where the vision sensor is mounted on the robot
+ *
+ */
+struct CameraMount {
+        /** distance of the lens in front of the tracking center, in inches */
+        float forward;
+        /** distance of the lens to the right of the tracking center, in inches */
+        float right;
+        /** height of the lens above the floor, in inches */
+        float height;
+        /** angle the sensor is tilted down from horizontal, in degrees */
+        float pitch;
+        /** focal length, in pixels. 61 degrees across 316 pixels is about 270 */
+        float focalLength = 270;
+        /** time from the sensor taking a frame to the frame being read, in microseconds */
+        uint32_t latency = 20000;
+        /** triballs projected further away than this are ignored, in inches */
+        float maxRange = 96;
+};
+
+/**
+ * @brief Objects the vision sensor saw in one frame
+ *
+ */
+struct VisionFrame {
+        /** @brief maximum number of objects in a frame */
+        static constexpr int MAX_OBJECTS = 8;
+
+        /** time the frame was read, in microseconds */
+        uint64_t micros;
+        /** number of objects */
+        int count;
+        /** objects, largest first, with coordinates from the top left of the image */
+        pros::vision_object_s_t objects[MAX_OBJECTS];
+};
+
+/**
+ * @brief A tracked triball
+ *
+ */
+struct Triball {
+        /** id of the track, unique since the tracker was constructed */
+        uint32_t id;
+        /** estimated x position on the field, in inches */
+        float x;
+        /** estimated y position on the field, in inches */
+        float y;
+        /** estimated x velocity, in inches per second */
+        float vx;
+        /** estimated y velocity, in inches per second */
+        float vy;
+        /** number of frames the triball was seen in */
+        uint32_t hits;
+        /** time the triball was last seen, in microseconds */
+        uint64_t lastSeen;
+};
+
+/**
+ * @brief Every confirmed triball at one point in time
+ *
+ */
+struct TriballSet {
+        /** @brief maximum number of triballs tracked at once */
+        static constexpr int MAX_TRIBALLS = 8;
+
+        /** number of frames processed up to and including this one. 0 until the first frame */
+        uint32_t sequence;
+        /** time of the frame, in microseconds */
+        uint64_t micros;
+        /** number of triballs */
+        int count;
+        /** triballs, in no particular order */
+        Triball triballs[MAX_TRIBALLS];
+
+        /**
+         * @brief Find the triball nearest a point
+         *
+         * @param x x position, in inches
+         * @param y y position, in inches
+         * @return const Triball* - the nearest triball, or nullptr if there are none
+         */
+        const Triball* nearest(float x, float y) const;
+};
+
+/**
+ * @brief Tracks triballs seen by a vision sensor on the field
+ *
+ * <h3> Example Usage </h3>
+ * @code
+ * pros::Vision vision(7);
+ * robot::TriballTracker tracker(&vision, 1, poseSource, {6, 0, 10, 20});
+ * tracker.start();
+ * // in any task
+ * const robot::TriballSet set = tracker.get();
+ * const robot::Triball* triball = set.nearest(pose.x, pose.y);
+ * @endcode
+ */
+class TriballTracker {
+    public:
+        /** @brief distance a triball can be from the track's predicted position and still match it, in inches */
+        static constexpr float GATE = 10;
+        /** @brief number of frames a track has to be seen in before it is published */
+        static constexpr uint32_t CONFIRM_HITS = 3;
+        /** @brief time a track can go unseen before it is dropped, in microseconds */
+        static constexpr uint64_t TRACK_TIMEOUT = 1000000;
+        /** @brief number of poses kept to look up the pose a frame was taken at */
+        static constexpr int POSE_HISTORY = 16;
+
+        /**
+         * @brief Construct a new Triball Tracker
+         *
+         * @param sensor the vision sensor, or nullptr to only process frames given to process()
+         * @param signature signature id of triballs on the sensor, from 1 to 7
+         * @param poses the pose, read once per frame. Must outlive the tracker
+         * @param mount where the sensor is on the robot
+         * @param clock clock to time frames with. Must outlive the tracker
+         */
+        TriballTracker(pros::Vision* sensor, uint32_t signature, PoseSource& poses, const CameraMount& mount,
+                       Clock& clock = systemClock());
+        TriballTracker(const TriballTracker&) = delete;
+        TriballTracker& operator=(const TriballTracker&) = delete;
+        /**
+         * @brief Start the "vision" task
+         *
+         */
+        void start();
+        /**
+         * @brief Record the pose, read a frame from the sensor and process it
+         *
+         * Called by the vision task once per frame
+         */
+        void update();
+        /**
+         * @brief Read the objects matching the signature from the sensor
+         *
+         * @return VisionFrame - the frame, empty if the read failed
+         */
+        VisionFrame read();
+        /**
+         * @brief Add a pose to the history frames are projected with
+         *
+         * Only one task may record poses and process frames
+         *
+         * @param pose the pose, timed with the same clock as the frames
+         */
+        void recordPose(const PoseSample& pose);
+        /**
+         * @brief Match the objects in a frame to tracks, update the tracks and publish the confirmed ones
+         *
+         * @param frame the frame. Frames must be processed in order of time
+         */
+        void process(const VisionFrame& frame);
+        /**
+         * @brief Project an object onto the field
+         *
+         * @param object the object, with coordinates from the top left of the image
+         * @param pose the pose of the robot when the frame was taken
+         * @param x set to the x position of the triball, in inches
+         * @param y set to the y position of the triball, in inches
+         * @return true the object is on the floor within range
+         * @return false the object is above the horizon or out of range, and x and y are unchanged
+         */
+        bool project(const pros::vision_object_s_t& object, const PoseSample& pose, float& x, float& y);
+        /**
+         * @brief Get the latest confirmed triballs
+         *
+         * Safe to call from any number of tasks at once. Never blocks
+         *
+         * @return TriballSet - a copy of the latest set
+         */
+        TriballSet get();
+    private:
+        struct Axis {
+                // position and velocity, and their covariance [[pp, pv], [pv, vv]]
+                float p;
+                float v;
+                float pp;
+                float pv;
+                float vv;
+
+                void predict(float dt);
+                void correct(float z);
+        };
+
+        struct Track {
+                uint32_t id;
+                Axis x;
+                Axis y;
+                uint32_t hits;
+                uint64_t lastSeen;
+        };
+
+        /**
+         * @brief Interpolate the pose at a time from the history
+         *
+         * @return false the history is empty
+         */
+        bool poseAt(uint64_t micros, PoseSample& pose);
+        /**
+         * @brief Copy the confirmed tracks into the next buffer and publish it
+         *
+         */
+        void publish(uint64_t micros);
+
+        pros::Vision* const sensor;
+        const uint32_t signature;
+        PoseSource& poses;
+        const CameraMount mount;
+        Clock& clock;
+        pros::Task* task = nullptr;
+        // ring of the latest poses, oldest first from poseNext once full
+        PoseSample history[POSE_HISTORY] = {};
+        int poseCount = 0;
+        int poseNext = 0;
+        Track tracks[TriballSet::MAX_TRIBALLS] = {};
+        int trackCount = 0;
+        uint32_t nextId = 1;
+        uint64_t lastFrame = 0;
+        DoubleBuffer<TriballSet> sets;
+};
+} // namespace robot
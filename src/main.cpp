@@ -2,10 +2,27 @@
 #include "lemlib/api.hpp"
 #include "lemlib/logger/stdout.hpp"
 #include "pros/misc.h"
+#include "robot/bench.hpp"
+#include "robot/config.hpp"
+#include "robot/coroutine.hpp"
+#include "robot/dashboard.hpp"
+#include "robot/fieldMap.hpp"
+#include "robot/imuStartup.hpp"
+#include "robot/intake.hpp"
+#include "robot/latency.hpp"
+#include "robot/motionWorker.hpp"
+#include "robot/outputs.hpp"
+#include "robot/poseSource.hpp"
+#include "robot/recorder.hpp"
+#include "robot/sdLogger.hpp"
+#include "robot/sensorHub.hpp"
+#include "robot/taskMonitor.hpp"
+#include "robot/tasks.hpp"
+#include "robot/trace.hpp"
 
 // Controller and Sensors
 pros::Controller controller(pros::E_CONTROLLER_MASTER);
-pros::Imu imu(17);
+robot::CorrectedImu imu(17); // corrects the drift measured while the robot sits still
 pros::Rotation cata_rot(16);
 
 // Pneumatics and 3Wire
@@ -77,6 +94,81 @@ lemlib::OdomSensors sensors(
 
 // create the chassis
 lemlib::Chassis chassis(drivetrain, linearController, angularController, sensors);
+// runs chassis motions in one task instead of a new task per motion
+robot::MotionWorker motions(drivetrain, linearController, angularController);
+
+// tuning parameters. the values above and below are defaults, overridden by /usd/config.txt at startup and changed
+// over serial while the program runs, so tuning doesn't need a rebuild
+robot::ConfigStore config("/usd/config.txt");
+const int linearKP = config.add("linear.kP", linearController.kP, 0, 100);
+const int linearKD = config.add("linear.kD", linearController.kD, 0, 500);
+const int angularKP = config.add("angular.kP", angularController.kP, 0, 100);
+const int angularKD = config.add("angular.kD", angularController.kD, 0, 500);
+const int trackWidth = config.add("drivetrain.trackWidth", drivetrain.trackWidth, 8, 18);
+const int underHangLookahead = config.add("path.underHang.lookahead", 15, 1, 40);
+const int curveGoalLookahead = config.add("path.curveGoal.lookahead", 10, 1, 40);
+
+// LemLib's pose, copied once per odometry update so any task can read a consistent pose without blocking. okapi
+// controllers read it through robot::LemLibOdometry instead of running their own odometry
+robot::PoseSource poseSource;
+
+// brain screen dashboard and field map
+robot::Dashboard dashboard;
+robot::FieldMap fieldMap;
+
+// task cpu and stack monitor
+robot::TaskMonitor taskMonitor;
+
+// records raw sensor values during auto so the run can be replayed on a computer with host/tools/replay.cpp
+robot::Recorder recorder(drivetrain, &imu, &cata_rot, &controller);
+// calibrates the inertial sensor without blocking, and keeps its measured drift on the SD card
+robot::ImuStartup imuStartup(chassis, imu, drivetrain, "/usd/imu.bin");
+
+// one record per driver control loop, logged to the SD card
+struct DriveRecord {
+        uint32_t time;
+        float x;
+        float y;
+        float theta;
+        int16_t leftY;
+        int16_t rightY;
+};
+
+robot::SdLogger driveLogger("/usd/drive", sizeof(DriveRecord));
+
+// reads the controller and sensors once per tick for every task that uses them, and only what opcontrol uses
+robot::SensorHub sensorHub;
+const int cataRotation = sensorHub.addRotation(&cata_rot, robot::RotationSnapshot::ANGLE);
+// a drive motor's update timestamps tell the hub when fresh device data arrives
+const int phaseMotor = sensorHub.addMotor(&lF, robot::MotorSnapshot::RAW_POSITION);
+
+// runs the intake from an optical sensor, stopping as soon as a triball is in. the intake task is the only thing
+// that writes the intake motor. there is no optical sensor on the robot yet, so until one is plugged in and passed
+// here in place of nullptr, the intake runs like the manual one
+robot::Intake triballIntake(&intake, nullptr);
+
+// driver control commands, written once per tick and only when they change
+robot::Outputs outputs;
+// chassis.tank with no curve gain moves each side straight to the joystick value
+const int leftDriveOutput = outputs.addMotorGroup(&leftMotors);
+const int rightDriveOutput = outputs.addMotorGroup(&rightMotors);
+const int cataOutput = outputs.addMotor(&cata);
+const int wingsOutput = outputs.addDigital(&wings);
+const int blockerOutput = outputs.addDigital(&blocker);
+// time from a device update to the driver control commands computed from it. does nothing unless ROBOT_LATENCY is
+// defined
+robot::LatencyHistogram driverLatency;
+
+/**
+ * Follow a path and show it on the field map until the motion ends
+ */
+void followPath(const asset& path, float lookahead, int timeout, bool forwards = true) {
+    TRACE_SCOPE("followPath");
+    motions.follow(path, lookahead, timeout, forwards);
+    // returns once the motion has started, so it is the last one started
+    const uint32_t motion = motions.getStats().motions;
+    fieldMap.setPath(path, lookahead, [motion]() { return motions.getStats().finished < motion; });
+}
 
 /**
  * Runs initialization code. This occurs as soon as the program is started.
@@ -86,13 +178,29 @@ lemlib::Chassis chassis(drivetrain, linearController, angularController, sensors
  */
 
 void initialize() {
+    // LemLib's output task is created the first time anything is logged
+    robot::tasks::adopt("lemlib stdout", []() { lemlib::bufferedStdout(); });
+    // print benchmark results to the terminal. does nothing unless ROBOT_BENCH is defined
+    robot::bench::runAll(sensors, drivetrain);
     chassis.setPose(0, 0, 0); //set the pose to origin
-    pros::lcd::initialize(); // initialize brain screen
+    // initialize brain screen. fields are only redrawn when their displayed value changes
+    const int xField = dashboard.addField("X", 2);
+    const int yField = dashboard.addField("Y", 2);
+    const int thetaField = dashboard.addField("Theta", 1);
+    const int cpuField = dashboard.addField("Max CPU %", 1);
+    const int stackField = dashboard.addField("Min stack", 0);
+    const int overBudgetField = dashboard.addField("Over budget", 0);
+    const int cyclesField = dashboard.addField("Cycles", 0);
+    dashboard.init();
+    fieldMap.init(250, 10, 220);
     //set motors brake modes
     leftMotors.set_brake_modes(pros::E_MOTOR_BRAKE_COAST);
     rightMotors.set_brake_modes(pros::E_MOTOR_BRAKE_COAST);
     cata.set_brake_mode(pros::E_MOTOR_BRAKE_HOLD);
     intake.set_brake_mode(pros::E_MOTOR_BRAKE_HOLD);
+    // record the mechanisms too, after the drivetrain
+    recorder.addMotor(&cata);
+    recorder.addMotor(&intake);
 
     // the default rate is 50. however, if you need to change the rate, you
     // can do the following.
@@ -102,31 +210,120 @@ void initialize() {
     // for more information on how the formatting for the loggers
     // works, refer to the fmtlib docs
 
+    // flag tasks that use too much cpu or come close to overflowing their stack
+    taskMonitor.setBudget("screen", 5, 512);
+    taskMonitor.setBudget("User Operator Control (PROS)", 20, 512);
+    taskMonitor.setBudget("User Autonomous (PROS)", 20, 512);
+    taskMonitor.start(robot::tasks::getPeriod("taskMonitor"));
+    // end motions that push against something for 200ms instead of waiting for their timeout. stalled means the
+    // drive motors average under 30rpm while drawing over 1.8A, checked once the first 300ms of a motion have passed
+    motions.setStallDetection({30, 1800, 200, 300});
+    // create the motion task now rather than in the first motion of autonomous
+    motions.start();
+    // copy every new set of tuning parameters into the motion worker, which the running motion picks up on its next
+    // iteration. odometry keeps the track width from calibration, only follow steers with a new one. then read the
+    // saved parameters and listen for serial commands like "set linear.kP 12" or "reload"
+    config.onChange([](const robot::ConfigSet& set) {
+        lemlib::ControllerSettings linear = linearController;
+        lemlib::ControllerSettings angular = angularController;
+        linear.kP = set[linearKP];
+        linear.kD = set[linearKD];
+        angular.kP = set[angularKP];
+        angular.kD = set[angularKD];
+        motions.setControllerSettings(linear, angular, set[trackWidth]);
+    });
+    config.load();
+    config.start();
+    // start writing driver control logs. does nothing if there is no SD card
+    driveLogger.start();
+    // start reading the controller every tick, just after the devices update
+    using robot::SensorHub;
+    sensorHub.setController(&controller,
+                            SensorHub::axis(pros::E_CONTROLLER_ANALOG_LEFT_Y) |
+                                SensorHub::axis(pros::E_CONTROLLER_ANALOG_RIGHT_Y),
+                            SensorHub::button(pros::E_CONTROLLER_DIGITAL_A) |
+                                SensorHub::button(pros::E_CONTROLLER_DIGITAL_B) |
+                                SensorHub::button(pros::E_CONTROLLER_DIGITAL_R2) |
+                                SensorHub::button(pros::E_CONTROLLER_DIGITAL_L1) |
+                                SensorHub::button(pros::E_CONTROLLER_DIGITAL_L2));
+    sensorHub.setPhaseReference(phaseMotor);
+    sensorHub.start();
+
+    // publish the pose for the screen task below
+    poseSource.start();
+    // sample the intake's optical sensor after every device update
+    triballIntake.start();
+
     // thread to for brain screen and position logging
-    pros::Task screenTask([&]() {
+    robot::tasks::create("screen", [=]() {
+        uint64_t busyMicros = 0;
+        uint32_t lastReport = pros::millis();
         while (true) {
+            const uint64_t start = pros::micros();
+            const robot::PoseSample sample = poseSource.get();
+            const lemlib::Pose pose(sample.x, sample.y, sample.theta);
             // print robot location to the brain screen
-            pros::lcd::print(0, "X: %f", chassis.getPose().x); // x
-            pros::lcd::print(1, "Y: %f", chassis.getPose().y); // y
-            pros::lcd::print(2, "Theta: %f", chassis.getPose().theta); // heading
+            dashboard.set(xField, pose.x); // x
+            dashboard.set(yField, pose.y); // y
+            dashboard.set(thetaField, pose.theta); // heading
+            dashboard.set(cpuField, taskMonitor.getMaxCpu());
+            dashboard.set(stackField, taskMonitor.getMinFreeStack());
+            dashboard.set(overBudgetField, taskMonitor.getOverBudgetCount());
+            dashboard.set(cyclesField, triballIntake.getStats().cycles);
+            dashboard.update();
+            fieldMap.update(pose);
             // log position telemetry
-            lemlib::telemetrySink()->info("Chassis pose: {}", chassis.getPose());
+            TRACE_BEGIN("telemetry log");
+            lemlib::telemetrySink()->info("Chassis pose: {}", pose);
+            TRACE_END("telemetry log");
+            busyMicros += pros::micros() - start;
+            // report how much cpu time the screen task uses every 5 seconds
+            if (pros::millis() - lastReport >= 5000) {
+                const robot::DashboardStats stats = dashboard.getStats();
+                lemlib::infoSink()->debug("screen task: {} us busy per second, dashboard avg {} us max {} us, {} "
+                                          "label writes",
+                                          static_cast<uint32_t>(busyMicros / 5),
+                                          static_cast<uint32_t>(stats.totalMicros / (stats.updates ? stats.updates : 1)),
+                                          stats.maxMicros, stats.labelWrites);
+                dashboard.resetStats();
+                busyMicros = 0;
+                lastReport = pros::millis();
+            }
             // delay to save resources
-            pros::delay(50);
+            pros::delay(robot::tasks::getPeriod("screen"));
         }
     });
+    // print every task with its priority and stack
+    robot::tasks::report();
 }
 
 /**
  * Runs while the robot is disabled
  */
-void disabled() {}
+void disabled() {
+    // save any trace events recorded so far. does nothing unless ROBOT_TRACE is defined
+    robot::trace::dumpToFile("/usd/trace.bin");
+    // save the recording of the last auto run
+    if (recorder.stop()) recorder.save("/usd/replay.bin");
+    // write out the rest of the driver control log
+    driveLogger.sync();
+    // keep the drift measured so far for the next fast start
+    imuStartup.save();
+    const robot::OutputCounts counts = outputs.getTotals();
+    lemlib::infoSink()->debug("driver outputs: {} commands, {} overwritten, {} unchanged, {} writes", counts.commands,
+                              counts.overwritten, counts.unchanged, counts.writes);
+    driverLatency.report("driver input to output");
+    driverLatency.reset();
+}
 
 /**
  * runs after initialize if the robot is connected to field control
  */
 void competition_initialize() {
-    chassis.calibrate(); // calibrate sensors
+    // calibrate sensors in the background. this starts LemLib's odometry task, which runs above everything but other
+    // control loops. with a saved drift the sensor's power on calibration is kept and odometry starts right away,
+    // otherwise the sensor is reset, which takes around 3 seconds
+    imuStartup.start(true);
     chassis.setPose(0, 0, 0); //set the pose to origin
 }
 
@@ -137,60 +334,143 @@ ASSET(pathUnderHang_txt);   //path for curve under goal. After 35in,
                             //drop off triball.
 ASSET(pathCurveGoal_txt);   //path that curves 
 
+#ifdef __cpp_impl_coroutine
+// runs the autonomous routines in the autonomous task. Only built with --std=gnu++20 -fcoroutines, see
+// include/robot/coroutine.hpp
+robot::CoroutineExecutor autonExecutor;
+
+/**
+ * The autonomous drive as a coroutine. Each motion waits for the chassis to be idle instead of blocking in the motion
+ * call, so other routines spawned on autonExecutor keep running while it drives
+ */
+robot::Routine autonDrive() {
+    wings.set_value(true);
+    motions.moveToPose(11, -4, 309, 1000);
+    co_await robot::traveled(motions, 1);
+    wings.set_value(false);
+    triballIntake.intake();
+    // total time: 1000
+
+    co_await robot::idle(motions);
+    motions.moveToPose(41, -4, 90, 800);
+    co_await robot::traveled(motions, 2);
+    wings.set_value(true);
+    co_await robot::traveled(motions, 4);
+    triballIntake.outtake();
+    // total time: 1800
+
+    co_await robot::idle(motions);
+    motions.moveToPoint(20, -4, 600, false);
+    wings.set_value(false);
+    // total time: 2400
+
+    co_await robot::idle(motions);
+    motions.moveToPose(11, -20, 240, 700);
+    triballIntake.intake();
+    // total time: 3100
+
+    co_await robot::idle(motions);
+    followPath(pathUnderHang_txt, config.get(underHangLookahead), 3500);
+    co_await robot::traveled(motions, 35);
+    triballIntake.outtake();
+    co_await robot::traveled(motions, 40);
+    triballIntake.intake();
+    // total time: 6600
+
+    co_await robot::idle(motions);
+    motions.moveToPoint(30, -58, 300, false);
+    // total time: 6900
+
+    co_await robot::idle(motions);
+    motions.turnTo(40, -58, 600);
+    // total time: 7500
+
+    co_await robot::idle(motions);
+    followPath(pathCurveGoal_txt, config.get(curveGoalLookahead), 3000);
+    // total time: 10500
+
+    co_await robot::idle(motions);
+    followPath(pathCurveGoal_txt, config.get(curveGoalLookahead), 3000, false);
+    // total time: 13500
+
+    co_await robot::idle(motions);
+    motions.moveToPoint(8, -58, 300, false);
+    // total time: 13800
+}
+#endif
+
 /**
  * Runs during auto
  *
  * This is an example autonomous routine which demonstrates a lot of the features LemLib has to offer
  */
 void autonomous() {
+    // only waits if autonomous starts before calibration is done
+    imuStartup.waitUntilReady(3000);
     chassis.setPose(33,-53, 0); //set the pose to origin
-
+    recorder.start(); // record raw sensor values for replay
+
+#ifdef __cpp_impl_coroutine
+    // every routine runs in this task, alongside each other
+    autonExecutor.spawn(autonDrive());
+    autonExecutor.run();
+    const robot::ArenaStats arena = robot::CoroutineExecutor::getArenaStats();
+    lemlib::infoSink()->debug("coroutine frames: peak {} of {}, largest {} bytes", arena.peak, robot::COROUTINE_FRAMES,
+                              arena.largestFrame);
+#else
     wings.set_value(true);
-    chassis.moveToPose(11, -4, 309, 1000);
-    chassis.waitUntil(1);
+    motions.moveToPose(11, -4, 309, 1000);
+    motions.waitUntil(1);
     wings.set_value(false);
-    intake.move(127);
+    triballIntake.intake();
     // total time: 1000
 
-    chassis.moveToPose(41, -4, 90, 800);
-    chassis.waitUntil(2);
+    motions.moveToPose(41, -4, 90, 800);
+    motions.waitUntil(2);
     wings.set_value(true);
-    chassis.waitUntil(4);
-    intake.move(-127);
+    motions.waitUntil(4);
+    triballIntake.outtake();
     // total time: 1800
     
-    chassis.moveToPoint(20, -4, 600, false);
+    motions.moveToPoint(20, -4, 600, false);
     wings.set_value(false);
     // total time: 2400
 
-    chassis.moveToPose(11, -20, 240, 700);
-    intake.move(127);
+    motions.moveToPose(11, -20, 240, 700);
+    triballIntake.intake();
     // total time: 3100
 
-    chassis.follow(pathUnderHang_txt, 15, 3500);
-    chassis.waitUntil(35);
-    intake.move(-127);
-    chassis.waitUntil(40);
-    intake.move(127);
+    followPath(pathUnderHang_txt, config.get(underHangLookahead), 3500);
+    motions.waitUntil(35);
+    triballIntake.outtake();
+    motions.waitUntil(40);
+    triballIntake.intake();
     // total time: 6600
 
-    chassis.moveToPoint(30, -58, 300, false);
+    motions.moveToPoint(30, -58, 300, false);
     // total time: 6900
 
-    chassis.turnTo(40, -58, 600);
+    motions.turnTo(40, -58, 600);
     // total time: 7500
 
-    chassis.follow(pathCurveGoal_txt, 10, 3000);
+    followPath(pathCurveGoal_txt, config.get(curveGoalLookahead), 3000);
     // total time: 10500
 
-    chassis.follow(pathCurveGoal_txt, 10, 3000, false);
+    followPath(pathCurveGoal_txt, config.get(curveGoalLookahead), 3000, false);
     // total time: 13500
 
-    chassis.moveToPoint(8, -58, 300, false);
+    motions.moveToPoint(8, -58, 300, false);
     // total time: 13800
 
     // total excess time: 15000 - 13800 = 1200 msec. Distribute accordingly to testing.
 
+#endif
+    // report how long motions took to start
+    motions.waitUntilDone();
+    const robot::MotionStats stats = motions.getStats();
+    lemlib::infoSink()->debug("{} motions, startup latency avg {} us max {} us", stats.motions, stats.averageLatency,
+                              stats.maxLatency);
+
 
 
 
@@ -203,11 +483,21 @@ bool wingsvalue = false;
 bool blockervalue = false; 
 void opcontrol() {
     // controller
+    // a motion left running by autonomous would keep driving the drivetrain against the driver
+    motions.cancelAllMotions();
+    // autonomous commanded the motors and pistons directly, so write every command on the first tick
+    outputs.invalidate();
+    uint32_t sequence = 0;
     // loop to continuously update motors
     while (true) {
+        // run once per device update, right after the hub reads it. every button and sensor below comes from the same
+        // sample
+        const robot::SensorSnapshot snapshot = sensorHub.waitForUpdate(sequence);
+        sequence = snapshot.sequence;
+        TRACE_BEGIN("opcontrol loop");
         // get joystick positions
-        int leftY = controller.get_analog(pros::E_CONTROLLER_ANALOG_LEFT_Y);
-        int rightX = controller.get_analog(pros::E_CONTROLLER_ANALOG_RIGHT_Y);
+        int leftY = snapshot.analog[pros::E_CONTROLLER_ANALOG_LEFT_Y];
+        int rightX = snapshot.analog[pros::E_CONTROLLER_ANALOG_RIGHT_Y];
         if(abs(leftY)<15){
             leftY= 0;
         }
@@ -216,39 +506,51 @@ void opcontrol() {
         }
 
         // move the chassis with tank drive
-        chassis.tank(leftY, rightX);
+        outputs.move(leftDriveOutput, leftY);
+        outputs.move(rightDriveOutput, rightX);
 
 
 		//toggle wings
-		if(controller.get_digital(pros::E_CONTROLLER_DIGITAL_A)){
+		if(snapshot.pressed(pros::E_CONTROLLER_DIGITAL_A)){
             wingsvalue = !wingsvalue;
-            wings.set_value(wingsvalue);
+            outputs.set(wingsOutput, wingsvalue);
 		}
         //toggle blocker
-        if(controller.get_digital(pros::E_CONTROLLER_DIGITAL_B)){
+        if(snapshot.pressed(pros::E_CONTROLLER_DIGITAL_B)){
             blockervalue = !blockervalue;
-            blocker.set_value(blockervalue);
+            outputs.set(blockerOutput, blockervalue);
 		}
         //cata move function
         // cata.move(127 * controller.get_digital(pros::E_CONTROLLER_DIGITAL_R2));
-        if(controller.get_digital(pros::E_CONTROLLER_DIGITAL_R2)){
-            cata.move(127);     //if the button is pressed, cata moves
+        const int32_t cataAngle = snapshot.rotations[cataRotation].angle;
+        if(snapshot.pressed(pros::E_CONTROLLER_DIGITAL_R2)){
+            outputs.move(cataOutput, 127);     //if the button is pressed, cata moves
         }
         else{
-            cata.move(127);
-            if (cata_rot.get_angle() > 55 && cata_rot.get_angle() < 350) {
-                cata.move(0);   //if button isn't pressed, cata moves until out of angle range
+            outputs.move(cataOutput, 127);
+            if (cataAngle > 55 && cataAngle < 350) {
+                outputs.move(cataOutput, 0);   //if button isn't pressed, cata moves until out of angle range
             }
         }
 
-        //intake spin
-        if(!controller.get_digital(pros::E_CONTROLLER_DIGITAL_L1)){
-            intake.move(127 * controller.get_digital(pros::E_CONTROLLER_DIGITAL_L1));
+        //intake spin. L1 intakes until a triball is in, L2 outtakes
+        if(snapshot.pressed(pros::E_CONTROLLER_DIGITAL_L1)){
+            triballIntake.intake();
         }
-        if(!controller.get_digital(pros::E_CONTROLLER_DIGITAL_L2)){
-            intake.move(-127 * controller.get_digital(pros::E_CONTROLLER_DIGITAL_L2));
+        else if(snapshot.pressed(pros::E_CONTROLLER_DIGITAL_L2)){
+            triballIntake.outtake();
+        }
+        else{
+            triballIntake.stop();
         }
-        // delay to save resources
-        pros::delay(10);
+        // write the last command of the tick to each actuator that changed
+        outputs.flush();
+        // the sample was age ms old when the hub read it
+        driverLatency.add(snapshot.age * 1000 + (pros::micros() - snapshot.micros));
+        // log the loop. never blocks, the SD card is written by a low priority task
+        const lemlib::Pose pose = chassis.getPose();
+        driveLogger.log(DriveRecord {pros::millis(), pose.x, pose.y, pose.theta, static_cast<int16_t>(leftY),
+                                     static_cast<int16_t>(rightX)});
+        TRACE_END("opcontrol loop");
     }
 }
\ No newline at end of file
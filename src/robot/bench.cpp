@@ -0,0 +1,174 @@
+#include "robot/bench.hpp"
+
+#ifdef ROBOT_BENCH
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include "pros/rtos.hpp"
+#include "lemlib/api.hpp"
+#include "lemlib/chassis/odom.hpp"
+#include "okapi/api/filter/averageFilter.hpp"
+#include "okapi/api/filter/emaFilter.hpp"
+#include "okapi/api/filter/medianFilter.hpp"
+#include "okapi/api/odometry/odomMath.hpp"
+#ifdef __arm__
+#include "okapi/squiggles/squiggles.hpp"
+#endif
+#include "robot/dashboard.hpp"
+#include "robot/fastMath.hpp"
+#include "robot/odom.hpp"
+#include "robot/path.hpp"
+
+ASSET(pathUnderHang_txt);
+
+namespace robot {
+namespace bench {
+static constexpr int MAX_RESULTS = 32;
+static Result results[MAX_RESULTS];
+static int resultCount = 0;
+static Clock* timer = nullptr;
+
+/**
+ * @brief Time a piece of code
+ *
+ * The code is run once before timing starts so caches and lazily initialized state are warm
+ *
+ * @param name name of the benchmark
+ * @param iterations number of times to run the code
+ * @param body the code to time
+ */
+template <typename F> static void measure(const char* name, uint32_t iterations, F&& body) {
+    body();
+    const uint64_t start = timer->micros();
+    for (uint32_t i = 0; i < iterations; i++) body();
+    const uint64_t elapsed = timer->micros() - start;
+    if (resultCount < MAX_RESULTS) results[resultCount++] = {name, iterations, elapsed * 1000.0f / iterations};
+}
+
+static void printJson() {
+    printf("{\"context\":{\"library\":\"robot::bench\",\"time_ms\":%lu},\"benchmarks\":[",
+           static_cast<unsigned long>(pros::millis()));
+    for (int i = 0; i < resultCount; i++) {
+        printf("%s{\"name\":\"%s\",\"iterations\":%lu,\"real_time\":%.1f,\"cpu_time\":%.1f,\"time_unit\":\"ns\"}",
+               i > 0 ? "," : "", results[i].name, static_cast<unsigned long>(results[i].iterations),
+               results[i].nanoseconds, results[i].nanoseconds);
+    }
+    printf("]}\n");
+}
+
+void runAll(const lemlib::OdomSensors& sensors, const lemlib::Drivetrain& drivetrain, Clock& clock) {
+    // run above the other user tasks so they don't get counted in the results
+    pros::Task self = pros::Task::current();
+    const uint32_t priority = self.get_priority();
+    self.set_priority(TASK_PRIORITY_MAX - 1);
+    resultCount = 0;
+    timer = &clock;
+
+    // inputs are read through a volatile so they can't be constant folded
+    volatile float input = 12.34f;
+    lemlib::Pose a(1.5, -2.25, 0.3);
+    lemlib::Pose b(input, 7.5, 1.2);
+
+    measure("Pose::operator+", 10000, [&]() { doNotOptimize(a + b); });
+    measure("Pose::operator*(float)", 10000, [&]() { doNotOptimize(a * static_cast<float>(input)); });
+    measure("Pose::distance", 10000, [&]() { doNotOptimize(a.distance(b)); });
+    measure("Pose::angle", 10000, [&]() { doNotOptimize(a.angle(b)); });
+    measure("Pose::rotate", 10000, [&]() { doNotOptimize(a.rotate(input)); });
+    measure("Pose::lerp", 10000, [&]() { doNotOptimize(a.lerp(b, 0.5)); });
+    measure("angleError", 10000, [&]() { doNotOptimize(lemlib::angleError(input, 350)); });
+    measure("getCurvature", 10000, [&]() { doNotOptimize(lemlib::getCurvature(a, b)); });
+    measure("defaultDriveCurve", 10000, [&]() { doNotOptimize(lemlib::defaultDriveCurve(input, 3)); });
+
+    // trigonometry. libm works in double precision on a soft float ABI, the approximations in float
+    float sine, cosine;
+    measure("std::sin + std::cos", 10000, [&]() {
+        doNotOptimize(std::sin(static_cast<float>(input)));
+        doNotOptimize(std::cos(static_cast<float>(input)));
+    });
+    measure("fastmath::approxSinCos", 10000, [&]() {
+        fastmath::approxSinCos(input, sine, cosine);
+        doNotOptimize(sine);
+        doNotOptimize(cosine);
+    });
+    measure("std::atan2", 10000, [&]() { doNotOptimize(std::atan2(static_cast<float>(input), -3.5f)); });
+    measure("fastmath::approxAtan2", 10000, [&]() { doNotOptimize(fastmath::approxAtan2(input, -3.5f)); });
+    // largest difference from libm over a sweep, to check the approximations build the same on the brain
+    float sinCosError = 0;
+    float atan2Error = 0;
+    for (int i = -20000; i <= 20000; i++) {
+        const float angle = i * 0.001f;
+        fastmath::approxSinCos(angle, sine, cosine);
+        sinCosError = std::max({sinCosError, std::fabs(sine - std::sin(angle)), std::fabs(cosine - std::cos(angle))});
+        atan2Error = std::max(atan2Error, std::fabs(fastmath::approxAtan2(std::sin(angle), std::cos(angle)) -
+                                                    std::atan2(std::sin(angle), std::cos(angle))));
+    }
+    printf("fastmath max error: sin/cos %g, atan2 %g rad\n", sinCosError, atan2Error);
+
+    // odometry, including the sensor reads it does
+    lemlib::setSensors(withDrivetrainWheels(sensors, drivetrain), drivetrain);
+    measure("lemlib::update", 1000, []() { lemlib::update(); });
+
+    // pure pursuit lookahead search over a real path
+    static PathPoint points[256];
+    const int count = parsePath(pathUnderHang_txt, points, 256);
+    const lemlib::Pose robotPose(20, -30, 0);
+    measure("parsePath", 100, [&]() { doNotOptimize(parsePath(pathUnderHang_txt, points, 256)); });
+    measure("closestPoint", 1000, [&]() { doNotOptimize(closestPoint(points, count, robotPose)); });
+    measure("lookaheadPoint", 1000, [&]() { doNotOptimize(lookaheadPoint(points, count, robotPose, 0, 15)); });
+
+    // okapi
+    okapi::EmaFilter ema(0.2);
+    okapi::MedianFilter<5> median;
+    okapi::AverageFilter<5> average;
+    measure("okapi::EmaFilter", 10000, [&]() { doNotOptimize(ema.filter(input)); });
+    measure("okapi::MedianFilter<5>", 10000, [&]() { doNotOptimize(median.filter(input)); });
+    measure("okapi::AverageFilter<5>", 10000, [&]() { doNotOptimize(average.filter(input)); });
+    using namespace okapi::literals;
+    const okapi::OdomState state {1_ft, 2_ft, 30_deg};
+    const okapi::Point target {input * 1_in, 3_ft};
+    measure("OdomMath::computeDistanceToPoint", 10000,
+            [&]() { doNotOptimize(okapi::OdomMath::computeDistanceToPoint(target, state)); });
+    measure("OdomMath::computeAngleToPoint", 10000,
+            [&]() { doNotOptimize(okapi::OdomMath::computeAngleToPoint(target, state)); });
+#ifdef __arm__
+    // squiggles only exists in okapi's ARM library, so the host build leaves it out
+    squiggles::SplineGenerator generator(squiggles::Constraints(1.0, 2.0, 10.0),
+                                         std::make_shared<squiggles::TankModel>(0.3, squiggles::Constraints(1.0)));
+    measure("squiggles::SplineGenerator::generate", 5,
+            [&]() { doNotOptimize(generator.generate({squiggles::Pose(0, 0, 0), squiggles::Pose(1, 1, 1.57)})); });
+#endif
+
+    // logger formatting
+    char buffer[32];
+    measure("fmt::format(Pose)", 1000, [&]() { doNotOptimize(fmt::format("{}", a)); });
+    measure("fmt::format({:.2f})", 1000, [&]() { doNotOptimize(fmt::format("{:.2f}", static_cast<float>(input))); });
+    measure("snprintf(%f)", 1000, [&]() { doNotOptimize(snprintf(buffer, sizeof(buffer), "%f", input)); });
+    measure("formatFixed", 1000, [&]() { doNotOptimize(formatFixed(buffer, sizeof(buffer), input, 2)); });
+
+    // motion startup. LemLib's async motions create a task per motion, the motion worker notifies one it already has.
+    // both tasks run above this one, so each iteration includes the switch to the task and back
+    static volatile bool ran = false;
+    measure("motion startup: create task", 20, []() {
+        pros::Task task([]() { ran = true; }, TASK_PRIORITY_MAX, TASK_STACK_DEPTH_DEFAULT, "bench motion");
+        doNotOptimize(ran);
+    });
+    pros::Task worker(
+        []() {
+            while (true) {
+                pros::Task::notify_take(true, TIMEOUT_MAX);
+                ran = true;
+            }
+        },
+        TASK_PRIORITY_MAX, TASK_STACK_DEPTH_DEFAULT, "bench worker");
+    measure("motion startup: notify worker", 1000, [&]() {
+        worker.notify();
+        doNotOptimize(ran);
+    });
+    worker.remove();
+
+    self.set_priority(priority);
+    printJson();
+}
+} // namespace bench
+} // namespace robot
+#endif
@@ -0,0 +1,161 @@
+#include <cctype>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include "lemlib/logger/logger.hpp"
+#include "robot/config.hpp"
+#include "robot/tasks.hpp"
+
+namespace robot {
+ConfigStore::ConfigStore(const char* path) : path(path) {}
+
+int ConfigStore::add(const char* name, float value, float min, float max) {
+    if (paramCount >= ConfigSet::MAX_PARAMS || std::strlen(name) >= NAME_LENGTH) return -1;
+    Param& param = params[paramCount];
+    std::strcpy(param.name, name);
+    param.min = min;
+    param.max = max;
+    // parameters are added before anything reads them
+    sets.getLatest().values[paramCount] = value;
+    return paramCount++;
+}
+
+void ConfigStore::onChange(std::function<void(const ConfigSet&)> callback) { this->callback = std::move(callback); }
+
+int ConfigStore::find(const char* name, int length) {
+    for (int i = 0; i < paramCount; i++) {
+        if (std::strncmp(params[i].name, name, length) == 0 && params[i].name[length] == '\0') return i;
+    }
+    return -1;
+}
+
+bool ConfigStore::parseLine(const char* line, int number, ConfigSet& set) {
+    while (std::isspace(static_cast<unsigned char>(*line))) line++;
+    if (*line == '\0' || *line == '#') return true;
+    const char* end = line;
+    while (*end != '\0' && *end != '=' && !std::isspace(static_cast<unsigned char>(*end))) end++;
+    const int param = find(line, end - line);
+    if (param < 0) {
+        lemlib::infoSink()->warn("config line {}: unknown parameter {}", number, std::string(line, end));
+        return false;
+    }
+    while (std::isspace(static_cast<unsigned char>(*end)) || *end == '=') end++;
+    char* rest;
+    const float value = std::strtof(end, &rest);
+    while (std::isspace(static_cast<unsigned char>(*rest))) rest++;
+    if (rest == end || (*rest != '\0' && *rest != '#') || !std::isfinite(value)) {
+        lemlib::infoSink()->warn("config line {}: {} is not a number", number, params[param].name);
+        return false;
+    }
+    if (value < params[param].min || value > params[param].max) {
+        lemlib::infoSink()->warn("config line {}: {} = {} is outside {} to {}", number, params[param].name, value,
+                                 params[param].min, params[param].max);
+        return false;
+    }
+    set.values[param] = value;
+    return true;
+}
+
+void ConfigStore::publish(const ConfigSet& set) {
+    uint32_t sequence;
+    ConfigSet& buffer = sets.beginWrite(sequence);
+    buffer = set;
+    buffer.version = sequence;
+    // publish the set only once it is complete
+    sets.publish();
+    if (callback) callback(buffer);
+}
+
+bool ConfigStore::load() {
+    FILE* file = std::fopen(path, "r");
+    if (file == nullptr) {
+        lemlib::infoSink()->warn("config: could not read {}", path);
+        return false;
+    }
+    writerMutex.take();
+    // check the whole file against a copy, so a bad line leaves every parameter as it was
+    ConfigSet set = sets.getLatest();
+    char line[LINE_LENGTH];
+    bool valid = true;
+    int number = 0;
+    int count = 0;
+    while (std::fgets(line, sizeof(line), file) != nullptr) {
+        number++;
+        line[std::strcspn(line, "\r\n")] = '\0';
+        valid = parseLine(line, number, set) && valid;
+        count++;
+    }
+    std::fclose(file);
+    if (valid) publish(set);
+    const uint32_t version = sets.getSequence();
+    writerMutex.give();
+    if (valid) lemlib::infoSink()->debug("config: loaded {} lines from {}, version {}", count, path, version);
+    else lemlib::infoSink()->warn("config: {} rejected, parameters unchanged", path);
+    return valid;
+}
+
+bool ConfigStore::save() {
+    const ConfigSet set = getSet();
+    FILE* file = std::fopen(path, "w");
+    if (file == nullptr) return false;
+    bool written = true;
+    for (int i = 0; i < paramCount; i++) {
+        written = written && std::fprintf(file, "%s = %g\n", params[i].name, set.values[i]) > 0;
+    }
+    std::fclose(file);
+    return written;
+}
+
+bool ConfigStore::command(const char* line) {
+    while (std::isspace(static_cast<unsigned char>(*line))) line++;
+    if (std::strncmp(line, "reload", 6) == 0) return load();
+    if (std::strncmp(line, "save", 4) == 0) {
+        const bool saved = save();
+        lemlib::infoSink()->debug("config: {} {}", saved ? "saved to" : "could not write", path);
+        return saved;
+    }
+    if (std::strncmp(line, "get", 3) == 0) {
+        const ConfigSet set = getSet();
+        for (int i = 0; i < paramCount; i++) lemlib::infoSink()->debug("config: {} = {}", params[i].name, set[i]);
+        return true;
+    }
+    if (std::strncmp(line, "set ", 4) == 0) {
+        writerMutex.take();
+        ConfigSet set = sets.getLatest();
+        const bool valid = parseLine(line + 4, 1, set);
+        if (valid) publish(set);
+        const uint32_t version = sets.getSequence();
+        writerMutex.give();
+        if (valid) lemlib::infoSink()->debug("config: {}, version {}", line + 4, version);
+        return valid;
+    }
+    lemlib::infoSink()->warn("config: unknown command {}", line);
+    return false;
+}
+
+void ConfigStore::start() {
+    if (task != nullptr) return;
+    task = tasks::create("config", [this]() {
+        char line[LINE_LENGTH];
+        while (true) {
+            // blocks until a whole line arrives over serial
+            if (std::fgets(line, sizeof(line), stdin) == nullptr) {
+                pros::delay(tasks::getPeriod("config"));
+                continue;
+            }
+            line[std::strcspn(line, "\r\n")] = '\0';
+            if (line[0] != '\0') command(line);
+        }
+    });
+}
+
+float ConfigStore::get(int param) {
+    if (param < 0 || param >= paramCount) return 0;
+    // a single value is read in one access, so it needs no retry
+    return sets.getLatest().values[param];
+}
+
+ConfigSet ConfigStore::getSet() { return sets.get(); }
+} // namespace robot
@@ -0,0 +1,73 @@
+#include <algorithm>
+#include "lemlib/logger/logger.hpp"
+#include "robot/controllerExecutor.hpp"
+#include "robot/tasks.hpp"
+#include "robot/trace.hpp"
+
+namespace robot {
+ControllerExecutor::ControllerExecutor(Clock& clock) : clock(clock) {}
+
+int ControllerExecutor::add(const char* name, okapi::IterativeController<double, double>* controller,
+                            okapi::ControllerInput<double>* input, okapi::ControllerOutput<double>* output) {
+    if (entryCount >= MAX_CONTROLLERS) return -1;
+    entries[entryCount] = {name, controller, input, output, 0, 0, 0, 0, 0};
+    return entryCount++;
+}
+
+void ControllerExecutor::start() {
+    if (task != nullptr) return;
+    const uint64_t now = clock.micros();
+    for (int i = 0; i < entryCount; i++) entries[i].due = now;
+    task = tasks::create("controllers", [this]() {
+        while (true) pros::delay(update());
+    });
+}
+
+uint32_t ControllerExecutor::update() {
+    TRACE_SCOPE("ControllerExecutor::update");
+    const uint64_t now = clock.micros();
+    uint64_t wait = UINT64_MAX;
+    // in the order the controllers were added, so controllers due together always step in the same order
+    for (int i = 0; i < entryCount; i++) {
+        Entry& entry = entries[i];
+        // okapi has no microsecond unit
+        const uint64_t sampleTime =
+            std::max<uint64_t>(1000, entry.controller->getSampleTime().convert(okapi::millisecond) * 1000);
+        if (now >= entry.due) {
+            if (!entry.controller->isDisabled()) {
+                const uint64_t start = clock.micros();
+                entry.output->controllerSet(entry.controller->step(entry.input->controllerGet()));
+                const uint32_t micros = clock.micros() - start;
+                entry.steps++;
+                entry.totalMicros += micros;
+                entry.maxMicros = std::max(entry.maxMicros, micros);
+            }
+            // keep to the original schedule unless a whole sample was missed, then start again from now
+            if (now - entry.due >= sampleTime) {
+                entry.late++;
+                entry.due = now + sampleTime;
+            } else {
+                entry.due += sampleTime;
+            }
+        }
+        wait = std::min(wait, entry.due - now);
+    }
+    // the task sleeps in whole milliseconds. Rounding up never wakes it before a step is due
+    return entryCount > 0 ? (wait + 999) / 1000 : 10;
+}
+
+ControllerTiming ControllerExecutor::getTiming(int controller) {
+    if (controller < 0 || controller >= entryCount) return {0, 0, 0, 0};
+    const Entry& entry = entries[controller];
+    return {entry.steps, entry.steps > 0 ? static_cast<uint32_t>(entry.totalMicros / entry.steps) : 0,
+            entry.maxMicros, entry.late};
+}
+
+void ControllerExecutor::report() {
+    for (int i = 0; i < entryCount; i++) {
+        const ControllerTiming timing = getTiming(i);
+        lemlib::infoSink()->debug("controller {}: {} steps, avg {} us max {} us, {} late", entries[i].name, timing.steps,
+                                  timing.averageMicros, timing.maxMicros, timing.late);
+    }
+}
+} // namespace robot
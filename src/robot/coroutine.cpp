@@ -0,0 +1,113 @@
+#include "robot/coroutine.hpp"
+
+#ifdef __cpp_impl_coroutine
+#include <algorithm>
+#include <atomic>
+#include "lemlib/logger/logger.hpp"
+#include "robot/trace.hpp"
+
+namespace {
+// fixed size frame slots. A slot is taken by setting its flag, so frames can be allocated from any task
+alignas(std::max_align_t) unsigned char arena[robot::COROUTINE_FRAMES][robot::COROUTINE_FRAME_SIZE];
+std::atomic<bool> taken[robot::COROUTINE_FRAMES] = {};
+std::atomic<int> used {0};
+std::atomic<int> peak {0};
+std::atomic<std::size_t> largestFrame {0};
+std::atomic<uint32_t> failures {0};
+
+// executor running in a task, and that task. Waits awaited in any other task block instead
+robot::CoroutineExecutor* current = nullptr;
+pros::task_t currentTask = nullptr;
+} // namespace
+
+namespace robot {
+void* Routine::promise_type::operator new(std::size_t size) noexcept {
+    std::size_t largest = largestFrame;
+    while (size > largest && !largestFrame.compare_exchange_weak(largest, size)) {}
+    if (size <= COROUTINE_FRAME_SIZE) {
+        for (int i = 0; i < COROUTINE_FRAMES; i++) {
+            if (taken[i].exchange(true)) continue;
+            const int count = ++used;
+            int highest = peak;
+            while (count > highest && !peak.compare_exchange_weak(highest, count)) {}
+            return arena[i];
+        }
+    }
+    failures++;
+    lemlib::infoSink()->warn("coroutine frame of {} bytes not allocated, {} of {} slots in use", size, used.load(),
+                             COROUTINE_FRAMES);
+    return nullptr;
+}
+
+void Routine::promise_type::operator delete(void* frame) noexcept {
+    const int slot = (static_cast<unsigned char*>(frame) - arena[0]) / COROUTINE_FRAME_SIZE;
+    used--;
+    taken[slot] = false;
+}
+
+bool CoroutineWait::await_suspend(std::coroutine_handle<> handle) {
+    if (current == nullptr || currentTask != pros::c::task_get_current() || current->running < 0) {
+        // not inside an executor, so nothing else would resume the routine. Wait here instead
+        while (!ready()) pros::delay(CoroutineExecutor::PERIOD);
+        return false;
+    }
+    CoroutineExecutor::Slot& slot = current->slots[current->running];
+    slot.resume = handle;
+    slot.wait = this;
+    return true;
+}
+
+bool CoroutineExecutor::spawn(Routine&& routine) {
+    if (!routine.handle) return false;
+    for (Slot& slot : slots) {
+        if (slot.root) continue;
+        slot.root = std::exchange(routine.handle, nullptr);
+        slot.resume = slot.root;
+        slot.wait = nullptr;
+        return true;
+    }
+    lemlib::infoSink()->warn("coroutine not spawned, {} routines already running", MAX_ROUTINES);
+    return false;
+}
+
+void CoroutineExecutor::run() {
+    CoroutineExecutor* const outer = current;
+    const pros::task_t outerTask = currentTask;
+    current = this;
+    currentTask = pros::c::task_get_current();
+    uint32_t now = pros::millis();
+    while (true) {
+        TRACE_BEGIN("CoroutineExecutor::run");
+        bool alive = false;
+        // in spawn order, so routines run the same way every time. A routine spawned into a later slot runs this pass
+        for (int i = 0; i < MAX_ROUTINES; i++) {
+            Slot& slot = slots[i];
+            if (!slot.root) continue;
+            if (slot.wait == nullptr || slot.wait->ready()) {
+                slot.wait = nullptr;
+                running = i;
+                slot.resume.resume();
+                running = -1;
+                if (slot.root.done()) {
+                    slot.root.destroy();
+                    slot = {};
+                    continue;
+                }
+            }
+            alive = true;
+        }
+        TRACE_END("CoroutineExecutor::run");
+        if (!alive) break;
+        pros::c::task_delay_until(&now, PERIOD);
+    }
+    current = outer;
+    currentTask = outerTask;
+}
+
+int CoroutineExecutor::getCount() {
+    return std::count_if(slots, slots + MAX_ROUTINES, [](const Slot& slot) { return static_cast<bool>(slot.root); });
+}
+
+ArenaStats CoroutineExecutor::getArenaStats() { return {used, peak, largestFrame, failures}; }
+} // namespace robot
+#endif
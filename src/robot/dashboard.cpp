@@ -0,0 +1,110 @@
+#include <climits>
+#include <cstring>
+#include "pros/rtos.hpp"
+#include "robot/dashboard.hpp"
+#include "robot/trace.hpp"
+
+namespace robot {
+static constexpr int32_t SCALES[] = {1, 10, 100, 1000, 10000};
+
+int32_t quantize(float value, int precision) {
+    if (precision < 0) precision = 0;
+    if (precision > 4) precision = 4;
+    float scaled = value * SCALES[precision];
+    // clamp before converting, float to int conversion of out of range values is undefined
+    if (scaled >= 2147483520.0f) return INT32_MAX;
+    if (scaled <= -2147483520.0f) return -INT32_MAX;
+    return static_cast<int32_t>(scaled < 0 ? scaled - 0.5f : scaled + 0.5f);
+}
+
+/**
+ * @brief Write an already quantized value as a fixed point number
+ *
+ * @return int - the number of characters written
+ */
+static int writeQuantized(char* buffer, int size, int32_t quantized, int precision) {
+    if (size <= 0) return 0;
+    // digits are generated backwards into a scratch buffer. 10 digits, a sign and a decimal point at most
+    char scratch[12];
+    int length = 0;
+    uint32_t magnitude = quantized < 0 ? -static_cast<uint32_t>(quantized) : quantized;
+    do {
+        if (length == precision && precision > 0) scratch[length++] = '.';
+        scratch[length++] = '0' + magnitude % 10;
+        magnitude /= 10;
+    } while (magnitude > 0 || length <= precision);
+    if (quantized < 0) scratch[length++] = '-';
+    // reverse into the output
+    int written = 0;
+    while (length > 0 && written < size - 1) buffer[written++] = scratch[--length];
+    buffer[written] = '\0';
+    return written;
+}
+
+int formatFixed(char* buffer, int size, float value, int precision) {
+    if (precision < 0) precision = 0;
+    if (precision > 4) precision = 4;
+    return writeQuantized(buffer, size, quantize(value, precision), precision);
+}
+
+int Dashboard::addField(const char* name, int precision) {
+    if (fieldCount >= MAX_FIELDS) return -1;
+    Field& field = fields[fieldCount];
+    field.name = name;
+    field.precision = precision < 0 ? 0 : (precision > 4 ? 4 : precision);
+    // the name never changes, so it is written to the text once
+    int length = std::strlen(name);
+    if (length > TEXT_SIZE - 16) length = TEXT_SIZE - 16;
+    std::memcpy(field.text, name, length);
+    field.text[length++] = ':';
+    field.text[length++] = ' ';
+    field.text[length] = '\0';
+    field.prefixLength = length;
+    return fieldCount++;
+}
+
+void Dashboard::init(lv_obj_t* parent) {
+    if (parent == nullptr) parent = lv_scr_act();
+    for (int i = 0; i < fieldCount; i++) {
+        Field& field = fields[i];
+        field.label = lv_label_create(parent, nullptr);
+        lv_obj_set_pos(field.label, 10, 10 + i * 20);
+        field.dirty = true;
+    }
+}
+
+void Dashboard::set(int field, float value) {
+    if (field < 0 || field >= fieldCount) return;
+    fields[field].value = value;
+    fields[field].pending = quantize(value, fields[field].precision);
+}
+
+int Dashboard::update() {
+    TRACE_SCOPE("Dashboard::update");
+    const uint64_t start = pros::micros();
+    int redrawn = 0;
+    for (int i = 0; i < fieldCount; i++) {
+        Field& field = fields[i];
+        if (field.label == nullptr) continue;
+        if (!field.dirty && field.pending == field.drawn) continue;
+        writeQuantized(field.text + field.prefixLength, TEXT_SIZE - field.prefixLength, field.pending,
+                       field.precision);
+        // the text buffer is owned by the field, so LVGL doesn't need to copy it
+        lv_label_set_static_text(field.label, field.text);
+        field.drawn = field.pending;
+        field.dirty = false;
+        redrawn++;
+    }
+    const uint32_t elapsed = pros::micros() - start;
+    TRACE_COUNTER("dashboard label writes", redrawn);
+    stats.updates++;
+    stats.labelWrites += redrawn;
+    stats.totalMicros += elapsed;
+    if (elapsed > stats.maxMicros) stats.maxMicros = elapsed;
+    return redrawn;
+}
+
+DashboardStats Dashboard::getStats() const { return stats; }
+
+void Dashboard::resetStats() { stats = DashboardStats(); }
+} // namespace robot
@@ -0,0 +1,154 @@
+#include <cmath>
+#include "lemlib/util.hpp"
+#include "robot/fastMath.hpp"
+#include "robot/fieldMap.hpp"
+#include "robot/trace.hpp"
+
+namespace robot {
+// diameter of the robot and lookahead markers, in pixels
+static constexpr lv_coord_t ROBOT_SIZE = 18;
+static constexpr lv_coord_t LOOKAHEAD_SIZE = 6;
+
+static lv_style_t fieldStyle;
+static lv_style_t pathStyle;
+static lv_style_t robotStyle;
+static lv_style_t headingStyle;
+static lv_style_t lookaheadStyle;
+
+void FieldMap::init(lv_coord_t x, lv_coord_t y, lv_coord_t size, lv_obj_t* parent) {
+    if (parent == nullptr) parent = lv_scr_act();
+    this->size = size;
+    scale = size / FIELD_SIZE;
+
+    lv_style_copy(&fieldStyle, &lv_style_plain);
+    fieldStyle.body.main_color = LV_COLOR_MAKE(0x30, 0x30, 0x30);
+    fieldStyle.body.grad_color = fieldStyle.body.main_color;
+    fieldStyle.body.border.color = LV_COLOR_MAKE(0x80, 0x80, 0x80);
+    fieldStyle.body.border.width = 1;
+    lv_style_copy(&pathStyle, &lv_style_plain);
+    pathStyle.line.color = LV_COLOR_MAKE(0x00, 0xc0, 0x40);
+    pathStyle.line.width = 2;
+    lv_style_copy(&robotStyle, &lv_style_plain);
+    robotStyle.body.main_color = LV_COLOR_MAKE(0x20, 0x60, 0xff);
+    robotStyle.body.grad_color = robotStyle.body.main_color;
+    robotStyle.body.radius = LV_RADIUS_CIRCLE;
+    lv_style_copy(&headingStyle, &lv_style_plain);
+    headingStyle.line.color = LV_COLOR_WHITE;
+    headingStyle.line.width = 2;
+    lv_style_copy(&lookaheadStyle, &robotStyle);
+    lookaheadStyle.body.main_color = LV_COLOR_MAKE(0xff, 0x30, 0x30);
+    lookaheadStyle.body.grad_color = lookaheadStyle.body.main_color;
+
+    field = lv_obj_create(parent, nullptr);
+    lv_obj_set_style(field, &fieldStyle);
+    lv_obj_set_pos(field, x, y);
+    lv_obj_set_size(field, size, size);
+
+    pathLine = lv_line_create(field, nullptr);
+    lv_line_set_style(pathLine, &pathStyle);
+    lv_obj_set_hidden(pathLine, true);
+
+    lookahead = lv_obj_create(field, nullptr);
+    lv_obj_set_style(lookahead, &lookaheadStyle);
+    lv_obj_set_size(lookahead, LOOKAHEAD_SIZE, LOOKAHEAD_SIZE);
+    lv_obj_set_hidden(lookahead, true);
+
+    robot = lv_obj_create(field, nullptr);
+    lv_obj_set_style(robot, &robotStyle);
+    lv_obj_set_size(robot, ROBOT_SIZE, ROBOT_SIZE);
+    // the heading line is a child of the robot so it moves with it
+    heading = lv_line_create(robot, nullptr);
+    lv_line_set_style(heading, &headingStyle);
+    headingPoints[0] = {ROBOT_SIZE / 2, ROBOT_SIZE / 2};
+    headingPoints[1] = {ROBOT_SIZE / 2, 0};
+    lv_line_set_points(heading, headingPoints, 2);
+}
+
+void FieldMap::setPath(const asset& path, float lookahead, std::function<bool()> following) {
+    mutex.take();
+    waypointCount = parsePath(path, waypoints, MAX_WAYPOINTS);
+    closest = 0;
+    lookaheadDist = lookahead;
+    this->following = std::move(following);
+    pathChanged = true;
+    mutex.give();
+}
+
+void FieldMap::clearPath() {
+    mutex.take();
+    waypointCount = 0;
+    following = nullptr;
+    pathChanged = true;
+    mutex.give();
+}
+
+lv_point_t FieldMap::toScreen(float x, float y) const {
+    // the origin is the center of the field, and +y is up on the screen
+    return {static_cast<lv_coord_t>(std::lround(size / 2 + x * scale)),
+            static_cast<lv_coord_t>(std::lround(size / 2 - y * scale))};
+}
+
+void FieldMap::applyPath() {
+    if (waypointCount == 0) {
+        lv_obj_set_hidden(pathLine, true);
+        lv_obj_set_hidden(lookahead, true);
+        drawnLookahead = {-1, -1};
+        return;
+    }
+    // decimate long paths so the line fits in the point buffer. The last waypoint is always drawn
+    const int step = (waypointCount + MAX_PATH_POINTS - 2) / (MAX_PATH_POINTS - 1);
+    int drawn = 0;
+    for (int i = 0; i < waypointCount - 1; i += step) {
+        pathPoints[drawn++] = toScreen(waypoints[i].x, waypoints[i].y);
+    }
+    pathPoints[drawn++] = toScreen(waypoints[waypointCount - 1].x, waypoints[waypointCount - 1].y);
+    lv_line_set_points(pathLine, pathPoints, drawn);
+    lv_obj_set_pos(pathLine, 0, 0);
+    lv_obj_set_hidden(pathLine, false);
+}
+
+void FieldMap::update(lemlib::Pose pose) {
+    if (field == nullptr) return;
+    TRACE_SCOPE("FieldMap::update");
+    mutex.take();
+    // checked under the lock, so a path set since the check can't be cleared along with the old one
+    if (waypointCount > 0 && following && !following()) {
+        waypointCount = 0;
+        following = nullptr;
+        pathChanged = true;
+    }
+    if (pathChanged) {
+        applyPath();
+        pathChanged = false;
+    }
+    // move the lookahead marker
+    if (waypointCount > 0) {
+        closest = closestPoint(waypoints, waypointCount, pose, closest);
+        const lemlib::Pose target = lookaheadPoint(waypoints, waypointCount, pose, closest, lookaheadDist);
+        const lv_point_t point = toScreen(target.x, target.y);
+        if (point.x != drawnLookahead.x || point.y != drawnLookahead.y) {
+            if (drawnLookahead.x < 0) lv_obj_set_hidden(lookahead, false);
+            lv_obj_set_pos(lookahead, point.x - LOOKAHEAD_SIZE / 2, point.y - LOOKAHEAD_SIZE / 2);
+            drawnLookahead = point;
+        }
+    }
+    mutex.give();
+
+    // only touch LVGL objects if they moved by at least a pixel, otherwise nothing gets invalidated
+    const lv_point_t point = toScreen(pose.x, pose.y);
+    if (point.x != drawnRobot.x || point.y != drawnRobot.y) {
+        lv_obj_set_pos(robot, point.x - ROBOT_SIZE / 2, point.y - ROBOT_SIZE / 2);
+        drawnRobot = point;
+    }
+    // LemLib headings are clockwise from +y
+    float sine, cosine;
+    fastmath::sinCos(lemlib::degToRad(pose.theta), sine, cosine);
+    const lv_point_t tip = {static_cast<lv_coord_t>(std::lround(ROBOT_SIZE / 2 * (1 + sine))),
+                            static_cast<lv_coord_t>(std::lround(ROBOT_SIZE / 2 * (1 - cosine)))};
+    if (tip.x != drawnHeading.x || tip.y != drawnHeading.y) {
+        headingPoints[1] = tip;
+        lv_line_set_points(heading, headingPoints, 2);
+        drawnHeading = tip;
+    }
+}
+} // namespace robot
@@ -0,0 +1,188 @@
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include "pros/error.h"
+#include "pros/misc.hpp"
+#include "robot/imuStartup.hpp"
+#include "robot/tasks.hpp"
+
+namespace robot {
+CorrectedImu::CorrectedImu(uint8_t port) : pros::Imu(port), port(port) {}
+
+double CorrectedImu::getRawRotation() const { return pros::Imu::get_rotation(); }
+
+double CorrectedImu::get_rotation() const {
+    const double raw = pros::Imu::get_rotation();
+    if (raw == PROS_ERR_F) return raw;
+    return raw - getCorrection();
+}
+
+double CorrectedImu::get_heading() const {
+    const double raw = pros::Imu::get_heading();
+    if (raw == PROS_ERR_F) return raw;
+    const double heading = std::fmod(raw - getCorrection(), 360);
+    return heading < 0 ? heading + 360 : heading;
+}
+
+std::int32_t CorrectedImu::reset(bool blocking) const {
+    const std::int32_t result = pros::Imu::reset(blocking);
+    resetCorrection();
+    return result;
+}
+
+std::int32_t CorrectedImu::tare_rotation() const {
+    const std::int32_t result = pros::Imu::tare_rotation();
+    resetCorrection();
+    return result;
+}
+
+std::int32_t CorrectedImu::tare_heading() const {
+    const std::int32_t result = pros::Imu::tare_heading();
+    resetCorrection();
+    return result;
+}
+
+std::int32_t CorrectedImu::set_rotation(const double target) const {
+    const std::int32_t result = pros::Imu::set_rotation(target);
+    resetCorrection();
+    return result;
+}
+
+std::int32_t CorrectedImu::set_heading(const double target) const {
+    const std::int32_t result = pros::Imu::set_heading(target);
+    resetCorrection();
+    return result;
+}
+
+void CorrectedImu::setDrift(float drift) {
+    mutex.take();
+    const uint32_t now = pros::millis();
+    correction += this->drift * (now - since) / 1000.0;
+    since = now;
+    this->drift = drift;
+    mutex.give();
+}
+
+float CorrectedImu::getDrift() const { return drift; }
+
+double CorrectedImu::getCorrection() const {
+    mutex.take();
+    const double total = correction + drift * (pros::millis() - since) / 1000.0;
+    mutex.give();
+    return total;
+}
+
+void CorrectedImu::resetCorrection() const {
+    mutex.take();
+    correction = 0;
+    since = pros::millis();
+    mutex.give();
+}
+
+uint8_t CorrectedImu::getPort() const { return port; }
+
+ImuStartup::ImuStartup(lemlib::Chassis& chassis, CorrectedImu& imu, const lemlib::Drivetrain& drivetrain,
+                       const char* path)
+    : chassis(chassis),
+      imu(imu),
+      drivetrain(drivetrain),
+      path(path) {}
+
+void ImuStartup::start(bool fastStart) {
+    if (task != nullptr) return;
+    task = tasks::create("imu startup", [this, fastStart]() { run(fastStart); });
+}
+
+void ImuStartup::run(bool fastStart) {
+    const bool fast = fastStart && load();
+    if (fast) {
+        // the sensor calibrates itself when it powers on. Wait for that instead of starting another calibration
+        while (imu.is_calibrating()) pros::delay(10);
+        imu.setDrift(drift);
+    }
+    // calibrating the chassis starts odometry, in a task that runs with the control loops
+    tasks::adopt("lemlib odom", [this, fast]() { chassis.calibrate(!fast); });
+    // correct from the moment odometry starts
+    imu.resetCorrection();
+    savedDriftUsed = fast;
+    ready = true;
+
+    // measure the drift over every stretch of WINDOW in which the robot is disabled and stays still. Stopped motors
+    // alone don't mean still: during a match the robot can be pushed, or turned by a mechanism, with its wheels idle
+    bool measuring = false;
+    uint32_t windowStart = 0;
+    double startRotation = 0;
+    uint32_t time = pros::millis();
+    while (true) {
+        pros::Task::delay_until(&time, tasks::getPeriod("imu startup"));
+        const double rotation = imu.getRawRotation();
+        const uint32_t now = pros::millis();
+        if (rotation == PROS_ERR_F || !pros::competition::is_disabled() || !still()) {
+            measuring = false;
+            continue;
+        }
+        if (!measuring) {
+            measuring = true;
+            windowStart = now;
+            startRotation = rotation;
+            continue;
+        }
+        if (now - windowStart < WINDOW) continue;
+        const uint32_t length = now - windowStart;
+        const float rate = (rotation - startRotation) * 1000 / length;
+        windowStart = now;
+        startRotation = rotation;
+        // faster than any real bias, so the robot was moved without its wheels turning
+        if (!(std::fabs(rate) <= MAX_DRIFT)) continue;
+        const float estimate = measured > 0 ? drift + (rate - drift) * SMOOTHING : rate;
+        drift = estimate;
+        measured = measured + length / 1000.0f;
+        unsaved = true;
+        imu.setDrift(estimate);
+    }
+}
+
+bool ImuStartup::still() {
+    for (pros::Motor_Group* group : {drivetrain.leftMotors, drivetrain.rightMotors}) {
+        for (const double velocity : group->get_actual_velocities()) {
+            if (std::fabs(velocity) >= STILL_VELOCITY) return false;
+        }
+    }
+    return true;
+}
+
+bool ImuStartup::isReady() { return ready; }
+
+bool ImuStartup::waitUntilReady(uint32_t timeout) {
+    const uint32_t start = pros::millis();
+    while (!ready && pros::millis() - start < timeout) pros::delay(5);
+    return ready;
+}
+
+bool ImuStartup::usedSavedDrift() { return savedDriftUsed; }
+
+bool ImuStartup::load() {
+    FILE* file = std::fopen(path, "rb");
+    if (file == nullptr) return false;
+    ImuDriftFile saved;
+    const bool valid = std::fread(&saved, sizeof(saved), 1, file) == 1 && std::memcmp(saved.magic, "RIMU", 4) == 0 &&
+                       saved.version == IMU_DRIFT_VERSION && saved.port == imu.getPort() &&
+                       std::fabs(saved.drift) <= MAX_DRIFT && saved.measured > 0;
+    std::fclose(file);
+    if (!valid) return false;
+    drift = saved.drift;
+    measured = saved.measured;
+    return true;
+}
+
+bool ImuStartup::save() {
+    if (!unsaved) return false;
+    FILE* file = std::fopen(path, "wb");
+    if (file == nullptr) return false;
+    ImuDriftFile saved = {{'R', 'I', 'M', 'U'}, IMU_DRIFT_VERSION, imu.getPort(), drift, measured};
+    const bool written = std::fwrite(&saved, sizeof(saved), 1, file) == 1;
+    std::fclose(file);
+    if (written) unsaved = false;
+    return written;
+}
+} // namespace robot
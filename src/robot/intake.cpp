@@ -0,0 +1,99 @@
+#include <cmath>
+#include "pros/error.h"
+#include "robot/intake.hpp"
+#include "robot/tasks.hpp"
+#include "robot/trace.hpp"
+
+namespace robot {
+Intake::Intake(pros::Motor* motor, pros::Optical* sensor, const IntakeSettings& settings, Clock& clock)
+    : motor(motor),
+      sensor(sensor),
+      settings(settings),
+      clock(clock) {}
+
+void Intake::start() {
+    if (task != nullptr) return;
+    if (sensor != nullptr) {
+        // lit by the sensor's own LED so the hue doesn't depend on the field lighting
+        sensor->set_integration_time(INTEGRATION_TIME);
+        sensor->set_led_pwm(100);
+    }
+    task = tasks::create("intake", [this]() {
+        uint32_t now = pros::millis();
+        while (true) {
+            pros::c::task_delay_until(&now, tasks::getPeriod("intake"));
+            update();
+            // the motor reports when the devices last updated. Wake earlier next time to read just after the update
+            uint32_t updated = 0;
+            motor->get_raw_position(&updated);
+            const uint32_t age = pros::millis() - updated;
+            if (age > PHASE_TARGET && age < DEVICE_PERIOD) now -= age - PHASE_TARGET;
+        }
+    });
+}
+
+void Intake::intake() { mode = IntakeMode::INTAKE; }
+
+void Intake::outtake() { mode = IntakeMode::OUTTAKE; }
+
+void Intake::stop() { mode = IntakeMode::STOP; }
+
+IntakeMode Intake::getMode() { return mode; }
+
+bool Intake::isHolding() { return triball; }
+
+void Intake::update() {
+    TRACE_SCOPE("Intake::update");
+    const OpticalSample sample = read();
+    const int32_t power = process(sample);
+    if (written && power == lastPower) return;
+    motor->move(power);
+    lastPower = power;
+    written = true;
+    const uint32_t reaction = clock.micros() - sample.micros;
+    if (reaction > maxReactionMicros) maxReactionMicros = reaction;
+}
+
+OpticalSample Intake::read() {
+    if (sensor == nullptr) return {clock.micros(), 0, 0};
+    OpticalSample sample {clock.micros(), sensor->get_proximity(), sensor->get_hue()};
+    // an unplugged sensor reads as an empty intake, so intaking runs the motor like it would without the sensor
+    if (sample.proximity == PROS_ERR) sample.proximity = 0;
+    if (sample.hue == PROS_ERR_F) sample.hue = 0;
+    return sample;
+}
+
+int32_t Intake::process(const OpticalSample& sample) {
+    if (!present && sample.proximity >= settings.enterProximity) {
+        present = true;
+        enteredAt = sample.micros;
+        entries++;
+        // a range with minHue above maxHue wraps around through 0, for red
+        triball = settings.minHue <= settings.maxHue
+                      ? sample.hue >= settings.minHue && sample.hue <= settings.maxHue
+                      : sample.hue >= settings.minHue || sample.hue <= settings.maxHue;
+    } else if (present && sample.proximity < settings.exitProximity) {
+        present = false;
+        exits++;
+        if (triball) {
+            cycles++;
+            lastCycleTime = (sample.micros - enteredAt) / 1000;
+        } else {
+            rejects++;
+        }
+        triball = false;
+    }
+    switch (mode.load()) {
+        case IntakeMode::STOP: return 0;
+        case IntakeMode::OUTTAKE: return -settings.power;
+        case IntakeMode::INTAKE: break;
+    }
+    // hold a triball, and spit anything else back out until it has left
+    if (!present) return settings.power;
+    return triball ? 0 : -settings.power;
+}
+
+IntakeStats Intake::getStats() {
+    return {entries, exits, cycles, rejects, lastCycleTime, maxReactionMicros};
+}
+} // namespace robot
@@ -0,0 +1,43 @@
+#include "robot/latency.hpp"
+
+#ifdef ROBOT_LATENCY
+#include <algorithm>
+#include <cmath>
+#include "lemlib/logger/logger.hpp"
+
+namespace robot {
+void LatencyHistogram::add(uint32_t micros) {
+    const uint32_t bucket = micros / BUCKET_MICROS;
+    buckets[bucket < BUCKETS ? bucket : BUCKETS - 1]++;
+    count++;
+    if (micros > max) max = micros;
+}
+
+uint32_t LatencyHistogram::percentile(float percent) {
+    if (count == 0) return 0;
+    // number of samples at or below the percentile
+    const uint32_t target = std::max<uint32_t>(1, std::ceil(count * percent / 100));
+    uint32_t seen = 0;
+    for (int i = 0; i < BUCKETS; i++) {
+        seen += buckets[i];
+        if (seen >= target) return (i + 1) * BUCKET_MICROS;
+    }
+    return BUCKETS * BUCKET_MICROS;
+}
+
+uint32_t LatencyHistogram::getCount() { return count; }
+
+uint32_t LatencyHistogram::getMax() { return max; }
+
+void LatencyHistogram::report(const char* name) {
+    lemlib::infoSink()->debug("{} latency: {} samples, p50 {} us, p90 {} us, p99 {} us, max {} us", name, count,
+                              percentile(50), percentile(90), percentile(99), max);
+}
+
+void LatencyHistogram::reset() {
+    for (uint32_t& bucket : buckets) bucket = 0;
+    count = 0;
+    max = 0;
+}
+} // namespace robot
+#endif
@@ -0,0 +1,607 @@
+#include <algorithm>
+#include <cmath>
+#include "lemlib/chassis/odom.hpp"
+#include "lemlib/logger/logger.hpp"
+#include "lemlib/util.hpp"
+#include "robot/fastMath.hpp"
+#include "robot/motionWorker.hpp"
+#include "robot/pid.hpp"
+#include "robot/tasks.hpp"
+#include "robot/trace.hpp"
+#include "robot/triballTracker.hpp"
+
+namespace {
+// time between stall checks, in microseconds
+constexpr uint64_t STALL_PERIOD = 10000;
+// LemLib's kD multiplies the change in error over one 10ms iteration, and robot::Pid's the change per second
+constexpr float LEMLIB_PERIOD = 0.01;
+
+robot::Pid controller(const lemlib::ControllerSettings& settings, robot::Clock& clock) {
+    return robot::Pid(settings.kP, 0, settings.kD * LEMLIB_PERIOD, 0, false, clock);
+}
+
+/**
+ * Give a controller made by controller() new gains, keeping its state
+ */
+void setGains(robot::Pid& pid, const lemlib::ControllerSettings& settings) {
+    pid.setGains(settings.kP, 0, settings.kD * LEMLIB_PERIOD);
+}
+
+/**
+ * LemLib's exit conditions: a motion has settled once its error stays within the small range for the small timeout,
+ * or within the large range for the large timeout
+ */
+class Settle {
+    public:
+        explicit Settle(const lemlib::ControllerSettings& settings) : settings(settings) {}
+
+        bool update(float error, uint64_t now) {
+            // both are updated every time, so neither misses the moment the error entered its range
+            const bool small = within(error, settings.smallError, settings.smallErrorTimeout, smallSince, now);
+            const bool large = within(error, settings.largeError, settings.largeErrorTimeout, largeSince, now);
+            return small || large;
+        }
+    private:
+        static bool within(float error, float range, float timeout, uint64_t& since, uint64_t now) {
+            if (!(std::fabs(error) < range)) {
+                since = UINT64_MAX;
+                return false;
+            }
+            if (since == UINT64_MAX) since = now;
+            // the timeouts are in milliseconds
+            return now - since >= timeout * 1000;
+        }
+
+        const lemlib::ControllerSettings& settings;
+        // time the error entered each range in microseconds, UINT64_MAX while it is outside
+        uint64_t smallSince = UINT64_MAX;
+        uint64_t largeSince = UINT64_MAX;
+};
+
+/**
+ * Signed curvature of the arc that leaves a pose along its heading and passes through a point, positive to the
+ * right. The pose's theta is a compass heading in radians
+ */
+float arcCurvature(const lemlib::Pose& pose, float x, float y) {
+    const float dx = x - pose.x;
+    const float dy = y - pose.y;
+    const float squared = dx * dx + dy * dy;
+    if (squared == 0) return 0;
+    // distance of the point to the right of the line along the heading
+    float sine, cosine;
+    robot::fastmath::sinCos(pose.theta, sine, cosine);
+    const float side = dx * cosine - dy * sine;
+    return 2 * side / squared;
+}
+
+/**
+ * Compass heading from a pose to a point, in radians
+ */
+float headingTo(const lemlib::Pose& pose, float x, float y) { return robot::fastmath::atan2(x - pose.x, y - pose.y); }
+
+/**
+ * LemLib's pose in radians, turned around when driving backwards so the back of the robot is its front
+ */
+lemlib::Pose facing(bool forwards) {
+    lemlib::Pose pose = lemlib::getPose(true);
+    if (!forwards) pose.theta += M_PI;
+    return pose;
+}
+
+const char* typeName(int type) {
+    static const char* const names[] = {"turnTo", "moveToPose", "moveToPoint", "follow"};
+    return names[type];
+}
+
+const char* endName(robot::MotionEnd reason) {
+    switch (reason) {
+        case robot::MotionEnd::SETTLED: return "settled";
+        case robot::MotionEnd::TIMEOUT: return "timeout";
+        case robot::MotionEnd::CANCELLED: return "cancelled";
+        case robot::MotionEnd::STALLED: return "stalled";
+    }
+    return "";
+}
+} // namespace
+
+namespace robot {
+MotionWorker::MotionWorker(const lemlib::Drivetrain& drivetrain, const lemlib::ControllerSettings& linear,
+                           const lemlib::ControllerSettings& angular, Clock& clock)
+    : drivetrain(drivetrain),
+      clock(clock),
+      nextLinear(linear),
+      nextAngular(angular),
+      nextTrackWidth(drivetrain.trackWidth),
+      linearSettings(linear),
+      angularSettings(angular),
+      trackWidth(drivetrain.trackWidth) {}
+
+void MotionWorker::start() {
+    mutex.take();
+    if (task == nullptr) {
+        progressTask = tasks::create("motion progress", [this]() { trackProgress(); });
+        task = tasks::create("motion", [this]() { work(); });
+    }
+    mutex.give();
+}
+
+void MotionWorker::work() {
+    while (true) {
+        pros::Task::notify_take(true, TIMEOUT_MAX);
+        while (started < queued) {
+            const uint32_t index = started;
+            // copy the command so its slot can be reused while it runs
+            const Command command = commands[index % QUEUE_SIZE];
+            if (index < stopIndex) {
+                // cancelled by cancelAllMotions before it started
+                started = index + 1;
+                pros::c::task_notify(command.caller);
+                finish(index, command.type, MotionEnd::CANCELLED, 0);
+                continue;
+            }
+            // time spent waiting for the previous motion to end isn't startup latency
+            const uint32_t latency = clock.micros() - std::max(command.queued, lastFinished);
+            totalLatency += latency;
+            if (latency > maxLatency) maxLatency = latency;
+            TRACE_COUNTER("motion latency", latency);
+            turning = command.type == Command::Type::TURN_TO;
+            type = command.type;
+            startTime = clock.micros();
+            started = index + 1;
+            progressTask->notify();
+            pros::c::task_notify(command.caller);
+            const MotionEnd reason = execute(index, command);
+            // leave the drivetrain running into the next motion, and stop it if there is none
+            if (queued <= std::max<uint32_t>(index + 1, stopIndex)) {
+                drivetrain.leftMotors->move(0);
+                drivetrain.rightMotors->move(0);
+            }
+            lastFinished = clock.micros();
+            finish(index, command.type, reason, (lastFinished - startTime) / 1000);
+        }
+    }
+}
+
+void MotionWorker::finish(uint32_t motion, Command::Type type, MotionEnd reason, uint32_t duration) {
+    lastEnd = reason;
+    finished = motion + 1;
+    wakeWaiters();
+    lemlib::telemetrySink()->info("motion,{},{},{},{}", motion, typeName(static_cast<int>(type)), endName(reason),
+                                  duration);
+}
+
+void MotionWorker::stopBefore(uint32_t end, MotionEnd reason) {
+    uint32_t current = stopIndex;
+    while (current < end) {
+        stopReason = reason;
+        if (stopIndex.compare_exchange_weak(current, end)) break;
+    }
+    // the worker sleeps on its notification between iterations, and checks stopIndex as soon as it wakes
+    pros::Task* worker = task;
+    if (worker != nullptr) worker->notify();
+}
+
+bool MotionWorker::cancelMotion() {
+    const uint32_t count = started;
+    if (finished >= count) return false;
+    stopBefore(count, MotionEnd::CANCELLED);
+    wait(count - 1, INFINITY);
+    return true;
+}
+
+int MotionWorker::cancelAllMotions() {
+    const uint32_t end = queued;
+    const uint32_t count = started;
+    const uint32_t cancelled = end - count + (finished < count ? 1 : 0);
+    if (cancelled == 0) return 0;
+    stopBefore(end, MotionEnd::CANCELLED);
+    wait(end - 1, INFINITY);
+    return cancelled;
+}
+
+void MotionWorker::setControllerSettings(const lemlib::ControllerSettings& linear,
+                                         const lemlib::ControllerSettings& angular, float trackWidth) {
+    settingsMutex.take();
+    nextLinear = linear;
+    nextAngular = angular;
+    nextTrackWidth = trackWidth;
+    settingsVersion++;
+    settingsMutex.give();
+}
+
+bool MotionWorker::loadSettings() {
+    // checked every iteration, so only take the mutex when something changed
+    if (settingsVersion == loadedVersion) return false;
+    settingsMutex.take();
+    linearSettings = nextLinear;
+    angularSettings = nextAngular;
+    trackWidth = nextTrackWidth;
+    loadedVersion = settingsVersion;
+    settingsMutex.give();
+    return true;
+}
+
+void MotionWorker::setStallDetection(const StallSettings& settings) { stall = settings; }
+
+MotionEnd MotionWorker::getLastEnd() { return lastEnd; }
+
+bool MotionWorker::stalled() {
+    double velocity = 0;
+    int count = 0;
+    for (pros::Motor_Group* group : {drivetrain.leftMotors, drivetrain.rightMotors}) {
+        for (const double v : group->get_actual_velocities()) {
+            velocity += std::fabs(v);
+            count++;
+        }
+    }
+    if (count == 0 || velocity / count >= stall.maxVelocity) return false;
+    int64_t current = 0;
+    for (pros::Motor_Group* group : {drivetrain.leftMotors, drivetrain.rightMotors}) {
+        for (const int32_t draw : group->get_current_draws()) current += draw;
+    }
+    return current / count > stall.minCurrent;
+}
+
+void MotionWorker::turnTo(float x, float y, int timeout, bool forwards, float maxSpeed) {
+    run({Command::Type::TURN_TO, x, y, 0, timeout, forwards, 0, 0, maxSpeed, nullptr});
+}
+
+void MotionWorker::moveToPose(float x, float y, float theta, int timeout, bool forwards, float chasePower, float lead,
+                              float maxSpeed) {
+    run({Command::Type::MOVE_TO_POSE, x, y, theta, timeout, forwards, chasePower, lead, maxSpeed, nullptr});
+}
+
+void MotionWorker::moveToPoint(float x, float y, int timeout, bool forwards, float maxSpeed) {
+    run({Command::Type::MOVE_TO_POINT, x, y, 0, timeout, forwards, 0, 0, maxSpeed, nullptr});
+}
+
+uint32_t MotionWorker::moveToNearestTriball(TriballTracker& tracker, int timeout, float stopShort, float maxSpeed) {
+    const lemlib::Pose pose = lemlib::getPose();
+    const TriballSet set = tracker.get();
+    const Triball* triball = set.nearest(pose.x, pose.y);
+    if (triball == nullptr) return 0;
+    const float distance = std::hypot(triball->x - pose.x, triball->y - pose.y);
+    // back along the line from the robot, but never past where the robot already is
+    const float t = distance > stopShort ? (distance - stopShort) / distance : 0;
+    moveToPoint(pose.x + (triball->x - pose.x) * t, pose.y + (triball->y - pose.y) * t, timeout, true, maxSpeed);
+    return triball->id;
+}
+
+void MotionWorker::follow(const asset& path, float lookahead, int timeout, bool forwards) {
+    // the lookahead goes in the x field
+    run({Command::Type::FOLLOW, lookahead, 0, 0, timeout, forwards, 0, 0, 0, &path});
+}
+
+void MotionWorker::run(Command command) {
+    TRACE_SCOPE("MotionWorker::run");
+    if (task == nullptr) start();
+    command.caller = pros::c::task_get_current();
+    mutex.take();
+    // wait for a free slot. Only happens with more than QUEUE_SIZE tasks queueing motions at once
+    while (queued - started >= QUEUE_SIZE) pros::delay(1);
+    const uint32_t index = queued;
+    command.queued = clock.micros();
+    commands[index % QUEUE_SIZE] = command;
+    queued = index + 1;
+    mutex.give();
+    static_cast<pros::Task*>(task)->notify();
+    // the worker notifies this task when the motion starts
+    while (started < index + 1) pros::Task::notify_take(true, TIMEOUT_MAX);
+}
+
+void MotionWorker::trackProgress() {
+    uint32_t tracking = 0;
+    bool tracked = false;
+    float distance = 0;
+    lemlib::Pose last(0, 0, 0);
+    float startTheta = 0;
+    uint32_t time = pros::millis();
+    // stall times are in microseconds
+    uint64_t lastStallCheck = 0;
+    bool stalling = false;
+    uint64_t stallStart = 0;
+    while (true) {
+        if (finished >= started) {
+            // nothing to track until the worker starts the next motion
+            pros::Task::notify_take(true, TIMEOUT_MAX);
+            time = pros::millis();
+            continue;
+        }
+        TRACE_SCOPE("MotionWorker::trackProgress");
+        const uint32_t motion = started - 1;
+        lemlib::Pose pose = lemlib::getPose();
+        if (!tracked || motion != tracking) {
+            tracked = true;
+            tracking = motion;
+            distance = 0;
+            last = pose;
+            startTheta = pose.theta;
+            stalling = false;
+        }
+        // the same measure the chassis uses for its own waitUntil
+        if (turning) {
+            distance = std::fabs(lemlib::angleError(pose.theta, startTheta, false));
+        } else {
+            distance += pose.distance(last);
+            last = pose;
+        }
+        progress = distance;
+        progressMotion = motion;
+        wakeWaiters();
+        const uint64_t now = clock.micros();
+        if (stall.maxVelocity > 0 && now - startTime >= stall.grace * 1000ull &&
+            now - lastStallCheck >= STALL_PERIOD) {
+            lastStallCheck = now;
+            if (!stalled()) {
+                stalling = false;
+            } else if (!stalling) {
+                stalling = true;
+                stallStart = now;
+            } else if (now - stallStart >= stall.stallTime * 1000ull) {
+                stalling = false;
+                // does nothing if the motion has ended since it was checked
+                stopBefore(motion + 1, MotionEnd::STALLED);
+            }
+        }
+        pros::Task::delay_until(&time, tasks::getPeriod("motion progress"));
+    }
+}
+
+bool MotionWorker::reached(uint32_t motion, float threshold) {
+    if (finished > motion) return true;
+    return progressMotion == motion && started == motion + 1 && progress > threshold;
+}
+
+void MotionWorker::wakeWaiters() {
+    waiterMutex.take();
+    for (Waiter& waiter : waiters) {
+        if (waiter.task == nullptr || waiter.woken || !reached(waiter.motion, waiter.threshold)) continue;
+        waiter.woken = true;
+        pros::c::task_notify(waiter.task);
+    }
+    waiterMutex.give();
+}
+
+void MotionWorker::wait(uint32_t motion, float threshold) {
+    TRACE_SCOPE("MotionWorker::wait");
+    // checking and registering under the lock means a crossing published after the check is seen by the next
+    // wakeWaiters, which has to take the lock after this task registered
+    waiterMutex.take();
+    if (reached(motion, threshold)) {
+        waiterMutex.give();
+        return;
+    }
+    Waiter* slot = nullptr;
+    for (Waiter& waiter : waiters) {
+        if (waiter.task == nullptr) {
+            slot = &waiter;
+            break;
+        }
+    }
+    if (slot == nullptr) {
+        // more waiters than slots. Fall back to polling
+        waiterMutex.give();
+        while (!reached(motion, threshold)) pros::delay(1);
+        return;
+    }
+    slot->task = pros::c::task_get_current();
+    slot->motion = motion;
+    slot->threshold = threshold;
+    slot->woken = false;
+    waiterMutex.give();
+    // other notifications, like the worker's when a motion starts, wake this task too
+    while (!slot->woken) pros::Task::notify_take(true, TIMEOUT_MAX);
+    waiterMutex.take();
+    slot->task = nullptr;
+    waiterMutex.give();
+}
+
+MotionEnd MotionWorker::execute(uint32_t motion, const Command& command) {
+    TRACE_SCOPE("MotionWorker::execute");
+    loadSettings();
+    switch (command.type) {
+        case Command::Type::TURN_TO: return turnToLoop(motion, command);
+        case Command::Type::MOVE_TO_POSE: return moveToPoseLoop(motion, command);
+        case Command::Type::MOVE_TO_POINT: return moveToPointLoop(motion, command);
+        case Command::Type::FOLLOW: return followLoop(motion, command);
+    }
+    return MotionEnd::SETTLED;
+}
+
+bool MotionWorker::nextIteration(uint32_t motion, uint32_t& wake) {
+    wake += tasks::getPeriod("motion");
+    // an iteration that ran long is followed by the next one straight away, without trying to catch up
+    if (static_cast<int32_t>(pros::millis() - wake) > 0) wake = pros::millis();
+    while (motion >= stopIndex) {
+        const uint32_t now = pros::millis();
+        if (static_cast<int32_t>(wake - now) <= 0) return true;
+        // new commands notify the worker too, which only makes it check again
+        pros::Task::notify_take(true, wake - now);
+    }
+    return false;
+}
+
+void MotionWorker::drive(float linear, float angular, float maxSpeed, bool forwards) {
+    angular = std::clamp(angular, -maxSpeed, maxSpeed);
+    // turning takes priority over moving
+    const float overturn = std::fabs(angular) + std::fabs(linear) - maxSpeed;
+    if (overturn > 0) linear -= linear > 0 ? overturn : -overturn;
+    if (!forwards) linear = -linear;
+    drivetrain.leftMotors->move(linear + angular);
+    drivetrain.rightMotors->move(linear - angular);
+}
+
+MotionEnd MotionWorker::turnToLoop(uint32_t motion, const Command& command) {
+    Pid pid = controller(angularSettings, clock);
+    Settle settle(angularSettings);
+    float prevPower = 0;
+    uint32_t wake = pros::millis();
+    do {
+        if (loadSettings()) setGains(pid, angularSettings);
+        const uint64_t now = clock.micros();
+        if (static_cast<int64_t>(now - startTime) >= command.timeout * 1000ll) return MotionEnd::TIMEOUT;
+        const lemlib::Pose pose = facing(command.forwards);
+        const float error =
+            lemlib::radToDeg(lemlib::angleError(headingTo(pose, command.x, command.y), pose.theta, true));
+        if (settle.update(error, now)) return MotionEnd::SETTLED;
+        float power = std::clamp(pid.update(error), -command.maxSpeed, command.maxSpeed);
+        power = lemlib::slew(power, prevPower, angularSettings.slew);
+        prevPower = power;
+        drive(0, power, command.maxSpeed, true);
+    } while (nextIteration(motion, wake));
+    return stopReason;
+}
+
+MotionEnd MotionWorker::moveToPointLoop(uint32_t motion, const Command& command) {
+    Pid linearPid = controller(linearSettings, clock);
+    Pid angularPid = controller(angularSettings, clock);
+    Settle settle(linearSettings);
+    float maxSpeed = command.maxSpeed;
+    float prevLinear = 0;
+    bool close = false;
+    uint32_t wake = pros::millis();
+    do {
+        if (loadSettings()) {
+            setGains(linearPid, linearSettings);
+            setGains(angularPid, angularSettings);
+        }
+        const uint64_t now = clock.micros();
+        if (static_cast<int64_t>(now - startTime) >= command.timeout * 1000ll) return MotionEnd::TIMEOUT;
+        const lemlib::Pose pose = facing(command.forwards);
+        const float distance = std::hypot(command.x - pose.x, command.y - pose.y);
+        if (!close && distance < SETTLE_DISTANCE) {
+            // stop steering, so the robot doesn't circle a target it is about to pass, and stop speeding up
+            close = true;
+            maxSpeed = std::max(std::fabs(prevLinear), 30.0f);
+        }
+        const float angularError = lemlib::angleError(headingTo(pose, command.x, command.y), pose.theta, true);
+        // distance left along the heading, negative once the robot has passed the target
+        const float linearError = distance * fastmath::cos(angularError);
+        if (settle.update(linearError, now)) return MotionEnd::SETTLED;
+        float linear = std::clamp(linearPid.update(linearError), -maxSpeed, maxSpeed);
+        if (!close) linear = lemlib::slew(linear, prevLinear, linearSettings.slew);
+        const float angular = close ? 0 : angularPid.update(lemlib::radToDeg(angularError));
+        prevLinear = linear;
+        drive(linear, angular, maxSpeed, command.forwards);
+    } while (nextIteration(motion, wake));
+    return stopReason;
+}
+
+MotionEnd MotionWorker::moveToPoseLoop(uint32_t motion, const Command& command) {
+    Pid linearPid = controller(linearSettings, clock);
+    Pid angularPid = controller(angularSettings, clock);
+    Settle settle(linearSettings);
+    // the target heading turns around with the pose when driving backwards
+    const float targetTheta = lemlib::degToRad(command.theta) + (command.forwards ? 0 : M_PI);
+    float targetSin, targetCos;
+    fastmath::sinCos(targetTheta, targetSin, targetCos);
+    const float chasePower = command.chasePower != 0 ? command.chasePower : drivetrain.chasePower;
+    float maxSpeed = command.maxSpeed;
+    float prevLinear = 0;
+    bool close = false;
+    uint32_t wake = pros::millis();
+    do {
+        if (loadSettings()) {
+            setGains(linearPid, linearSettings);
+            setGains(angularPid, angularSettings);
+        }
+        const uint64_t now = clock.micros();
+        if (static_cast<int64_t>(now - startTime) >= command.timeout * 1000ll) return MotionEnd::TIMEOUT;
+        const lemlib::Pose pose = facing(command.forwards);
+        const float distance = std::hypot(command.x - pose.x, command.y - pose.y);
+        if (!close && distance < SETTLE_DISTANCE) {
+            close = true;
+            maxSpeed = std::max(std::fabs(prevLinear), 30.0f);
+        }
+        // the carrot point, behind the target along its heading by lead times the distance left, draws the robot
+        // onto the target heading. Once close the robot drives at the target itself and turns to its heading
+        float carrotX = command.x;
+        float carrotY = command.y;
+        if (!close) {
+            carrotX -= targetSin * command.lead * distance;
+            carrotY -= targetCos * command.lead * distance;
+        }
+        const float toCarrot = lemlib::angleError(headingTo(pose, carrotX, carrotY), pose.theta, true);
+        const float angularError = close ? lemlib::angleError(targetTheta, pose.theta, true) : toCarrot;
+        const float linearError = std::hypot(carrotX - pose.x, carrotY - pose.y) * fastmath::cos(toCarrot);
+        if (settle.update(linearError, now)) return MotionEnd::SETTLED;
+        float linear = std::clamp(linearPid.update(linearError), -maxSpeed, maxSpeed);
+        if (!close) {
+            linear = lemlib::slew(linear, prevLinear, linearSettings.slew);
+            // slow down on tight curves so the wheels don't slip, v = sqrt(chase power * radius * g)
+            const float curvature = std::fabs(arcCurvature(pose, carrotX, carrotY));
+            if (curvature > 0) {
+                const float maxSlip = std::sqrt(chasePower / curvature * 9.8f);
+                linear = std::clamp(linear, -maxSlip, maxSlip);
+            }
+        }
+        const float angular = angularPid.update(lemlib::radToDeg(angularError));
+        prevLinear = linear;
+        drive(linear, angular, maxSpeed, command.forwards);
+    } while (nextIteration(motion, wake));
+    return stopReason;
+}
+
+MotionEnd MotionWorker::followLoop(uint32_t motion, const Command& command) {
+    const int count = parsePath(*command.path, pathPoints, MAX_PATH_POINTS);
+    if (count == 0) return MotionEnd::SETTLED;
+    // the lookahead goes in the x field
+    const float lookahead = command.x;
+    int closest = 0;
+    float prevSpeed = 0;
+    uint32_t wake = pros::millis();
+    do {
+        // the gains aren't used, but the slew and the track width are
+        loadSettings();
+        const uint64_t now = clock.micros();
+        if (static_cast<int64_t>(now - startTime) >= command.timeout * 1000ll) return MotionEnd::TIMEOUT;
+        const lemlib::Pose pose = facing(command.forwards);
+        closest = closestPoint(pathPoints, count, pose, closest);
+        // the path ends at a waypoint with a speed of 0
+        if (closest == count - 1 || pathPoints[closest].speed == 0) return MotionEnd::SETTLED;
+        const lemlib::Pose target = lookaheadPoint(pathPoints, count, pose, closest, lookahead);
+        const float curvature = arcCurvature(pose, target.x, target.y);
+        const float speed = lemlib::slew(pathPoints[closest].speed, prevSpeed, linearSettings.slew);
+        prevSpeed = speed;
+        float left = speed * (2 + curvature * trackWidth) / 2;
+        float right = speed * (2 - curvature * trackWidth) / 2;
+        // keep the ratio between the sides when one would pass full power
+        const float ratio = std::max(std::fabs(left), std::fabs(right)) / 127;
+        if (ratio > 1) {
+            left /= ratio;
+            right /= ratio;
+        }
+        drive((left + right) / 2, (left - right) / 2, 127, command.forwards);
+    } while (nextIteration(motion, wake));
+    return stopReason;
+}
+
+void MotionWorker::waitUntil(float dist) {
+    // the current motion is the last one started. Motion calls only return once their motion has started
+    const uint32_t count = started;
+    if (count > 0) wait(count - 1, dist);
+}
+
+bool MotionWorker::hasTraveled(float dist) {
+    const uint32_t count = started;
+    return count == 0 || reached(count - 1, dist);
+}
+
+void MotionWorker::waitUntilDone() {
+    const uint32_t count = queued;
+    if (count > 0) wait(count - 1, INFINITY);
+}
+
+float MotionWorker::getProgress() {
+    const uint32_t count = started;
+    if (finished >= count) return -1;
+    return progressMotion == count - 1 ? static_cast<float>(progress) : 0;
+}
+
+bool MotionWorker::isBusy() { return finished < queued; }
+
+MotionStats MotionWorker::getStats() {
+    const uint32_t motions = started;
+    return {motions, motions > 0 ? static_cast<uint32_t>(totalLatency / motions) : 0, maxLatency, finished};
+}
+} // namespace robot
@@ -0,0 +1,16 @@
+#include "lemlib/chassis/trackingWheel.hpp"
+#include "robot/odom.hpp"
+
+namespace robot {
+lemlib::OdomSensors withDrivetrainWheels(lemlib::OdomSensors sensors, const lemlib::Drivetrain& drivetrain) {
+    if (sensors.vertical1 == nullptr) {
+        sensors.vertical1 = new lemlib::TrackingWheel(drivetrain.leftMotors, drivetrain.wheelDiameter,
+                                                      -(drivetrain.trackWidth / 2), drivetrain.rpm);
+    }
+    if (sensors.vertical2 == nullptr) {
+        sensors.vertical2 = new lemlib::TrackingWheel(drivetrain.rightMotors, drivetrain.wheelDiameter,
+                                                      drivetrain.trackWidth / 2, drivetrain.rpm);
+    }
+    return sensors;
+}
+} // namespace robot
@@ -0,0 +1,65 @@
+#include "robot/outputs.hpp"
+#include "robot/trace.hpp"
+
+namespace robot {
+int Outputs::add(Output::Type type, void* device) {
+    if (outputCount >= MAX_OUTPUTS) return -1;
+    outputs[outputCount] = {type, device, 0, false, 0, false};
+    return outputCount++;
+}
+
+int Outputs::addMotor(pros::Motor* motor) { return add(Output::Type::MOTOR, motor); }
+
+int Outputs::addMotorGroup(pros::Motor_Group* motors) { return add(Output::Type::MOTOR_GROUP, motors); }
+
+int Outputs::addDigital(pros::ADIDigitalOut* digital) { return add(Output::Type::DIGITAL, digital); }
+
+void Outputs::command(int output, int32_t value) {
+    if (output < 0 || output >= outputCount) return;
+    Output& out = outputs[output];
+    tick.commands++;
+    if (out.pending) tick.overwritten++;
+    out.command = value;
+    out.pending = true;
+}
+
+void Outputs::move(int output, int32_t power) { command(output, power); }
+
+void Outputs::set(int output, bool value) { command(output, value); }
+
+void Outputs::flush() {
+    TRACE_SCOPE("Outputs::flush");
+    for (int i = 0; i < outputCount; i++) {
+        Output& out = outputs[i];
+        if (!out.pending) continue;
+        out.pending = false;
+        if (out.written && out.last == out.command) {
+            tick.unchanged++;
+            continue;
+        }
+        switch (out.type) {
+            case Output::Type::MOTOR: static_cast<pros::Motor*>(out.device)->move(out.command); break;
+            case Output::Type::MOTOR_GROUP: static_cast<pros::Motor_Group*>(out.device)->move(out.command); break;
+            case Output::Type::DIGITAL: static_cast<pros::ADIDigitalOut*>(out.device)->set_value(out.command); break;
+        }
+        out.last = out.command;
+        out.written = true;
+        tick.writes++;
+    }
+    TRACE_COUNTER("output writes", tick.writes);
+    totals.commands += tick.commands;
+    totals.overwritten += tick.overwritten;
+    totals.unchanged += tick.unchanged;
+    totals.writes += tick.writes;
+    lastTick = tick;
+    tick = {};
+}
+
+void Outputs::invalidate() {
+    for (int i = 0; i < outputCount; i++) outputs[i].written = false;
+}
+
+OutputCounts Outputs::getLastTick() { return lastTick; }
+
+OutputCounts Outputs::getTotals() { return totals; }
+} // namespace robot
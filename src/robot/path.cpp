@@ -0,0 +1,108 @@
+#include <cmath>
+#include <cstdlib>
+#include "robot/path.hpp"
+
+namespace robot {
+/**
+ * @brief Parse a number from a buffer that is not null terminated
+ *
+ * @return const char* - pointer to the first character after the number, or start if there is no number
+ */
+static const char* parseNumber(const char* start, const char* end, float& out) {
+    const char* c = start;
+    bool negative = false;
+    if (c < end && (*c == '-' || *c == '+')) negative = *c++ == '-';
+    float value = 0;
+    bool digits = false;
+    while (c < end && *c >= '0' && *c <= '9') {
+        value = value * 10 + (*c++ - '0');
+        digits = true;
+    }
+    if (c < end && *c == '.') {
+        c++;
+        float scale = 0.1;
+        while (c < end && *c >= '0' && *c <= '9') {
+            value += (*c++ - '0') * scale;
+            scale *= 0.1;
+            digits = true;
+        }
+    }
+    if (!digits) return start;
+    out = negative ? -value : value;
+    return c;
+}
+
+int parsePath(const asset& path, PathPoint* points, int maxPoints) {
+    const char* c = reinterpret_cast<const char*>(path.buf);
+    const char* end = c + path.size;
+    int count = 0;
+    while (c < end && count < maxPoints) {
+        // skip blank space between lines
+        while (c < end && (*c == '\n' || *c == '\r' || *c == ' ')) c++;
+        if (c >= end || *c == 'e') break; // "endData", the rest of the file is the editor's data
+        float values[3] = {0, 0, 0};
+        int parsed = 0;
+        while (parsed < 3) {
+            while (c < end && (*c == ' ' || *c == ',')) c++;
+            const char* next = parseNumber(c, end, values[parsed]);
+            if (next == c) break;
+            c = next;
+            parsed++;
+        }
+        if (parsed >= 2) points[count++] = {values[0], values[1], values[2]};
+        // move on to the next line
+        while (c < end && *c != '\n') c++;
+    }
+    return count;
+}
+
+int closestPoint(const PathPoint* points, int count, lemlib::Pose pose, int start) {
+    int closest = start < count ? start : count - 1;
+    float closestDist = INFINITY;
+    for (int i = closest; i < count; i++) {
+        const float dx = points[i].x - pose.x;
+        const float dy = points[i].y - pose.y;
+        const float dist = dx * dx + dy * dy;
+        if (dist < closestDist) {
+            closestDist = dist;
+            closest = i;
+        }
+    }
+    return closest;
+}
+
+/**
+ * @brief Intersection of the segment p1->p2 with a circle around the pose
+ *
+ * @return float - the furthest t along the segment where it intersects, or -1 if it doesn't
+ */
+static float circleIntersect(const PathPoint& p1, const PathPoint& p2, lemlib::Pose pose, float radius) {
+    const float dx = p2.x - p1.x;
+    const float dy = p2.y - p1.y;
+    const float fx = p1.x - pose.x;
+    const float fy = p1.y - pose.y;
+    const float a = dx * dx + dy * dy;
+    const float b = 2 * (fx * dx + fy * dy);
+    const float c = fx * fx + fy * fy - radius * radius;
+    const float discriminant = b * b - 4 * a * c;
+    if (a == 0 || discriminant < 0) return -1;
+    const float root = std::sqrt(discriminant);
+    const float t1 = (-b - root) / (2 * a);
+    const float t2 = (-b + root) / (2 * a);
+    if (t2 >= 0 && t2 <= 1) return t2;
+    if (t1 >= 0 && t1 <= 1) return t1;
+    return -1;
+}
+
+lemlib::Pose lookaheadPoint(const PathPoint* points, int count, lemlib::Pose pose, int closest, float lookahead) {
+    for (int i = count - 2; i >= closest && i >= 0; i--) {
+        const float t = circleIntersect(points[i], points[i + 1], pose, lookahead);
+        if (t >= 0) {
+            return lemlib::Pose(points[i].x + (points[i + 1].x - points[i].x) * t,
+                                points[i].y + (points[i + 1].y - points[i].y) * t, points[i].speed);
+        }
+    }
+    const PathPoint& last = points[count - 1];
+    return lemlib::Pose(last.x, last.y, last.speed);
+}
+} // namespace robot
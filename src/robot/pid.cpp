@@ -0,0 +1,46 @@
+#include <cmath>
+#include "robot/pid.hpp"
+
+namespace robot {
+Pid::Pid(float kP, float kI, float kD, float windupRange, bool signFlipReset, Clock& clock)
+    : kP(kP),
+      kI(kI),
+      kD(kD),
+      windupRange(windupRange),
+      signFlipReset(signFlipReset),
+      timer(clock) {}
+
+void Pid::setGains(float kP, float kI, float kD) {
+    this->kP = kP;
+    this->kI = kI;
+    this->kD = kD;
+}
+
+float Pid::update(float error) { return update(error, timer.update()); }
+
+float Pid::update(float error, float dt) {
+    if (started && dt > 0) {
+        if (signFlipReset && std::signbit(error) != std::signbit(prevError)) integral = 0;
+        if (windupRange == 0 || std::fabs(error) < windupRange) integral += error * dt;
+        derivative = (error - prevError) / dt;
+    } else if (!started) {
+        derivative = 0;
+    }
+    // two updates in the same microsecond keep the last derivative, rather than dividing by 0
+    if (dt > 0 || !started) prevError = error;
+    started = true;
+    return kP * error + kI * integral + kD * derivative;
+}
+
+void Pid::reset() {
+    timer.reset();
+    started = false;
+    prevError = 0;
+    integral = 0;
+    derivative = 0;
+}
+
+float Pid::getIntegral() { return integral; }
+
+float Pid::getDerivative() { return derivative; }
+} // namespace robot
@@ -0,0 +1,75 @@
+#include "lemlib/chassis/odom.hpp"
+#include "robot/poseSource.hpp"
+#include "robot/tasks.hpp"
+#include "robot/trace.hpp"
+
+namespace robot {
+void PoseSource::start() {
+    if (task != nullptr) return;
+    update();
+    task = tasks::create("pose", [this]() {
+        uint32_t now = pros::millis();
+        while (true) {
+            pros::c::task_delay_until(&now, tasks::getPeriod("pose"));
+            update();
+        }
+    });
+}
+
+void PoseSource::publish(const lemlib::Pose& pose) {
+    uint32_t sequence;
+    PoseSample& sample = samples.beginWrite(sequence);
+    sample = {sequence, clock.micros(), pose.x, pose.y, pose.theta};
+    // publish the sample only once it is complete
+    samples.publish();
+}
+
+void PoseSource::update() {
+    TRACE_SCOPE("PoseSource::update");
+    const uint32_t priority = pros::c::task_get_priority(nullptr);
+    // the odometry task can't start an update while this task has the highest priority
+    pros::c::task_set_priority(nullptr, TASK_PRIORITY_MAX);
+    publish(lemlib::getPose());
+    pros::c::task_set_priority(nullptr, priority);
+}
+
+void PoseSource::setPose(lemlib::Pose pose) {
+    const uint32_t priority = pros::c::task_get_priority(nullptr);
+    pros::c::task_set_priority(nullptr, TASK_PRIORITY_MAX);
+    lemlib::setPose(pose);
+    publish(pose);
+    pros::c::task_set_priority(nullptr, priority);
+}
+
+PoseSample PoseSource::get() { return samples.get(); }
+
+LemLibOdometry::LemLibOdometry(PoseSource& source, const okapi::ChassisScales& scales,
+                               std::shared_ptr<okapi::ReadOnlyChassisModel> model)
+    : source(source),
+      scales(scales),
+      model(std::move(model)) {}
+
+void LemLibOdometry::setScales(const okapi::ChassisScales& scales) { this->scales = scales; }
+
+void LemLibOdometry::step() {}
+
+okapi::OdomState LemLibOdometry::getState(const okapi::StateMode& mode) const {
+    using namespace okapi::literals;
+    const PoseSample pose = source.get();
+    // LemLib's frame is okapi's cartesian frame. The frame transformation mode swaps x and y, and keeps the heading
+    if (mode == okapi::StateMode::CARTESIAN) return {pose.x * 1_in, pose.y * 1_in, pose.theta * 1_deg};
+    return {pose.y * 1_in, pose.x * 1_in, pose.theta * 1_deg};
+}
+
+void LemLibOdometry::setState(const okapi::OdomState& state, const okapi::StateMode& mode) {
+    const float x = state.x.convert(okapi::inch);
+    const float y = state.y.convert(okapi::inch);
+    const float theta = state.theta.convert(okapi::degree);
+    if (mode == okapi::StateMode::CARTESIAN) source.setPose(lemlib::Pose(x, y, theta));
+    else source.setPose(lemlib::Pose(y, x, theta));
+}
+
+std::shared_ptr<okapi::ReadOnlyChassisModel> LemLibOdometry::getModel() { return model; }
+
+okapi::ChassisScales LemLibOdometry::getScales() { return scales; }
+} // namespace robot
@@ -0,0 +1,110 @@
+#include <cstdio>
+#include <cstring>
+#include "lemlib/chassis/odom.hpp"
+#include "robot/recorder.hpp"
+#include "robot/tasks.hpp"
+#include "robot/trace.hpp"
+
+namespace robot {
+Recorder::Recorder(const lemlib::Drivetrain& drivetrain, pros::Imu* imu, pros::Rotation* rotation,
+                   pros::Controller* controller)
+    : trackWidth(drivetrain.trackWidth),
+      wheelDiameter(drivetrain.wheelDiameter),
+      rpm(drivetrain.rpm),
+      imu(imu),
+      rotation(rotation),
+      controller(controller) {
+    for (int i = 0; i < drivetrain.leftMotors->size(); i++) addMotor(&drivetrain.leftMotors->at(i));
+    leftCount = motorCount;
+    for (int i = 0; i < drivetrain.rightMotors->size(); i++) addMotor(&drivetrain.rightMotors->at(i));
+    rightCount = motorCount - leftCount;
+}
+
+bool Recorder::addMotor(pros::Motor* motor) {
+    if (motorCount >= RECORDING_MAX_MOTORS) return false;
+    motors[motorCount++] = motor;
+    return true;
+}
+
+void Recorder::start() {
+    sampleCount = 0;
+    recording = true;
+    if (task != nullptr) return;
+    task = tasks::create("recorder", [this]() {
+        uint32_t time = pros::millis();
+        while (true) {
+            if (recording) sample();
+            pros::Task::delay_until(&time, PERIOD);
+        }
+    });
+}
+
+bool Recorder::stop() { return recording.exchange(false); }
+
+void Recorder::sample() {
+    TRACE_SCOPE("Recorder::sample");
+    const int index = sampleCount;
+    if (index >= MAX_SAMPLES) {
+        recording = false;
+        return;
+    }
+    SensorSample& sample = samples[index];
+    sample.time = pros::millis();
+    for (int i = 0; i < RECORDING_MAX_MOTORS; i++) {
+        if (i < motorCount) {
+            sample.motorPositions[i] = motors[i]->get_raw_position(&sample.motorTimestamps[i]);
+        } else {
+            sample.motorPositions[i] = 0;
+            sample.motorTimestamps[i] = 0;
+        }
+    }
+    sample.imuRotation = imu != nullptr ? imu->get_rotation() : 0;
+    sample.rotationPosition = rotation != nullptr ? rotation->get_position() : 0;
+    sample.buttons = 0;
+    for (int i = 0; i < 4; i++) {
+        sample.analog[i] = controller != nullptr ? controller->get_analog(static_cast<pros::controller_analog_e_t>(i)) : 0;
+    }
+    for (int i = 0; i < 12 && controller != nullptr; i++) {
+        if (controller->get_digital(static_cast<pros::controller_digital_e_t>(pros::E_CONTROLLER_DIGITAL_L1 + i))) {
+            sample.buttons |= 1 << i;
+        }
+    }
+    sample.padding = 0;
+    const lemlib::Pose pose = lemlib::getPose();
+    sample.poseX = pose.x;
+    sample.poseY = pose.y;
+    sample.poseTheta = pose.theta;
+    // publish the sample only once it is complete
+    sampleCount = index + 1;
+}
+
+bool Recorder::save(const char* path) {
+    RecordingHeader header;
+    std::memset(&header, 0, sizeof(header));
+    std::memcpy(header.magic, "RREC", 4);
+    header.version = RECORDING_VERSION;
+    header.sampleSize = sizeof(SensorSample);
+    header.motorCount = motorCount;
+    header.leftCount = leftCount;
+    header.rightCount = rightCount;
+    header.period = PERIOD;
+    for (int i = 0; i < motorCount; i++) {
+        header.ports[i] = motors[i]->is_reversed() ? -motors[i]->get_port() : motors[i]->get_port();
+        header.gearsets[i] = motors[i]->get_gearing();
+    }
+    header.trackWidth = trackWidth;
+    header.wheelDiameter = wheelDiameter;
+    header.rpm = rpm;
+    header.sampleCount = sampleCount;
+    FILE* file = std::fopen(path, "wb");
+    if (file == nullptr) return false;
+    bool written = std::fwrite(&header, sizeof(header), 1, file) == 1;
+    if (header.sampleCount > 0) {
+        written = written && std::fwrite(samples, sizeof(SensorSample), header.sampleCount, file) == header.sampleCount;
+    }
+    std::fclose(file);
+    return written;
+}
+
+int Recorder::getSampleCount() { return sampleCount; }
+} // namespace robot
@@ -0,0 +1,156 @@
+#include <cstring>
+#include "pros/misc.hpp"
+#include "robot/sdLogger.hpp"
+#include "robot/tasks.hpp"
+#include "robot/trace.hpp"
+
+namespace robot {
+SdLogger::SdLogger(const char* prefix, uint16_t recordSize, uint32_t maxFileSize, uint32_t syncInterval)
+    : recordSize(recordSize),
+      recordsPerBlock(recordSize > 0 ? (BLOCK_SIZE - sizeof(LogBlockHeader)) / recordSize : 0),
+      maxFileSize(maxFileSize),
+      syncInterval(syncInterval) {
+    std::snprintf(this->prefix, sizeof(this->prefix), "%s", prefix);
+}
+
+bool SdLogger::start() {
+    if (task != nullptr) return true;
+    if (!pros::usd::is_installed()) return false;
+    task = tasks::create("sdLogger", [this]() {
+        openFile();
+        uint32_t lastSync = pros::millis();
+        while (true) {
+            // woken early when a block fills up, or when sync or rotate is called
+            pros::Task::notify_take(true, tasks::getPeriod("sdLogger"));
+            if (pros::millis() - lastSync >= syncInterval) {
+                sync();
+                lastSync = pros::millis();
+            }
+            writeBlocks();
+            if (syncPending && flushed >= syncAt) {
+                syncPending = false;
+                TRACE_SCOPE("SdLogger::flush");
+                if (file != nullptr) std::fflush(file);
+            }
+        }
+    });
+    return true;
+}
+
+bool SdLogger::log(const void* record) {
+    if (recordsPerBlock == 0) return false;
+    // reserve a slot, as long as its block isn't still waiting to be written
+    uint32_t index = head.load(std::memory_order_relaxed);
+    do {
+        if (index / recordsPerBlock - flushed.load(std::memory_order_acquire) >= 2) {
+            dropped.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+    } while (!head.compare_exchange_weak(index, index + 1, std::memory_order_relaxed));
+    const int buffer = index / recordsPerBlock % 2;
+    const uint32_t slot = index % recordsPerBlock;
+    std::memcpy(buffers[buffer] + sizeof(LogBlockHeader) + slot * recordSize, record, recordSize);
+    committed[buffer].fetch_add(1, std::memory_order_release);
+    // the last slot closes the block
+    if (slot == recordsPerBlock - 1) {
+        length[buffer].store(recordsPerBlock, std::memory_order_release);
+        pros::Task* writer = task;
+        if (writer != nullptr) writer->notify();
+    }
+    return true;
+}
+
+void SdLogger::closeBlock() {
+    if (recordsPerBlock == 0) return;
+    uint32_t index = head.load(std::memory_order_relaxed);
+    uint32_t slot;
+    do {
+        slot = index % recordsPerBlock;
+        if (slot == 0) return;
+    } while (!head.compare_exchange_weak(index, index - slot + recordsPerBlock, std::memory_order_relaxed));
+    // the slots after the last record are skipped, so the block only holds the records reserved before it closed
+    length[index / recordsPerBlock % 2].store(slot, std::memory_order_release);
+}
+
+void SdLogger::sync() {
+    closeBlock();
+    syncAt = recordsPerBlock > 0 ? head / recordsPerBlock : 0;
+    syncPending = true;
+    pros::Task* writer = task;
+    if (writer != nullptr) writer->notify();
+}
+
+void SdLogger::rotate() {
+    closeBlock();
+    rotateAt = recordsPerBlock > 0 ? head / recordsPerBlock : 0;
+    rotatePending = true;
+    pros::Task* writer = task;
+    if (writer != nullptr) writer->notify();
+}
+
+bool SdLogger::writeBlocks() {
+    bool wrote = false;
+    while (true) {
+        const uint32_t block = flushed.load(std::memory_order_relaxed);
+        const int buffer = block % 2;
+        const uint32_t records = length[buffer].load(std::memory_order_acquire);
+        // a producer may still be copying into a closed block
+        if (records == 0 || committed[buffer].load(std::memory_order_acquire) != records) break;
+        TRACE_SCOPE("SdLogger::write");
+        const uint32_t bytes = records * recordSize;
+        if (rotatePending && block >= rotateAt) {
+            rotatePending = false;
+            openFile();
+        } else if (fileSize + BLOCK_SIZE > maxFileSize && fileSize > SECTOR_SIZE) {
+            openFile();
+        }
+        // the whole block is written whatever it holds, so every write covers whole sectors
+        uint8_t* data = buffers[buffer];
+        const LogBlockHeader blockHeader = {records, block};
+        std::memcpy(data, &blockHeader, sizeof(blockHeader));
+        std::memset(data + sizeof(blockHeader) + bytes, 0, BLOCK_SIZE - sizeof(blockHeader) - bytes);
+        if (file != nullptr && std::fwrite(data, BLOCK_SIZE, 1, file) == 1) {
+            fileSize += BLOCK_SIZE;
+            written.fetch_add(records, std::memory_order_relaxed);
+        } else {
+            dropped.fetch_add(records, std::memory_order_relaxed);
+        }
+        // hand the buffer back to the producers
+        committed[buffer].store(0, std::memory_order_relaxed);
+        length[buffer].store(0, std::memory_order_relaxed);
+        flushed.store(block + 1, std::memory_order_release);
+        wrote = true;
+    }
+    return wrote;
+}
+
+void SdLogger::openFile() {
+    TRACE_SCOPE("SdLogger::openFile");
+    if (file != nullptr) std::fclose(file);
+    const uint32_t index = fileCount;
+    char path[MAX_PREFIX + 16];
+    std::snprintf(path, sizeof(path), "%s%03u.bin", prefix, static_cast<unsigned>(index));
+    file = std::fopen(path, "wb");
+    fileSize = 0;
+    fileCount = index + 1;
+    if (file == nullptr) return;
+    // blocks are already large, so stdio's buffer would only add a copy
+    std::setvbuf(file, nullptr, _IONBF, 0);
+    LogFileHeader header;
+    std::memcpy(header.magic, "RLOG", 4);
+    header.version = LOG_VERSION;
+    header.recordSize = recordSize;
+    header.index = index;
+    header.time = pros::millis();
+    // padded to a sector, so the blocks after it start on sector boundaries
+    uint8_t sector[SECTOR_SIZE] = {};
+    std::memcpy(sector, &header, sizeof(header));
+    if (std::fwrite(sector, SECTOR_SIZE, 1, file) == 1) fileSize = SECTOR_SIZE;
+}
+
+uint32_t SdLogger::getDropped() { return dropped; }
+
+uint32_t SdLogger::getWritten() { return written; }
+
+uint32_t SdLogger::getFileCount() { return fileCount; }
+} // namespace robot
@@ -0,0 +1,151 @@
+#include "robot/sensorHub.hpp"
+#include "robot/tasks.hpp"
+#include "robot/trace.hpp"
+
+namespace robot {
+int SensorHub::addMotor(pros::Motor* motor, uint8_t values) {
+    if (motorCount >= SensorSnapshot::MAX_MOTORS) return -1;
+    motors[motorCount] = motor;
+    motorValues[motorCount] = values;
+    return motorCount++;
+}
+
+int SensorHub::addRotation(pros::Rotation* rotation, uint8_t values) {
+    if (rotationCount >= SensorSnapshot::MAX_ROTATIONS) return -1;
+    rotations[rotationCount] = rotation;
+    rotationValues[rotationCount] = values;
+    return rotationCount++;
+}
+
+void SensorHub::setImu(pros::Imu* imu) { this->imu = imu; }
+
+void SensorHub::setController(pros::Controller* controller, uint8_t axes, uint16_t buttons) {
+    this->controller = controller;
+    this->axes = axes;
+    this->buttons = buttons;
+}
+
+void SensorHub::setPhaseReference(int motor) {
+    reference = motor < motorCount ? motor : -1;
+    // the phase comes from the reference motor's timestamp
+    if (reference >= 0) motorValues[reference] |= MotorSnapshot::RAW_POSITION;
+}
+
+void SensorHub::start() {
+    if (task != nullptr) return;
+    // readers started before the first tick of the task still get real values
+    update();
+    task = tasks::create("sensor hub", [this]() {
+        uint32_t time = pros::millis();
+        while (true) {
+            pros::Task::delay_until(&time, PERIOD);
+            // nobody has read a snapshot lately. Leave the devices alone until someone does
+            if (pros::millis() - lastRequest > IDLE_TIME) continue;
+            update();
+            if (reference < 0) continue;
+            // the hub is the only writer, so the snapshot it just published can't change under it
+            const uint32_t age = snapshots.getLatest().age;
+            // the devices updated age ms before this read. Wake earlier next time to read just after the update
+            if (age > PHASE_TARGET && age < PERIOD) time -= age - PHASE_TARGET;
+        }
+    });
+}
+
+void SensorHub::update() {
+    TRACE_SCOPE("SensorHub::update");
+    uint32_t sequence;
+    SensorSnapshot& snapshot = snapshots.beginWrite(sequence);
+    snapshot.micros = pros::micros();
+    snapshot.time = pros::millis();
+    // values that aren't read keep whatever the buffer held, which is 0 since none of them is ever written
+    for (int i = 0; i < motorCount; i++) {
+        MotorSnapshot& motor = snapshot.motors[i];
+        const uint8_t values = motorValues[i];
+        if (values & MotorSnapshot::RAW_POSITION) motor.rawPosition = motors[i]->get_raw_position(&motor.timestamp);
+        if (values & MotorSnapshot::POSITION) motor.position = motors[i]->get_position();
+        if (values & MotorSnapshot::VELOCITY) motor.velocity = motors[i]->get_actual_velocity();
+        if (values & MotorSnapshot::CURRENT) motor.current = motors[i]->get_current_draw();
+    }
+    for (int i = 0; i < rotationCount; i++) {
+        RotationSnapshot& rotation = snapshot.rotations[i];
+        const uint8_t values = rotationValues[i];
+        if (values & RotationSnapshot::ANGLE) rotation.angle = rotations[i]->get_angle();
+        if (values & RotationSnapshot::POSITION) rotation.position = rotations[i]->get_position();
+        if (values & RotationSnapshot::VELOCITY) rotation.velocity = rotations[i]->get_velocity();
+    }
+    if (imu != nullptr) {
+        snapshot.imuRotation = imu->get_rotation();
+        snapshot.imuHeading = imu->get_heading();
+    }
+    if (controller != nullptr) {
+        for (int i = 0; i < 4; i++) {
+            if (axes & (1 << i)) {
+                snapshot.analog[i] = controller->get_analog(static_cast<pros::controller_analog_e_t>(i));
+            }
+        }
+        snapshot.buttons = 0;
+        for (int i = 0; i < 12; i++) {
+            if (!(buttons & (1 << i))) continue;
+            if (controller->get_digital(static_cast<pros::controller_digital_e_t>(pros::E_CONTROLLER_DIGITAL_L1 + i))) {
+                snapshot.buttons |= 1 << i;
+            }
+        }
+    }
+    totalReads += getReadsPerSnapshot();
+    snapshot.age = reference >= 0 ? snapshot.time - snapshot.motors[reference].timestamp : 0;
+    snapshot.sequence = sequence;
+    // publish the snapshot only once it is complete
+    snapshots.publish();
+    waiterMutex.take();
+    for (pros::task_t waiter : waiters) {
+        if (waiter != nullptr) pros::c::task_notify(waiter);
+    }
+    waiterMutex.give();
+}
+
+SensorSnapshot SensorHub::get() {
+    lastRequest = pros::millis();
+    return snapshots.get();
+}
+
+SensorSnapshot SensorHub::waitForUpdate(uint32_t sequence) {
+    // wakes an idle hub for its next period
+    lastRequest = pros::millis();
+    waiterMutex.take();
+    int slot = -1;
+    if (snapshots.getSequence() <= sequence) {
+        for (int i = 0; i < MAX_WAITERS; i++) {
+            if (waiters[i] == nullptr) {
+                waiters[i] = pros::c::task_get_current();
+                slot = i;
+                break;
+            }
+        }
+    }
+    waiterMutex.give();
+    const uint32_t start = pros::millis();
+    while (snapshots.getSequence() <= sequence && pros::millis() - start < 2 * PERIOD) {
+        // more waiters than slots. Fall back to polling
+        if (slot < 0) pros::delay(1);
+        else pros::Task::notify_take(true, 2 * PERIOD);
+    }
+    if (slot >= 0) {
+        waiterMutex.take();
+        waiters[slot] = nullptr;
+        waiterMutex.give();
+    }
+    return get();
+}
+
+uint32_t SensorHub::getReadsPerSnapshot() {
+    uint32_t reads = imu != nullptr ? 2 : 0;
+    for (int i = 0; i < motorCount; i++) reads += __builtin_popcount(motorValues[i]);
+    for (int i = 0; i < rotationCount; i++) reads += __builtin_popcount(rotationValues[i]);
+    if (controller != nullptr) reads += __builtin_popcount(axes & 0xf) + __builtin_popcount(buttons & 0xfff);
+    return reads;
+}
+
+uint32_t SensorHub::getTotalReads() { return totalReads; }
+
+uint32_t SensorHub::getRetries() { return snapshots.getRetries(); }
+} // namespace robot
@@ -0,0 +1,124 @@
+#include <cstring>
+#include "lemlib/logger/logger.hpp"
+#include "robot/freertos.hpp"
+#include "robot/taskMonitor.hpp"
+#include "robot/tasks.hpp"
+#include "robot/trace.hpp"
+
+namespace robot {
+// the idle task runs whenever nothing else is, so it is left out of the max cpu usage
+static constexpr const char* IDLE_TASK_NAME = "IDLE";
+
+void TaskMonitor::setBudget(const char* name, float maxCpu, uint32_t minFreeStack) {
+    mutex.take();
+    Budget* budget = findBudget(name);
+    if (budget == nullptr && budgetCount < MAX_BUDGETS) budget = &budgets[budgetCount++];
+    if (budget != nullptr) *budget = {name, maxCpu, minFreeStack, false};
+    mutex.give();
+}
+
+TaskMonitor::Budget* TaskMonitor::findBudget(const char* name) {
+    for (int i = 0; i < budgetCount; i++) {
+        if (std::strcmp(budgets[i].name, name) == 0) return &budgets[i];
+    }
+    return nullptr;
+}
+
+void TaskMonitor::sample() {
+    TRACE_SCOPE("TaskMonitor::sample");
+    static FreeRTOSTaskStatus statuses[MAX_TASKS];
+    mutex.take();
+    uint32_t total = 0;
+    const int count = uxTaskGetSystemState(statuses, MAX_TASKS, &total);
+    const uint32_t elapsed = total - previousTotal;
+    RunTime current[MAX_TASKS];
+    for (int i = 0; i < count; i++) {
+        const FreeRTOSTaskStatus& status = statuses[i];
+        TaskSample& sample = samples[i];
+        sample.handle = status.handle;
+        std::strncpy(sample.name, status.name != nullptr ? status.name : "", TASK_NAME_MAX_LEN - 1);
+        sample.name[TASK_NAME_MAX_LEN - 1] = '\0';
+        sample.priority = status.currentPriority;
+        sample.freeStack = status.stackHighWaterMark;
+        // cpu usage is the change in the task's run time since the previous sample. New tasks count from 0
+        uint32_t previousCounter = 0;
+        for (int j = 0; j < previousCount; j++) {
+            if (previous[j].handle == status.handle) {
+                previousCounter = previous[j].counter;
+                break;
+            }
+        }
+        current[i] = {status.handle, status.runTimeCounter};
+        sample.cpu = elapsed > 0 ? 100.0f * (status.runTimeCounter - previousCounter) / elapsed : 0;
+        // check the budget
+        sample.overBudget = false;
+        Budget* budget = findBudget(sample.name);
+        if (budget != nullptr) {
+            sample.overBudget = (budget->maxCpu > 0 && sample.cpu > budget->maxCpu) ||
+                                (budget->minFreeStack > 0 && sample.freeStack < budget->minFreeStack);
+            if (sample.overBudget && !budget->warned) {
+                lemlib::infoSink()->warn("task {} over budget: {:.1f}% cpu, {} words of stack free", sample.name,
+                                         sample.cpu, sample.freeStack);
+                budget->warned = true;
+            }
+        }
+    }
+    std::memcpy(previous, current, count * sizeof(RunTime));
+    previousCount = count;
+    previousTotal = total;
+    sampleCount = count;
+    mutex.give();
+}
+
+void TaskMonitor::start(uint32_t period) {
+    if (task != nullptr) return;
+    task = tasks::create("taskMonitor", [this, period]() {
+        while (true) {
+            sample();
+            mutex.take();
+            for (int i = 0; i < sampleCount; i++) {
+                lemlib::telemetrySink()->info("task,{},{:.1f},{}", samples[i].name, samples[i].cpu,
+                                              samples[i].freeStack);
+            }
+            mutex.give();
+            pros::delay(period);
+        }
+    });
+}
+
+int TaskMonitor::getSamples(TaskSample* samples, int maxSamples) {
+    mutex.take();
+    const int count = sampleCount < maxSamples ? sampleCount : maxSamples;
+    std::memcpy(samples, this->samples, count * sizeof(TaskSample));
+    mutex.give();
+    return count;
+}
+
+float TaskMonitor::getMaxCpu() {
+    mutex.take();
+    float maxCpu = 0;
+    for (int i = 0; i < sampleCount; i++) {
+        if (std::strcmp(samples[i].name, IDLE_TASK_NAME) != 0 && samples[i].cpu > maxCpu) maxCpu = samples[i].cpu;
+    }
+    mutex.give();
+    return maxCpu;
+}
+
+uint32_t TaskMonitor::getMinFreeStack() {
+    mutex.take();
+    uint32_t minStack = UINT32_MAX;
+    for (int i = 0; i < sampleCount; i++) {
+        if (samples[i].freeStack < minStack) minStack = samples[i].freeStack;
+    }
+    mutex.give();
+    return sampleCount > 0 ? minStack : 0;
+}
+
+int TaskMonitor::getOverBudgetCount() {
+    mutex.take();
+    int count = 0;
+    for (int i = 0; i < sampleCount; i++) count += samples[i].overBudget;
+    mutex.give();
+    return count;
+}
+} // namespace robot
@@ -0,0 +1,145 @@
+#include <algorithm>
+#include <cstring>
+#include "lemlib/logger/logger.hpp"
+#include "robot/freertos.hpp"
+#include "robot/tasks.hpp"
+
+namespace robot {
+namespace tasks {
+// every task the project runs, highest priority first
+static TaskConfig configs[MAX_TASKS] = {
+    {"sensor hub", PRIORITY_CONTROL, TASK_STACK_DEPTH_DEFAULT, 10},
+    {"lemlib odom", PRIORITY_CONTROL, TASK_STACK_DEPTH_DEFAULT, 10},
+    {"motion", PRIORITY_CONTROL, TASK_STACK_DEPTH_DEFAULT, 10},
+    {"motion progress", PRIORITY_CONTROL, TASK_STACK_DEPTH_DEFAULT, 1},
+    {"recorder", PRIORITY_CONTROL, TASK_STACK_DEPTH_DEFAULT, 10},
+    {"controllers", PRIORITY_CONTROL, TASK_STACK_DEPTH_DEFAULT, 0},
+    {"intake", PRIORITY_CONTROL, TASK_STACK_DEPTH_DEFAULT, 10},
+    {"pose", PRIORITY_COMPETITION, TASK_STACK_DEPTH_DEFAULT, 10},
+    {"vision", PRIORITY_COMPETITION, TASK_STACK_DEPTH_DEFAULT, 20},
+    {"User Autonomous (PROS)", PRIORITY_COMPETITION, TASK_STACK_DEPTH_DEFAULT, 0},
+    {"User Operator Control (PROS)", PRIORITY_COMPETITION, TASK_STACK_DEPTH_DEFAULT, 0},
+    {"sdLogger", PRIORITY_IO, TASK_STACK_DEPTH_DEFAULT, 20},
+    {"imu startup", PRIORITY_IO, TASK_STACK_DEPTH_DEFAULT, 100},
+    {"config", PRIORITY_IO, TASK_STACK_DEPTH_DEFAULT, 100},
+    {"lemlib stdout", PRIORITY_IO, TASK_STACK_DEPTH_DEFAULT, 50},
+    {"screen", PRIORITY_UI, TASK_STACK_DEPTH_DEFAULT, 50},
+    {"taskMonitor", PRIORITY_DIAGNOSTIC, TASK_STACK_DEPTH_DEFAULT, 1000},
+};
+static int configCount = 17;
+// the most recent task created or adopted under each name
+static pros::task_t handles[MAX_TASKS] = {};
+static pros::Mutex mutex;
+
+/**
+ * @brief Find a task in the registry
+ *
+ * @return int - index of the task, or -1 if it is not registered. Must be called with the mutex taken
+ */
+static int indexOf(const char* name) {
+    for (int i = 0; i < configCount; i++) {
+        if (std::strcmp(configs[i].name, name) == 0) return i;
+    }
+    return -1;
+}
+
+bool registerTask(const TaskConfig& config) {
+    mutex.take();
+    int index = indexOf(config.name);
+    if (index < 0 && configCount < MAX_TASKS) index = configCount++;
+    if (index >= 0) configs[index] = config;
+    mutex.give();
+    return index >= 0;
+}
+
+const TaskConfig* find(const char* name) {
+    mutex.take();
+    const int index = indexOf(name);
+    mutex.give();
+    return index >= 0 ? &configs[index] : nullptr;
+}
+
+uint32_t getPeriod(const char* name) {
+    const TaskConfig* config = find(name);
+    return config != nullptr ? config->period : 0;
+}
+
+pros::Task* create(const char* name, std::function<void()> function) {
+    const TaskConfig* config = find(name);
+    if (config == nullptr) lemlib::infoSink()->warn("task {} is not registered", name);
+    pros::Task* task = new pros::Task(std::move(function),
+                                      config != nullptr ? config->priority : TASK_PRIORITY_DEFAULT,
+                                      config != nullptr ? config->stackDepth : TASK_STACK_DEPTH_DEFAULT, name);
+    mutex.take();
+    const int index = indexOf(name);
+    if (index >= 0) handles[index] = static_cast<pros::task_t>(*task);
+    mutex.give();
+    return task;
+}
+
+int adopt(const char* name, const std::function<void()>& function) {
+    static FreeRTOSTaskStatus statuses[MAX_TASKS * 2];
+    // task numbers only ever go up, so anything numbered above the highest one now was created by the function
+    uint32_t count = uxTaskGetSystemState(statuses, MAX_TASKS * 2, nullptr);
+    uint32_t highest = 0;
+    for (uint32_t i = 0; i < count; i++) highest = std::max(highest, statuses[i].number);
+    function();
+    const TaskConfig* config = find(name);
+    if (config == nullptr) {
+        lemlib::infoSink()->warn("task {} is not registered", name);
+        return 0;
+    }
+    // FreeRTOS lists nothing when there are more tasks than statuses, and then the new tasks can't be told apart
+    if (count > 0) count = uxTaskGetSystemState(statuses, MAX_TASKS * 2, nullptr);
+    if (count == 0) {
+        lemlib::infoSink()->warn("task {} not adopted, more than {} tasks are running", name, MAX_TASKS * 2);
+        return 0;
+    }
+    int adopted = 0;
+    for (uint32_t i = 0; i < count; i++) {
+        if (statuses[i].number <= highest) continue;
+        pros::c::task_set_priority(statuses[i].handle, config->priority);
+        mutex.take();
+        handles[indexOf(name)] = statuses[i].handle;
+        mutex.give();
+        adopted++;
+    }
+    return adopted;
+}
+
+void report() {
+    static FreeRTOSTaskStatus statuses[MAX_TASKS * 2];
+    const uint32_t count = uxTaskGetSystemState(statuses, MAX_TASKS * 2, nullptr);
+    bool listed[MAX_TASKS * 2] = {};
+    lemlib::infoSink()->debug("{:<28} {:>8} {:>8} {:>6} {:>10} {:>6}", "task", "priority", "current", "stack",
+                             "free stack", "period");
+    mutex.take();
+    for (int i = 0; i < configCount; i++) {
+        const TaskConfig& config = configs[i];
+        // match on the handle for tasks created or adopted here, on the name for tasks PROS created
+        int status = -1;
+        for (uint32_t j = 0; j < count && status < 0; j++) {
+            if (handles[i] != nullptr ? statuses[j].handle == handles[i]
+                                      : std::strcmp(statuses[j].name, config.name) == 0) {
+                status = j;
+            }
+        }
+        if (status >= 0) {
+            listed[status] = true;
+            lemlib::infoSink()->debug("{:<28} {:>8} {:>8} {:>6} {:>10} {:>6}", config.name, config.priority,
+                                     statuses[status].currentPriority, config.stackDepth,
+                                     statuses[status].stackHighWaterMark, config.period);
+        } else {
+            lemlib::infoSink()->debug("{:<28} {:>8} {:>8} {:>6} {:>10} {:>6}", config.name, config.priority, "-",
+                                     config.stackDepth, "-", config.period);
+        }
+    }
+    mutex.give();
+    for (uint32_t i = 0; i < count; i++) {
+        if (listed[i]) continue;
+        lemlib::infoSink()->debug("{:<28} {:>8} {:>8} {:>6} {:>10} {:>6}", statuses[i].name, "-",
+                                 statuses[i].currentPriority, "-", statuses[i].stackHighWaterMark, "-");
+    }
+}
+} // namespace tasks
+} // namespace robot
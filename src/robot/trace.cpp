@@ -0,0 +1,223 @@
+#include "robot/trace.hpp"
+
+#ifdef ROBOT_TRACE
+#include <atomic>
+#include <cstring>
+#include "pros/rtos.hpp"
+#include "robot/freertos.hpp"
+
+namespace robot {
+namespace trace {
+// longest task name kept for a ring, including the terminator
+static constexpr int NAME_SIZE = 32;
+// most tasks looked at when looking for rings whose owner was deleted
+static constexpr int MAX_TASKS = 32;
+
+/**
+ * @brief Single producer single consumer ring of events
+ *
+ * The owning task is the only producer. dumpToFile and dumpToSerial are the only consumers. Once the owner is deleted
+ * and its events are dumped, the ring is released for another task.
+ */
+struct Ring {
+        std::atomic<pros::task_t> owner {nullptr};
+        // name of the owner when it claimed the ring, so the ring can still be named once the owner is deleted
+        char name[NAME_SIZE];
+        std::atomic<uint32_t> head {0};
+        std::atomic<uint32_t> tail {0};
+        Event events[RING_SIZE];
+};
+
+static_assert((RING_SIZE & (RING_SIZE - 1)) == 0, "RING_SIZE must be a power of 2");
+static_assert(sizeof(Event) == 12, "trace events are written to dumps as is");
+
+static Ring rings[MAX_RINGS];
+static const char* names[MAX_NAMES];
+static uint16_t nameCount = 0;
+static pros::Mutex nameMutex;
+static pros::Mutex dumpMutex;
+static pros::Mutex releaseMutex;
+static std::atomic<uint32_t> dropped {0};
+
+#ifdef ROBOT_TRACE_CYCLES
+/**
+ * @brief Enable the Cortex-A9 cycle counter
+ *
+ */
+static bool enableCycleCounter() {
+    // PMCR: enable counters and reset the cycle counter
+    asm volatile("mcr p15, 0, %0, c9, c12, 0" ::"r"(0x5));
+    // PMCNTENSET: enable the cycle counter
+    asm volatile("mcr p15, 0, %0, c9, c12, 1" ::"r"(0x80000000));
+    return true;
+}
+
+static const bool cycleCounterEnabled = enableCycleCounter();
+#endif
+
+static inline uint32_t now() {
+#ifdef ROBOT_TRACE_CYCLES
+    uint32_t cycles;
+    asm volatile("mrc p15, 0, %0, c9, c13, 0" : "=r"(cycles));
+    return cycles;
+#else
+    return pros::micros();
+#endif
+}
+
+uint16_t intern(const char* name) {
+    nameMutex.take();
+    uint16_t id = 0;
+    while (id < nameCount && std::strcmp(names[id], name) != 0) id++;
+    if (id == nameCount && nameCount < MAX_NAMES) names[nameCount++] = name;
+    // names past the limit all share the last id
+    if (id >= MAX_NAMES) id = MAX_NAMES - 1;
+    nameMutex.give();
+    return id;
+}
+
+/**
+ * @brief Release the rings of deleted tasks that have no events left to dump
+ *
+ * Only looks at the handles of tasks that are still alive, since the handle of a deleted task points at freed memory.
+ * FreeRTOS lists no tasks at all when there are more than MAX_TASKS, and then nothing is released, since any owner might
+ * still be alive
+ *
+ * @param timeout how long to wait for another task that is releasing rings, in milliseconds
+ * @return int - the number of rings released
+ */
+static int releaseDeadRings(uint32_t timeout) {
+    static FreeRTOSTaskStatus statuses[MAX_TASKS];
+    if (!releaseMutex.take(timeout)) return 0;
+    const uint32_t count = uxTaskGetSystemState(statuses, MAX_TASKS, nullptr);
+    if (count == 0) {
+        releaseMutex.give();
+        return 0;
+    }
+    int released = 0;
+    for (Ring& ring : rings) {
+        pros::task_t owner = ring.owner.load(std::memory_order_relaxed);
+        if (owner == nullptr) continue;
+        bool alive = false;
+        for (uint32_t i = 0; i < count && !alive; i++) {
+            alive = statuses[i].handle == owner && statuses[i].state != pros::E_TASK_STATE_DELETED;
+        }
+        // events left in the ring are kept until a dump, so they are named after the task that recorded them
+        if (alive || ring.head.load(std::memory_order_acquire) != ring.tail.load(std::memory_order_relaxed)) continue;
+        if (ring.owner.compare_exchange_strong(owner, nullptr)) released++;
+    }
+    releaseMutex.give();
+    return released;
+}
+
+/**
+ * @brief Find the ring of the current task, claiming a free one if it doesn't have one yet
+ *
+ * @return int - index of the ring, or -1 if all rings are taken
+ */
+static int findRing() {
+    pros::task_t current = pros::c::task_get_current();
+    // every ring is taken at most once, when it might be held by a deleted task
+    for (bool retried = false;; retried = true) {
+        for (int i = 0; i < MAX_RINGS; i++) {
+            pros::task_t owner = rings[i].owner.load(std::memory_order_relaxed);
+            if (owner == current) return i;
+            if (owner == nullptr) {
+                // another task may claim this ring at the same time, in which case keep looking
+                if (rings[i].owner.compare_exchange_strong(owner, current)) {
+                    const char* name = pros::c::task_get_name(current);
+                    std::strncpy(rings[i].name, name != nullptr ? name : "", NAME_SIZE - 1);
+                    rings[i].name[NAME_SIZE - 1] = '\0';
+                    return i;
+                }
+                if (owner == current) return i;
+            }
+        }
+        // never wait, so recording doesn't block
+        if (retried || releaseDeadRings(0) == 0) return -1;
+    }
+}
+
+void record(EventType type, uint16_t name, int32_t value) {
+    const uint32_t time = now();
+    const int index = findRing();
+    if (index < 0) {
+        dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    Ring& ring = rings[index];
+    const uint32_t head = ring.head.load(std::memory_order_relaxed);
+    if (head - ring.tail.load(std::memory_order_acquire) >= RING_SIZE) {
+        dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    ring.events[head & (RING_SIZE - 1)] = {time, name, static_cast<uint8_t>(type), static_cast<uint8_t>(index), value};
+    ring.head.store(head + 1, std::memory_order_release);
+}
+
+static const char* taskName(int ring) {
+    return rings[ring].owner.load(std::memory_order_relaxed) != nullptr ? rings[ring].name : "";
+}
+
+/**
+ * @brief Consume all events in a ring
+ *
+ */
+template <typename F> static void drain(Ring& ring, F&& callback) {
+    const uint32_t head = ring.head.load(std::memory_order_acquire);
+    uint32_t tail = ring.tail.load(std::memory_order_relaxed);
+    for (; tail != head; tail++) callback(ring.events[tail & (RING_SIZE - 1)]);
+    ring.tail.store(tail, std::memory_order_release);
+}
+
+bool dumpToFile(const char* path) {
+    FILE* file = fopen(path, "wb");
+    if (file == nullptr) return false;
+    dumpMutex.take();
+    // header: magic, version, clock (0 for microseconds, 1 for cycles), ring count, name count
+    const uint8_t header[8] = {'R', 'T', 'R', 'C', 1,
+#ifdef ROBOT_TRACE_CYCLES
+                               1,
+#else
+                               0,
+#endif
+                               MAX_RINGS, 0};
+    fwrite(header, 1, sizeof(header), file);
+    nameMutex.take();
+    const uint16_t count = nameCount;
+    nameMutex.give();
+    fwrite(&count, sizeof(count), 1, file);
+    // null terminated strings: the event names, then the task name of each ring
+    for (int i = 0; i < count; i++) fwrite(names[i], 1, std::strlen(names[i]) + 1, file);
+    for (int i = 0; i < MAX_RINGS; i++) {
+        const char* name = taskName(i);
+        fwrite(name, 1, std::strlen(name) + 1, file);
+    }
+    // the rest of the file is events
+    for (int i = 0; i < MAX_RINGS; i++) {
+        drain(rings[i], [file](const Event& event) { fwrite(&event, sizeof(Event), 1, file); });
+    }
+    releaseDeadRings(TIMEOUT_MAX);
+    dumpMutex.give();
+    fclose(file);
+    return true;
+}
+
+void dumpToSerial() {
+    static const char* TYPES[] = {"B", "E", "C"};
+    dumpMutex.take();
+    for (int i = 0; i < MAX_RINGS; i++) {
+        const char* task = taskName(i);
+        drain(rings[i], [task](const Event& event) {
+            printf("trace,%s,%s,%s,%lu,%ld\n", task, TYPES[event.type], names[event.name],
+                   static_cast<unsigned long>(event.time), static_cast<long>(event.value));
+        });
+    }
+    releaseDeadRings(TIMEOUT_MAX);
+    dumpMutex.give();
+}
+
+uint32_t getDropped() { return dropped.load(std::memory_order_relaxed); }
+} // namespace trace
+} // namespace robot
+#endif
@@ -0,0 +1,228 @@
+#include <algorithm>
+#include <cmath>
+#include "pros/error.h"
+#include "robot/fastMath.hpp"
+#include "robot/tasks.hpp"
+#include "robot/trace.hpp"
+#include "robot/triballTracker.hpp"
+
+namespace {
+// spread of the triball's acceleration, in inches squared per second cubed. Triballs only move when pushed
+constexpr float ACCELERATION_NOISE = 50;
+// spread of a projected position, in inches squared
+constexpr float MEASUREMENT_NOISE = 4;
+// spread of a new track's velocity, in inches squared per second squared
+constexpr float INITIAL_VELOCITY_NOISE = 100;
+// triballs are about 7 inches across. The bottom edge of the box is the near side, the center is this much further
+constexpr float TRIBALL_RADIUS = 3.5;
+constexpr float DEG_TO_RAD = 0.0174532925f;
+} // namespace
+
+namespace robot {
+const Triball* TriballSet::nearest(float x, float y) const {
+    const Triball* best = nullptr;
+    float bestDistance = INFINITY;
+    for (int i = 0; i < count; i++) {
+        const float distance = std::hypot(triballs[i].x - x, triballs[i].y - y);
+        if (distance < bestDistance) best = &triballs[i], bestDistance = distance;
+    }
+    return best;
+}
+
+void TriballTracker::Axis::predict(float dt) {
+    p += v * dt;
+    // P = F P F^T + Q, with F = [[1, dt], [0, 1]] and Q from white noise acceleration
+    const float dt2 = dt * dt;
+    pp += dt * (2 * pv + dt * vv) + ACCELERATION_NOISE * dt2 * dt / 3;
+    pv += dt * vv + ACCELERATION_NOISE * dt2 / 2;
+    vv += ACCELERATION_NOISE * dt;
+}
+
+void TriballTracker::Axis::correct(float z) {
+    const float s = pp + MEASUREMENT_NOISE;
+    const float kp = pp / s;
+    const float kv = pv / s;
+    const float residual = z - p;
+    p += kp * residual;
+    v += kv * residual;
+    vv -= kv * pv;
+    pv -= kp * pv;
+    pp -= kp * pp;
+}
+
+TriballTracker::TriballTracker(pros::Vision* sensor, uint32_t signature, PoseSource& poses, const CameraMount& mount,
+                               Clock& clock)
+    : sensor(sensor),
+      signature(signature),
+      poses(poses),
+      mount(mount),
+      clock(clock) {}
+
+void TriballTracker::start() {
+    if (task != nullptr) return;
+    task = tasks::create("vision", [this]() {
+        uint32_t now = pros::millis();
+        while (true) {
+            update();
+            pros::c::task_delay_until(&now, tasks::getPeriod("vision"));
+        }
+    });
+}
+
+void TriballTracker::update() {
+    TRACE_SCOPE("TriballTracker::update");
+    recordPose(poses.get());
+    process(read());
+}
+
+VisionFrame TriballTracker::read() {
+    VisionFrame frame;
+    frame.micros = clock.micros();
+    frame.count = 0;
+    if (sensor == nullptr) return frame;
+    const int32_t count = sensor->read_by_sig(0, signature, VisionFrame::MAX_OBJECTS, frame.objects);
+    // PROS_ERR when nothing matches, as well as when the read fails
+    if (count != PROS_ERR) frame.count = std::clamp<int32_t>(count, 0, VisionFrame::MAX_OBJECTS);
+    return frame;
+}
+
+void TriballTracker::recordPose(const PoseSample& pose) {
+    history[poseNext] = pose;
+    poseNext = (poseNext + 1) % POSE_HISTORY;
+    poseCount = std::min(poseCount + 1, POSE_HISTORY);
+}
+
+bool TriballTracker::poseAt(uint64_t micros, PoseSample& pose) {
+    if (poseCount == 0) return false;
+    const int oldest = poseCount < POSE_HISTORY ? 0 : poseNext;
+    const PoseSample* before = &history[oldest];
+    if (micros <= before->micros) {
+        pose = *before;
+        return true;
+    }
+    for (int i = 1; i < poseCount; i++) {
+        const PoseSample& after = history[(oldest + i) % POSE_HISTORY];
+        if (micros <= after.micros) {
+            const float t = static_cast<float>(micros - before->micros) / (after.micros - before->micros);
+            pose = after;
+            pose.micros = micros;
+            pose.x = before->x + (after.x - before->x) * t;
+            pose.y = before->y + (after.y - before->y) * t;
+            pose.theta = before->theta + (after.theta - before->theta) * t;
+            return true;
+        }
+        before = &after;
+    }
+    // newer than every pose, so use the newest rather than guessing ahead
+    pose = *before;
+    return true;
+}
+
+bool TriballTracker::project(const pros::vision_object_s_t& object, const PoseSample& pose, float& x, float& y) {
+    // ray through the middle of the bottom edge, in the sensor's frame: forward 1, right u, down v
+    const float u = (object.left_coord + object.width * 0.5f - VISION_FOV_WIDTH / 2) / mount.focalLength;
+    const float v = (object.top_coord + object.height - VISION_FOV_HEIGHT / 2) / mount.focalLength;
+    float pitchSin, pitchCos;
+    fastmath::sinCos(mount.pitch * DEG_TO_RAD, pitchSin, pitchCos);
+    // tilt the ray down by the pitch, and scale it until it drops the height of the lens
+    const float down = pitchSin + v * pitchCos;
+    if (down <= 0) return false;
+    const float scale = mount.height / down;
+    float ahead = scale * (pitchCos - v * pitchSin);
+    float across = scale * u;
+    const float range = std::hypot(ahead, across);
+    if (range > mount.maxRange) return false;
+    // from the near side of the triball to its center
+    ahead += ahead / range * TRIBALL_RADIUS;
+    across += across / range * TRIBALL_RADIUS;
+    ahead += mount.forward;
+    across += mount.right;
+    // heading 0 is along +y and clockwise is positive, so forward is (sin, cos) and right is (cos, -sin)
+    float headingSin, headingCos;
+    fastmath::sinCos(pose.theta * DEG_TO_RAD, headingSin, headingCos);
+    x = pose.x + ahead * headingSin + across * headingCos;
+    y = pose.y + ahead * headingCos - across * headingSin;
+    return true;
+}
+
+void TriballTracker::process(const VisionFrame& frame) {
+    TRACE_SCOPE("TriballTracker::process");
+    const float dt = lastFrame != 0 && frame.micros > lastFrame ? (frame.micros - lastFrame) * 1e-6f : 0;
+    lastFrame = frame.micros;
+    for (int i = 0; i < trackCount; i++) {
+        tracks[i].x.predict(dt);
+        tracks[i].y.predict(dt);
+    }
+
+    // project every object onto the field, with the pose from when the frame was taken
+    float xs[VisionFrame::MAX_OBJECTS];
+    float ys[VisionFrame::MAX_OBJECTS];
+    int count = 0;
+    PoseSample pose;
+    if (poseAt(frame.micros - std::min<uint64_t>(frame.micros, mount.latency), pose)) {
+        for (int i = 0; i < frame.count && i < VisionFrame::MAX_OBJECTS; i++) {
+            if (frame.objects[i].signature != signature) continue;
+            if (project(frame.objects[i], pose, xs[count], ys[count])) count++;
+        }
+    }
+
+    // match the closest track and triball until no pair is within the gate
+    bool trackMatched[TriballSet::MAX_TRIBALLS] = {};
+    bool objectMatched[VisionFrame::MAX_OBJECTS] = {};
+    while (true) {
+        int bestTrack = -1;
+        int bestObject = -1;
+        float bestDistance = GATE;
+        for (int t = 0; t < trackCount; t++) {
+            if (trackMatched[t]) continue;
+            for (int o = 0; o < count; o++) {
+                if (objectMatched[o]) continue;
+                const float distance = std::hypot(xs[o] - tracks[t].x.p, ys[o] - tracks[t].y.p);
+                if (distance < bestDistance) bestTrack = t, bestObject = o, bestDistance = distance;
+            }
+        }
+        if (bestTrack < 0) break;
+        Track& track = tracks[bestTrack];
+        track.x.correct(xs[bestObject]);
+        track.y.correct(ys[bestObject]);
+        track.hits++;
+        track.lastSeen = frame.micros;
+        trackMatched[bestTrack] = true;
+        objectMatched[bestObject] = true;
+    }
+
+    // drop tracks that haven't been seen for a while, then start tracks for the triballs that matched nothing
+    int kept = 0;
+    for (int t = 0; t < trackCount; t++) {
+        if (frame.micros - tracks[t].lastSeen <= TRACK_TIMEOUT) tracks[kept++] = tracks[t];
+    }
+    trackCount = kept;
+    for (int o = 0; o < count && trackCount < TriballSet::MAX_TRIBALLS; o++) {
+        if (objectMatched[o]) continue;
+        Track& track = tracks[trackCount++];
+        track.id = nextId++;
+        track.x = {xs[o], 0, MEASUREMENT_NOISE, 0, INITIAL_VELOCITY_NOISE};
+        track.y = {ys[o], 0, MEASUREMENT_NOISE, 0, INITIAL_VELOCITY_NOISE};
+        track.hits = 1;
+        track.lastSeen = frame.micros;
+    }
+    publish(frame.micros);
+}
+
+void TriballTracker::publish(uint64_t micros) {
+    uint32_t sequence;
+    TriballSet& set = sets.beginWrite(sequence);
+    set.sequence = sequence;
+    set.micros = micros;
+    set.count = 0;
+    for (int t = 0; t < trackCount; t++) {
+        const Track& track = tracks[t];
+        if (track.hits < CONFIRM_HITS) continue;
+        set.triballs[set.count++] = {track.id, track.x.p, track.y.p, track.x.v, track.y.v, track.hits, track.lastSeen};
+    }
+    // publish the set only once it is complete
+    sets.publish();
+}
+
+TriballSet TriballTracker::get() { return sets.get(); }
+} // namespace robot
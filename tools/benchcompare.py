@@ -0,0 +1,65 @@
+#!/usr/bin/env python3
+"""Compare two runs of the on-brain benchmarks.
+
+Each input is either the JSON printed by robot::bench::runAll or a saved terminal log containing it, e.g. from
+`pros terminal > bench.log`. Use --extract to save just the JSON from a log, so results can be kept per commit.
+
+Usage:
+    benchcompare.py --extract bench.log > bench-$(git rev-parse --short HEAD).json
+    benchcompare.py old.json new.json
+    benchcompare.py --threshold 10 old.json new.json   # exit 1 if anything got more than 10% slower
+"""
+
+import argparse
+import json
+import sys
+
+
+def load(path):
+    with open(path, errors="replace") as f:
+        text = f.read()
+    # the results are a single line, possibly surrounded by other terminal output
+    for line in reversed(text.splitlines()):
+        start = line.find('{"context"')
+        if start >= 0:
+            return json.loads(line[start:])
+    return json.loads(text)
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("files", nargs="+")
+    parser.add_argument("--extract", action="store_true", help="print the results of a single log as JSON")
+    parser.add_argument("--threshold", type=float, default=5.0, help="percent slowdown counted as a regression")
+    args = parser.parse_args()
+
+    if args.extract:
+        json.dump(load(args.files[0]), sys.stdout, indent=2)
+        print()
+        return 0
+    if len(args.files) != 2:
+        parser.error("expected two files to compare")
+
+    old = {b["name"]: b["real_time"] for b in load(args.files[0])["benchmarks"]}
+    new = {b["name"]: b["real_time"] for b in load(args.files[1])["benchmarks"]}
+    width = max(len(name) for name in list(old) + list(new) + ["benchmark"])
+    regressions = 0
+    print("{:<{w}} {:>12} {:>12} {:>8}".format("benchmark", "old (ns)", "new (ns)", "change", w=width))
+    for name in new:
+        if name not in old:
+            print("{:<{w}} {:>12} {:>12.1f} {:>8}".format(name, "-", new[name], "new", w=width))
+            continue
+        change = (new[name] - old[name]) / old[name] * 100 if old[name] > 0 else 0.0
+        flag = ""
+        if change > args.threshold:
+            flag = "  <-- regression"
+            regressions += 1
+        print("{:<{w}} {:>12.1f} {:>12.1f} {:>+7.1f}%{}".format(name, old[name], new[name], change, flag, w=width))
+    for name in old:
+        if name not in new:
+            print("{:<{w}} {:>12.1f} {:>12} {:>8}".format(name, old[name], "-", "removed", w=width))
+    return 1 if regressions > 0 else 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
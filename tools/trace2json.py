@@ -0,0 +1,99 @@
+#!/usr/bin/env python3
+"""Convert a robot trace dump to Chrome trace JSON.
+
+The output can be opened in chrome://tracing or https://ui.perfetto.dev.
+
+Usage:
+    trace2json.py trace.bin > trace.json            # binary dump from robot::trace::dumpToFile
+    trace2json.py terminal.log > trace.json         # text dump from robot::trace::dumpToSerial
+    trace2json.py --mhz 666 trace.bin > trace.json  # dump recorded with ROBOT_TRACE_CYCLES
+"""
+
+import argparse
+import json
+import struct
+import sys
+
+EVENT = struct.Struct("<IHBBi")
+PHASES = {0: "B", 1: "E", 2: "C", "B": "B", "E": "E", "C": "C"}
+
+
+def read_string(data, offset):
+    end = data.index(b"\0", offset)
+    return data[offset:end].decode(errors="replace"), end + 1
+
+
+def parse_binary(data):
+    if data[:4] != b"RTRC" or data[4] != 1:
+        raise ValueError("not a version 1 trace dump")
+    cycles = data[5] == 1
+    ring_count = data[6]
+    (name_count,) = struct.unpack_from("<H", data, 8)
+    offset = 10
+    names = []
+    for _ in range(name_count):
+        name, offset = read_string(data, offset)
+        names.append(name)
+    tasks = []
+    for _ in range(ring_count):
+        task, offset = read_string(data, offset)
+        tasks.append(task)
+    # ignore a partial event at the end, in case the dump was cut short
+    end = offset + (len(data) - offset) // EVENT.size * EVENT.size
+    events = []
+    for time, name, kind, ring, value in EVENT.iter_unpack(data[offset:end]):
+        events.append((tasks[ring] or "ring {}".format(ring), PHASES[kind], names[name], time, value))
+    return events, cycles
+
+
+def parse_text(data):
+    events = []
+    for line in data.decode(errors="replace").splitlines():
+        parts = line.strip().split(",")
+        if len(parts) != 6 or parts[0] != "trace":
+            continue
+        events.append((parts[1], PHASES[parts[2]], parts[3], int(parts[4]), int(parts[5])))
+    return events
+
+
+def to_chrome(events, ticks_per_us):
+    tids = {}
+    out = []
+    # timestamps wrap every 2^32 ticks, so unwrap them per task
+    last = {}
+    offset = {}
+    for task, phase, name, time, value in events:
+        tid = tids.setdefault(task, len(tids) + 1)
+        if task in last and time < last[task]:
+            offset[task] = offset.get(task, 0) + (1 << 32)
+        last[task] = time
+        ts = (time + offset.get(task, 0)) / ticks_per_us
+        event = {"name": name, "ph": phase, "ts": ts, "pid": 1, "tid": tid}
+        if phase == "C":
+            event["args"] = {name: value}
+        out.append(event)
+    for task, tid in tids.items():
+        out.append({"name": "thread_name", "ph": "M", "pid": 1, "tid": tid, "args": {"name": task}})
+    out.sort(key=lambda e: e.get("ts", 0))
+    return {"traceEvents": out, "displayTimeUnit": "ms"}
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("dump")
+    parser.add_argument("--mhz", type=float, default=666.0, help="cpu clock for dumps recorded in cycles")
+    args = parser.parse_args()
+    with open(args.dump, "rb") as f:
+        data = f.read()
+    ticks_per_us = 1.0
+    if data[:4] == b"RTRC":
+        events, cycles = parse_binary(data)
+        if cycles:
+            ticks_per_us = args.mhz
+    else:
+        events = parse_text(data)
+    json.dump(to_chrome(events, ticks_per_us), sys.stdout)
+
+
+if __name__ == "__main__":
+    main()